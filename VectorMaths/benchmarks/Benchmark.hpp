@@ -0,0 +1,32 @@
+/**
+ * @file Benchmark.hpp
+ * @brief Minimal timing helpers shared by the benchmark executables
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+/// Sink that stops the compiler from discarding benchmarked work
+inline volatile float benchmarkSink = 0.0f;
+
+/**
+ * @brief Runs a function repeatedly and prints the average time per call
+ * @param name Label printed alongside the result
+ * @param iterations Number of timed calls
+ * @param fn Function to time
+ */
+template<typename Fn>
+void RunBenchmark(const char* name, int iterations, Fn&& fn) {
+	fn();  // Warm-up
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		fn();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double totalNs = std::chrono::duration<double, std::nano>(end - start).count();
+	std::printf("%-48s %14.1f ns/iter  (%d iters)\n", name, totalNs / iterations, iterations);
+}
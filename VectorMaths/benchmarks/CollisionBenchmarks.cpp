@@ -0,0 +1,507 @@
+/**
+ * @file CollisionBenchmarks.cpp
+ * @brief Benchmarks for scene queries: brute-force loops against acceleration structures
+ */
+
+#include "Benchmark.hpp"
+#include "Collision.hpp"
+#include "BVH.hpp"
+#include "RayPacket.hpp"
+#include "DynamicAABBTree.hpp"
+#include "SweepAndPrune.hpp"
+#include "SpatialHashGrid.hpp"
+#include "LooseOctree.hpp"
+#include "PrimitiveArrays.hpp"
+#include "Frustum.hpp"
+#include "TriangleMesh.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Random boxes scattered through a cube of the given half-size
+std::vector<AABB> RandomBoxes(size_t count, float halfSize, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> position(-halfSize, halfSize);
+	std::uniform_real_distribution<float> size(0.1f, 1.0f);
+
+	std::vector<AABB> boxes;
+	boxes.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		Vec3 center(position(rng), position(rng), position(rng));
+		boxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng))));
+	}
+	return boxes;
+}
+
+/// Random rays starting inside the same cube
+std::vector<Ray> RandomRays(size_t count, float halfSize, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> position(-halfSize, halfSize);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+	std::vector<Ray> rays;
+	rays.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		rays.emplace_back(Vec3(position(rng), position(rng), position(rng)),
+			Vec3(direction(rng), direction(rng), direction(rng)));
+	}
+	return rays;
+}
+
+} // namespace
+
+int main() {
+	const size_t sceneSize = 100000;
+	const float halfSize = 200.0f;
+
+	std::vector<AABB> boxes = RandomBoxes(sceneSize, halfSize, 1);
+	std::vector<Ray> rays = RandomRays(1000, halfSize, 2);
+	std::vector<uint32_t> results;
+
+	// Scene queries
+	BVH bvh;
+	RunBenchmark("100k boxes: BVH build", 5, [&]() {
+		bvh.build(boxes.data(), boxes.size());
+	});
+
+	RunBenchmark("100k boxes: brute-force closest hit x1000 rays", 2, [&]() {
+		float total = 0.0f;
+		for (const Ray& ray : rays) {
+			float closest = 1e30f;
+			for (const AABB& box : boxes) {
+				float distance;
+				if (rayIntersectsAABB(ray, box, distance) && distance < closest) {
+					closest = distance;
+				}
+			}
+			total += closest;
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("100k boxes: BVH closest hit x1000 rays", 20, [&]() {
+		float total = 0.0f;
+		RayHit hit;
+		for (const Ray& ray : rays) {
+			if (bvh.raycast(ray, hit)) {
+				total += hit.distance;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("100k boxes: BVH any hit x1000 rays", 20, [&]() {
+		int hits = 0;
+		for (const Ray& ray : rays) {
+			hits += bvh.raycastAny(ray) ? 1 : 0;
+		}
+		benchmarkSink = static_cast<float>(hits);
+	});
+
+	// Coherent rays: a 64x64 grid of camera rays over a narrow cone, traced as 2x2 packets
+	std::vector<Ray> cameraRays;
+	for (int y = 0; y < 64; y += 2) {
+		for (int x = 0; x < 64; x += 2) {
+			for (int i = 0; i < 4; i++) {
+				float u = static_cast<float>(x + (i & 1)) / 64.0f - 0.5f;
+				float v = static_cast<float>(y + (i >> 1)) / 64.0f - 0.5f;
+				cameraRays.emplace_back(Vec3(0, 0, -halfSize), Vec3(u * 0.5f, v * 0.5f, 1.0f));
+			}
+		}
+	}
+
+	RunBenchmark("100k boxes: BVH closest hit x4096 coherent rays", 5, [&]() {
+		float total = 0.0f;
+		RayHit hit;
+		for (const Ray& ray : cameraRays) {
+			if (bvh.raycast(ray, hit)) {
+				total += hit.distance;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("100k boxes: BVH closest hit x1024 coherent packets", 5, [&]() {
+		float total = 0.0f;
+		RayHit hits[RayPacket::Width];
+		for (size_t i = 0; i < cameraRays.size(); i += RayPacket::Width) {
+			uint32_t mask = bvh.raycast(RayPacket(&cameraRays[i], RayPacket::Width), hits);
+			for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+				total += ((mask >> lane) & 1u) ? hits[lane].distance : 0.0f;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	AABB region = AABB::fromCenterAndExtents(Vec3(10, -20, 5), Vec3(15, 15, 15));
+	RunBenchmark("100k boxes: brute-force AABB overlap", 20, [&]() {
+		results.clear();
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			if (aabbIntersectsAABB(boxes[i], region)) {
+				results.push_back(i);
+			}
+		}
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	AABBArray sceneArray(boxes.data(), boxes.size());
+	std::vector<uint32_t> overlapMask;
+	RunBenchmark("100k boxes: SoA AABB overlap indices", 100, [&]() {
+		sceneArray.queryOverlaps(region, results);
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	RunBenchmark("100k boxes: SoA AABB overlap mask", 100, [&]() {
+		benchmarkSink = static_cast<float>(sceneArray.overlapMask(region, overlapMask));
+	});
+
+	Sphere blast(Vec3(-30, 40, 0), 12.0f);
+	RunBenchmark("100k boxes: brute-force sphere overlap", 20, [&]() {
+		results.clear();
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			if (sphereIntersectsAABB(blast, boxes[i])) {
+				results.push_back(i);
+			}
+		}
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	RunBenchmark("100k boxes: SoA sphere overlap mask", 100, [&]() {
+		benchmarkSink = static_cast<float>(sceneArray.overlapMask(blast, overlapMask));
+	});
+
+	Vec3 probe(1.5f, -2.0f, 3.0f);
+	RunBenchmark("100k boxes: brute-force point containment", 20, [&]() {
+		results.clear();
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			if (pointInAABB(probe, boxes[i])) {
+				results.push_back(i);
+			}
+		}
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	RunBenchmark("100k boxes: SoA point containment mask", 100, [&]() {
+		benchmarkSink = static_cast<float>(sceneArray.containingMask(probe, overlapMask));
+	});
+
+	RunBenchmark("100k boxes: BVH AABB overlap", 1000, [&]() {
+		bvh.queryOverlaps(region, results);
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	// Moving objects: small per-frame motion mostly stays inside the fat boxes
+	DynamicAABBTree tree;
+	std::vector<uint32_t> proxies;
+	proxies.reserve(boxes.size());
+	for (const AABB& box : boxes) {
+		proxies.push_back(tree.createProxy(box));
+	}
+
+	std::vector<AABB> moving = boxes;
+	std::vector<Vec3> velocities;
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> velocity(-0.02f, 0.02f);
+	for (size_t i = 0; i < moving.size(); i++) {
+		velocities.emplace_back(velocity(rng), velocity(rng), velocity(rng));
+	}
+
+	RunBenchmark("100k boxes: dynamic tree move all", 20, [&]() {
+		int reinserted = 0;
+		for (size_t i = 0; i < moving.size(); i++) {
+			moving[i].min = moving[i].min + velocities[i];
+			moving[i].max = moving[i].max + velocities[i];
+			reinserted += tree.moveProxy(proxies[i], moving[i], velocities[i]) ? 1 : 0;
+		}
+		benchmarkSink = static_cast<float>(reinserted);
+	});
+
+	RunBenchmark("100k boxes: BVH rebuild after move", 5, [&]() {
+		bvh.build(moving.data(), moving.size());
+	});
+
+	RunBenchmark("100k boxes: dynamic tree AABB overlap", 1000, [&]() {
+		tree.queryOverlaps(region, results);
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	LooseOctree octree(AABB(Vec3(-halfSize, -halfSize, -halfSize), Vec3(halfSize, halfSize, halfSize)));
+	std::vector<uint32_t> octreeIds(moving.size());
+	RunBenchmark("100k boxes: loose octree insert all", 5, [&]() {
+		octree.clear();
+		for (size_t i = 0; i < moving.size(); i++) {
+			octreeIds[i] = octree.insert(moving[i]);
+		}
+		benchmarkSink = static_cast<float>(octree.getNodeCount());
+	});
+
+	RunBenchmark("100k boxes: loose octree move all", 20, [&]() {
+		for (size_t i = 0; i < moving.size(); i++) {
+			moving[i].min = moving[i].min + velocities[i];
+			moving[i].max = moving[i].max + velocities[i];
+			octree.update(octreeIds[i], moving[i]);
+		}
+		benchmarkSink = static_cast<float>(octree.getNodeCount());
+	});
+
+	RunBenchmark("100k boxes: loose octree AABB overlap", 1000, [&]() {
+		octree.queryOverlaps(region, results);
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	// Camera culling: a 60 degree view from one side of the scene
+	Mat4 cameraView = Mat4().lookAt(Vec3(-halfSize, 0, 0), Vec3(0, 20, 10), Vec3(0, 1, 0));
+	Frustum frustum(Mat4().perspective(1.05f, 1.78f, 0.5f, 300.0f) * cameraView);
+	std::vector<uint32_t> visibleMask;
+
+	RunBenchmark("100k boxes: scalar frustum cull", 20, [&]() {
+		results.clear();
+		for (uint32_t i = 0; i < moving.size(); i++) {
+			if (frustum.intersects(moving[i])) {
+				results.push_back(i);
+			}
+		}
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	AABBArray movingArray(moving.data(), moving.size());
+	RunBenchmark("100k boxes: SoA frustum cull mask", 100, [&]() {
+		benchmarkSink = static_cast<float>(movingArray.frustumMask(frustum, visibleMask));
+	});
+
+	RunBenchmark("100k boxes: loose octree frustum cull", 100, [&]() {
+		octree.queryFrustum(frustum, results);
+		benchmarkSink = static_cast<float>(results.size());
+	});
+
+	RunBenchmark("100k boxes: loose octree closest hit x1000 rays", 5, [&]() {
+		float total = 0.0f;
+		RayHit hit;
+		for (const Ray& ray : rays) {
+			if (octree.raycast(ray, hit)) {
+				total += hit.distance;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	// Broadphase pairs: 50k boxes, denser than the query scene so pairs are common
+	const size_t pairCount = 50000;
+	std::vector<AABB> crowd = RandomBoxes(pairCount, 100.0f, 4);
+
+	RunBenchmark("50k boxes: brute-force pairs", 1, [&]() {
+		size_t found = 0;
+		for (size_t i = 0; i < crowd.size(); i++) {
+			for (size_t j = i + 1; j < crowd.size(); j++) {
+				found += aabbIntersectsAABB(crowd[i], crowd[j]) ? 1 : 0;
+			}
+		}
+		benchmarkSink = static_cast<float>(found);
+	});
+
+	SweepAndPrune sap;
+	std::vector<uint32_t> sapProxies;
+	for (const AABB& box : crowd) {
+		sapProxies.push_back(sap.createProxy(box));
+	}
+	RunBenchmark("50k boxes: sweep-and-prune first update", 1, [&]() {
+		sap.update();
+		benchmarkSink = static_cast<float>(sap.getPairs().size());
+	});
+
+	RunBenchmark("50k boxes: sweep-and-prune update after small moves", 20, [&]() {
+		for (size_t i = 0; i < crowd.size(); i++) {
+			crowd[i].min = crowd[i].min + velocities[i];
+			crowd[i].max = crowd[i].max + velocities[i];
+			sap.moveProxy(sapProxies[i], crowd[i]);
+		}
+		sap.update();
+		benchmarkSink = static_cast<float>(sap.getAddedPairs().size() + sap.getRemovedPairs().size());
+	});
+
+	// Particles: 50k spheres of similar radius
+	std::vector<Sphere> particles;
+	particles.reserve(pairCount);
+	for (const AABB& box : crowd) {
+		particles.emplace_back(box.getCenter(), 0.5f);
+	}
+	std::vector<std::pair<uint32_t, uint32_t>> spherePairs;
+
+	RunBenchmark("50k spheres: BVH build + per-sphere overlap", 5, [&]() {
+		bvh.build(particles.data(), particles.size());
+		size_t found = 0;
+		for (uint32_t i = 0; i < particles.size(); i++) {
+			bvh.queryOverlaps(particles[i], results);
+			for (uint32_t other : results) {
+				found += other > i ? 1 : 0;
+			}
+		}
+		benchmarkSink = static_cast<float>(found);
+	});
+
+	SpatialHashGrid grid(1.0f);
+	RunBenchmark("50k spheres: spatial hash build + pairs", 20, [&]() {
+		grid.build(particles.data(), particles.size());
+		grid.queryPairs(spherePairs);
+		benchmarkSink = static_cast<float>(spherePairs.size());
+	});
+
+	// Narrowphase: one ray against a few hundred broadphase candidates at a time
+	const size_t candidateCount = 512;
+	std::vector<Sphere> candidates;
+	for (size_t i = 0; i < candidateCount; i++) {
+		candidates.emplace_back(crowd[i].getCenter(), 4.0f);
+	}
+	std::vector<Ray> narrowRays = RandomRays(10000, 100.0f, 5);
+
+	RunBenchmark("512 spheres: scalar closest hit x10000 rays", 5, [&]() {
+		float total = 0.0f;
+		for (const Ray& ray : narrowRays) {
+			float closest = 1e30f;
+			for (const Sphere& sphere : candidates) {
+				float distance;
+				if (rayIntersectsSphere(ray, sphere, distance) && distance < closest) {
+					closest = distance;
+				}
+			}
+			total += closest;
+		}
+		benchmarkSink = total;
+	});
+
+	SphereArray sphereArray(candidates.data(), candidates.size());
+	RunBenchmark("512 spheres: SoA closest hit x10000 rays", 5, [&]() {
+		float total = 0.0f;
+		RayHit hit;
+		for (const Ray& ray : narrowRays) {
+			total += sphereArray.raycast(ray, hit) ? hit.distance : 0.0f;
+		}
+		benchmarkSink = total;
+	});
+
+	std::vector<AABB> candidateBoxes(crowd.begin(), crowd.begin() + candidateCount);
+	RunBenchmark("512 boxes: scalar closest hit x10000 rays", 5, [&]() {
+		float total = 0.0f;
+		for (const Ray& ray : narrowRays) {
+			float closest = 1e30f;
+			for (const AABB& box : candidateBoxes) {
+				float distance;
+				if (rayIntersectsAABB(ray, box, distance) && distance < closest) {
+					closest = distance;
+				}
+			}
+			total += closest;
+		}
+		benchmarkSink = total;
+	});
+
+	AABBArray boxArray(candidateBoxes.data(), candidateBoxes.size());
+	RunBenchmark("512 boxes: SoA closest hit x10000 rays", 5, [&]() {
+		float total = 0.0f;
+		RayHit hit;
+		for (const Ray& ray : narrowRays) {
+			total += boxArray.raycast(ray, hit) ? hit.distance : 0.0f;
+		}
+		benchmarkSink = total;
+	});
+
+	std::vector<uint32_t> hitMask;
+	RunBenchmark("512 boxes: SoA hit mask x10000 rays", 5, [&]() {
+		size_t hits = 0;
+		for (const Ray& ray : narrowRays) {
+			hits += boxArray.raycastMask(ray, hitMask);
+		}
+		benchmarkSink = static_cast<float>(hits);
+	});
+
+
+	// Triangle mesh: a 256x256 rolling terrain (131k triangles) seen by a camera looking down at it
+	const int terrainSize = 256;
+	std::vector<Vec3> terrainVertices;
+	std::vector<uint32_t> terrainIndices;
+	for (int y = 0; y <= terrainSize; y++) {
+		for (int x = 0; x <= terrainSize; x++) {
+			float height = 4.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f);
+			terrainVertices.emplace_back(static_cast<float>(x), height, static_cast<float>(y));
+		}
+	}
+	for (int y = 0; y < terrainSize; y++) {
+		for (int x = 0; x < terrainSize; x++) {
+			uint32_t corner = static_cast<uint32_t>(y * (terrainSize + 1) + x);
+			uint32_t above = corner + terrainSize + 1;
+			terrainIndices.insert(terrainIndices.end(), { corner, corner + 1, above + 1, corner, above + 1, above });
+		}
+	}
+
+	std::vector<Ray> terrainRays;
+	for (int y = 0; y < 64; y += 2) {
+		for (int x = 0; x < 64; x += 2) {
+			for (int i = 0; i < 4; i++) {
+				float u = static_cast<float>(x + (i & 1)) / 64.0f - 0.5f;
+				float v = static_cast<float>(y + (i >> 1)) / 64.0f - 0.5f;
+				terrainRays.emplace_back(Vec3(128, 60, -20), Vec3(u, v * 0.5f - 0.6f, 1.0f));
+			}
+		}
+	}
+
+	TriangleMesh terrain;
+	RunBenchmark("131k triangles: mesh build", 5, [&]() {
+		terrain.build(terrainVertices.data(), terrainVertices.size(), terrainIndices.data(), terrainIndices.size());
+	});
+
+	RunBenchmark("131k triangles: brute-force closest hit x64 rays", 2, [&]() {
+		float total = 0.0f;
+		for (size_t r = 0; r < terrainRays.size(); r += 64) {
+			float closest = 0.0f;
+			bool found = false;
+			for (size_t i = 0; i < terrainIndices.size(); i += 3) {
+				float distance, u, v;
+				if (rayIntersectsTriangle(terrainRays[r], terrainVertices[terrainIndices[i]],
+					terrainVertices[terrainIndices[i + 1]], terrainVertices[terrainIndices[i + 2]], distance, u, v) &&
+					(!found || distance < closest)) {
+					closest = distance;
+					found = true;
+				}
+			}
+			total += closest;
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("131k triangles: mesh closest hit x4096 coherent rays", 5, [&]() {
+		float total = 0.0f;
+		TriangleHit hit;
+		for (const Ray& ray : terrainRays) {
+			if (terrain.raycast(ray, hit)) {
+				total += hit.distance;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("131k triangles: mesh closest hit x1024 coherent packets", 5, [&]() {
+		float total = 0.0f;
+		TriangleHit hits[RayPacket::Width];
+		for (size_t i = 0; i < terrainRays.size(); i += RayPacket::Width) {
+			uint32_t mask = terrain.raycast(RayPacket(&terrainRays[i], RayPacket::Width), hits);
+			for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+				total += ((mask >> lane) & 1u) ? hits[lane].distance : 0.0f;
+			}
+		}
+		benchmarkSink = total;
+	});
+
+	RunBenchmark("131k triangles: mesh any hit x4096 coherent rays", 5, [&]() {
+		size_t hits = 0;
+		for (const Ray& ray : terrainRays) {
+			hits += terrain.raycastAny(ray) ? 1 : 0;
+		}
+		benchmarkSink = static_cast<float>(hits);
+	});
+
+	return 0;
+}
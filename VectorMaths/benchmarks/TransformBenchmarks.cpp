@@ -0,0 +1,377 @@
+/**
+ * @file TransformBenchmarks.cpp
+ * @brief Benchmarks for world matrix evaluation over deep and wide hierarchies
+ */
+
+#include "Benchmark.hpp"
+#include "Transform.hpp"
+#include "TransformSystem.hpp"
+#include "TransformFile.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Builds a single chain root -> ... -> leaf of the given depth
+std::vector<std::unique_ptr<Transform>> BuildChain(int depth) {
+	std::vector<std::unique_ptr<Transform>> nodes;
+	nodes.reserve(depth);
+	for (int i = 0; i < depth; i++) {
+		nodes.emplace_back(std::make_unique<Transform>());
+		nodes.back()->SetPosition(Vec3(0.0f, 1.0f, 0.0f));
+		if (i > 0) {
+			nodes[i - 1]->AddChild(nodes[i].get());
+		}
+	}
+	return nodes;
+}
+
+/// Builds a root with the given number of direct children
+std::vector<std::unique_ptr<Transform>> BuildFan(int width) {
+	std::vector<std::unique_ptr<Transform>> nodes;
+	nodes.reserve(width + 1);
+	nodes.emplace_back(std::make_unique<Transform>());
+	for (int i = 0; i < width; i++) {
+		nodes.emplace_back(std::make_unique<Transform>());
+		nodes.back()->SetPosition(Vec3(static_cast<float>(i), 0.0f, 0.0f));
+		nodes[0]->AddChild(nodes.back().get());
+	}
+	return nodes;
+}
+
+/// Parent of node i in a bushy tree: node i hangs off node (i - 1) / branching
+int TreeParent(int i, int branching) {
+	return i == 0 ? -1 : (i - 1) / branching;
+}
+
+void QueryAll(const std::vector<std::unique_ptr<Transform>>& nodes) {
+	float sum = 0.0f;
+	for (const auto& node : nodes) {
+		sum += node->GetWorldMatrix().m[12];
+	}
+	benchmarkSink = sum;
+}
+
+} // namespace
+
+int main() {
+	const int depth = 1000;
+	const int width = 10000;
+
+	auto chain = BuildChain(depth);
+	Transform* leaf = chain.back().get();
+
+	RunBenchmark("Deep chain: leaf query, unchanged", 10000, [&]() {
+		benchmarkSink = leaf->GetWorldMatrix().m[13];
+	});
+
+	RunBenchmark("Deep chain: leaf query after root move", 1000, [&]() {
+		chain[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		benchmarkSink = leaf->GetWorldMatrix().m[13];
+	});
+
+	RunBenchmark("Deep chain: query every node, unchanged", 1000, [&]() {
+		QueryAll(chain);
+	});
+
+	RunBenchmark("Deep chain: query every node after root move", 100, [&]() {
+		chain[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		QueryAll(chain);
+	});
+
+	auto fan = BuildFan(width);
+
+	RunBenchmark("Wide fan: query every node, unchanged", 1000, [&]() {
+		QueryAll(fan);
+	});
+
+	RunBenchmark("Wide fan: query every node after root move", 100, [&]() {
+		fan[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		QueryAll(fan);
+	});
+
+	// Rope-style 100k-deep chain
+	const int ropeLength = 100000;
+	auto rope = BuildChain(ropeLength);
+
+	RunBenchmark("100k-deep chain: leaf query after root move", 20, [&]() {
+		rope[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		benchmarkSink = rope.back()->GetWorldMatrix().m[13];
+	});
+
+	RunBenchmark("100k-deep chain: root move x10, no query", 1000, [&]() {
+		for (int i = 0; i < 10; i++) {
+			rope[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		}
+	});
+
+	RunBenchmark("100k-deep chain: VisitSubtree", 20, [&]() {
+		int visited = 0;
+		rope[0]->VisitSubtree([&](Transform&) { visited++; });
+		benchmarkSink = static_cast<float>(visited);
+	});
+
+	TransformSystem ropeSystem;
+	std::vector<uint32_t> ropeParents(ropeLength);
+	for (int i = 0; i < ropeLength; i++) {
+		ropeParents[i] = i == 0 ? TransformSystem::NoParent : static_cast<uint32_t>(i - 1);
+	}
+	std::vector<TransformHandle> ropeHandles(ropeLength);
+	ropeSystem.CreateBatch(ropeLength, ropeParents.data(), nullptr, nullptr, nullptr, ropeHandles.data());
+	ropeSystem.UpdateWorldMatrices();
+
+	RunBenchmark("100k-deep chain: TransformSystem update after root move", 20, [&]() {
+		ropeSystem.Translate(ropeHandles[0], Vec3(0.0f, 0.0f, 0.001f));
+		ropeSystem.UpdateWorldMatrices();
+		benchmarkSink = ropeSystem.GetWorldMatrix(ropeHandles.back()).m[14];
+	});
+
+	// Gameplay-style world-space placement of many children under one parent
+	auto placed = BuildFan(1000);
+	placed[0]->SetRotation(Quaternion::fromAxisAngle(Vec3(0.0f, 1.0f, 0.0f), 0.5f));
+
+	RunBenchmark("1000 children: world position via cofactor inverse", 100, [&]() {
+		for (size_t i = 1; i < placed.size(); i++) {
+			Vec4 local = placed[0]->GetWorldMatrix().inverse() * Vec4(1.0f, 2.0f, 3.0f, 1.0f);
+			placed[i]->SetPosition(Vec3(local.x, local.y, local.z));
+		}
+	});
+
+	RunBenchmark("1000 children: SetWorldPosition", 100, [&]() {
+		for (size_t i = 1; i < placed.size(); i++) {
+			placed[i]->SetWorldPosition(Vec3(1.0f, 2.0f, 3.0f));
+		}
+	});
+
+	// Many separate scenes: a write to one hierarchy must not invalidate reads in the others
+	const int sceneCount = 100;
+	std::vector<std::vector<std::unique_ptr<Transform>>> scenes;
+	for (int i = 0; i < sceneCount; i++) {
+		scenes.push_back(BuildChain(100));
+	}
+
+	RunBenchmark("100 chains: move one root, query another's leaf", 100, [&]() {
+		float sum = 0.0f;
+		for (int i = 1; i < sceneCount; i++) {
+			scenes[0][0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+			sum += scenes[i].back()->GetWorldMatrix().m[13];
+		}
+		benchmarkSink = sum;
+	});
+
+	RunBenchmark("100 chains: move one root, SetWorldPosition in another", 100, [&]() {
+		for (int i = 1; i < sceneCount; i++) {
+			scenes[0][0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+			scenes[i].back()->SetWorldPosition(Vec3(1.0f, 2.0f, 3.0f));
+		}
+	});
+
+	// Same bushy tree as Transform objects and in a flat TransformSystem
+	const int treeSize = 100000;
+	const int branching = 4;
+
+	std::vector<std::unique_ptr<Transform>> tree;
+	tree.reserve(treeSize);
+	TransformSystem system;
+	system.Reserve(treeSize);
+	std::vector<TransformHandle> handles;
+	handles.reserve(treeSize);
+
+	for (int i = 0; i < treeSize; i++) {
+		Vec3 position(0.0f, 1.0f, static_cast<float>(i % 7));
+		tree.emplace_back(std::make_unique<Transform>(position, Quaternion(), Vec3(1.0f, 1.0f, 1.0f)));
+		handles.push_back(system.Create(position, Quaternion(), Vec3(1.0f, 1.0f, 1.0f)));
+
+		int parent = TreeParent(i, branching);
+		if (parent >= 0) {
+			tree[parent]->AddChild(tree[i].get());
+			system.SetParent(handles[i], handles[parent]);
+		}
+	}
+	system.UpdateWorldMatrices();
+
+	RunBenchmark("100k tree: Transform query all after root move", 20, [&]() {
+		tree[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		QueryAll(tree);
+	});
+
+	RunBenchmark("100k tree: Transform root move x10, no query", 1000, [&]() {
+		for (int i = 0; i < 10; i++) {
+			tree[0]->Translate(Vec3(0.0f, 0.0f, 0.001f));
+		}
+	});
+
+	RunBenchmark("100k tree: TransformSystem update after root move", 20, [&]() {
+		system.Translate(handles[0], Vec3(0.0f, 0.0f, 0.001f));
+		system.UpdateWorldMatrices();
+		benchmarkSink = system.GetWorldMatrices()[treeSize - 1].m[12];
+	});
+
+	RunBenchmark("100k tree: TransformSystem parallel update after root move", 20, [&]() {
+		system.Translate(handles[0], Vec3(0.0f, 0.0f, 0.001f));
+		system.UpdateWorldMatricesParallel();
+		benchmarkSink = system.GetWorldMatrices()[treeSize - 1].m[12];
+	});
+
+	RunBenchmark("100k tree: TransformSystem parallel update after one leaf move", 1000, [&]() {
+		system.Translate(handles[treeSize - 1], Vec3(0.0f, 0.0f, 0.001f));
+		system.UpdateWorldMatricesParallel();
+		benchmarkSink = system.GetWorldMatrices()[treeSize - 1].m[14];
+	});
+
+	// Replication-style tick: a batch of leaves receives new positions
+	std::vector<TransformHandle> movedLeaves;
+	std::vector<Vec3> leafPositions;
+	for (int i = treeSize - 1000; i < treeSize; i++) {
+		movedLeaves.push_back(handles[i]);
+		leafPositions.emplace_back(0.0f, 1.0f, static_cast<float>(i % 5));
+	}
+
+	RunBenchmark("100k tree: batch set 1000 leaves + update", 100, [&]() {
+		leafPositions[0].x += 0.001f;
+		system.SetPositions(movedLeaves.data(), leafPositions.data(), movedLeaves.size());
+		system.UpdateWorldMatrices();
+		benchmarkSink = system.GetWorldMatrices()[treeSize - 1].m[12];
+	});
+
+	// Render-rate interpolation between two simulation steps where 1000 leaves moved
+	std::vector<Vec3> previousPositions(treeSize);
+	std::vector<Quaternion> previousRotations(treeSize);
+	std::vector<Vec3> previousScales(treeSize);
+	for (int i = 0; i < treeSize; i++) {
+		previousPositions[i] = system.GetPosition(handles[i]);
+		previousRotations[i] = system.GetRotation(handles[i]);
+		previousScales[i] = system.GetScale(handles[i]);
+	}
+	system.SavePreviousState();
+	leafPositions[0].x += 0.5f;
+	system.SetPositions(movedLeaves.data(), leafPositions.data(), movedLeaves.size());
+	system.UpdateWorldMatrices();
+
+	std::vector<Mat4> renderMatrices(treeSize);
+	RunBenchmark("100k tree: manual lerp/slerp interpolation", 20, [&]() {
+		for (int i = 0; i < treeSize; i++) {
+			Mat4 local = Transform::ComposeMatrix(
+				Vec3::lerp(previousPositions[i], system.GetPosition(handles[i]), 0.5f),
+				Quaternion::slerp(previousRotations[i], system.GetRotation(handles[i]), 0.5f),
+				Vec3::lerp(previousScales[i], system.GetScale(handles[i]), 0.5f));
+			int parent = TreeParent(i, branching);
+			renderMatrices[i] = parent < 0 ? local : renderMatrices[parent] * local;
+		}
+		benchmarkSink = renderMatrices[treeSize - 1].m[12];
+	});
+
+	RunBenchmark("100k tree: InterpolateWorldMatrices, 1000 movers", 20, [&]() {
+		system.InterpolateWorldMatrices(0.5f, renderMatrices);
+		benchmarkSink = renderMatrices[treeSize - 1].m[12];
+	});
+
+	// Culling bounds for every node of the tree after 1000 leaves moved
+	AABB unitBox(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f));
+	for (int i = 0; i < treeSize; i++) {
+		system.SetLocalBounds(handles[i], unitBox);
+	}
+	system.UpdateBounds();
+
+	std::vector<AABB> recomputedBounds(treeSize);
+	RunBenchmark("100k tree: recompute all subtree bounds", 20, [&]() {
+		leafPositions[0].x += 0.001f;
+		system.SetPositions(movedLeaves.data(), leafPositions.data(), movedLeaves.size());
+		system.UpdateWorldMatrices();
+		const Mat4* world = system.GetWorldMatrices();
+		for (int i = treeSize - 1; i >= 0; i--) {
+			AABB bounds = AABB::empty();
+			for (int corner = 0; corner < 8; corner++) {
+				Vec4 p = world[i] * Vec4((corner & 1) ? 0.5f : -0.5f, (corner & 2) ? 0.5f : -0.5f, (corner & 4) ? 0.5f : -0.5f, 1.0f);
+				bounds.expand(Vec3(p.x, p.y, p.z));
+			}
+			for (int c = i * branching + 1; c <= i * branching + branching && c < treeSize; c++) {
+				bounds = bounds.merge(recomputedBounds[c]);
+			}
+			recomputedBounds[i] = bounds;
+		}
+		benchmarkSink = recomputedBounds[0].max.z;
+	});
+
+	RunBenchmark("100k tree: incremental UpdateBounds, 1000 movers", 20, [&]() {
+		leafPositions[0].x += 0.001f;
+		system.SetPositions(movedLeaves.data(), leafPositions.data(), movedLeaves.size());
+		benchmarkSink = system.GetSubtreeBounds(handles[0]).max.z;
+	});
+
+	// Scene setup and teardown of the same tree
+	std::vector<uint32_t> parentIndices(treeSize);
+	for (int i = 0; i < treeSize; i++) {
+		int parent = TreeParent(i, branching);
+		parentIndices[i] = parent < 0 ? TransformSystem::NoParent : static_cast<uint32_t>(parent);
+	}
+
+	RunBenchmark("100k tree: Transform objects create + destroy", 10, [&]() {
+		std::vector<std::unique_ptr<Transform>> nodes;
+		nodes.reserve(treeSize);
+		for (int i = 0; i < treeSize; i++) {
+			nodes.emplace_back(std::make_unique<Transform>());
+			if (parentIndices[i] != TransformSystem::NoParent) {
+				nodes[parentIndices[i]]->AddChild(nodes[i].get());
+			}
+		}
+		benchmarkSink = static_cast<float>(nodes.size());
+	});
+
+	TransformSystem pooled;
+	pooled.Reserve(treeSize);
+	RunBenchmark("100k tree: TransformSystem CreateBatch + Clear", 10, [&]() {
+		pooled.CreateBatch(treeSize, parentIndices.data(), nullptr, nullptr, nullptr, nullptr);
+		benchmarkSink = static_cast<float>(pooled.Size());
+		pooled.Clear();
+	});
+
+	// Level load of a million-node scene
+	const int sceneSize = 1000000;
+	std::vector<uint32_t> sceneParents(sceneSize);
+	for (int i = 0; i < sceneSize; i++) {
+		int parent = TreeParent(i, branching);
+		sceneParents[i] = parent < 0 ? TransformSystem::NoParent : static_cast<uint32_t>(parent);
+	}
+
+	TransformSystem scene;
+	std::vector<TransformHandle> sceneHandles(sceneSize);
+	scene.CreateBatch(sceneSize, sceneParents.data(), nullptr, nullptr, nullptr, sceneHandles.data());
+	const std::string scenePath = "transform_benchmark_scene.vmtf";
+	TransformFile::Save(scenePath, scene, true);
+
+	RunBenchmark("1M scene: CreateBatch + update", 5, [&]() {
+		TransformSystem built;
+		built.CreateBatch(sceneSize, sceneParents.data(), nullptr, nullptr, nullptr, nullptr);
+		built.UpdateWorldMatrices();
+		benchmarkSink = built.GetWorldMatrices()[sceneSize - 1].m[13];
+	});
+
+	TransformSystem loaded;
+	RunBenchmark("1M scene: mmap TransformFile + LoadInto", 5, [&]() {
+		TransformFile file(scenePath);
+		file.LoadInto(loaded);
+		loaded.UpdateWorldMatrices();
+		benchmarkSink = loaded.GetWorldMatrices()[sceneSize - 1].m[13];
+	});
+
+	// One mover in a million-node scene: the refit visits its ancestors, not every node
+	for (int i = 0; i < sceneSize; i++) {
+		scene.SetLocalBounds(sceneHandles[i], unitBox);
+	}
+	scene.UpdateBounds();
+
+	std::vector<TransformHandle> visible;
+	AABB region(Vec3(10.0f, 10.0f, 10.0f), Vec3(11.0f, 11.0f, 11.0f));
+	RunBenchmark("1M scene: move one leaf + QueryBounds", 100, [&]() {
+		scene.Translate(sceneHandles[sceneSize - 1], Vec3(0.0f, 0.0f, 0.001f));
+		visible.clear();
+		scene.QueryBounds(region, visible);
+		benchmarkSink = static_cast<float>(visible.size());
+	});
+
+	std::remove(scenePath.c_str());
+	return 0;
+}
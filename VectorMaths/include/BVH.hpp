@@ -0,0 +1,148 @@
+/**
+ * @file BVH.hpp
+ * @brief Bounding volume hierarchy for ray and overlap queries over many primitives
+ *
+ * Builds a binary tree of AABBs over a static set of boxes or spheres using
+ * the surface area heuristic, so that ray casts and overlap queries visit
+ * O(log n) nodes instead of testing every primitive.
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+#include "RayPacket.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Static bounding volume hierarchy over AABB or sphere primitives
+ *
+ * Built top-down with a binned surface area heuristic. Nodes are stored
+ * depth-first in one contiguous array: the left child of an interior node
+ * directly follows it, so only the right child index is stored, and every
+ * node is 32 bytes. Primitives are copied into leaf order so each leaf reads
+ * a contiguous range.
+ *
+ * Leaf tests use the same functions as single-pair queries
+ * (rayIntersectsAABB, rayIntersectsSphere, ...), so results match a loop over
+ * every primitive.
+ *
+ * @note The hierarchy is static: rebuild it after primitives move.
+ */
+class BVH {
+public:
+	static constexpr uint32_t MaxLeafSize = 4;    ///< Primitives per leaf before a split is forced
+	static constexpr uint32_t BinCount = 12;      ///< SAH bins per axis
+	static constexpr uint32_t MaxDepth = 64;      ///< Upper bound on tree depth (traversal stack size)
+
+	/// Creates an empty hierarchy
+	BVH();
+
+	/**
+	 * @brief Builds the hierarchy over boxes
+	 * @param boxes Primitive bounds
+	 * @param count Number of boxes
+	 */
+	void build(const AABB* boxes, size_t count);
+
+	/**
+	 * @brief Builds the hierarchy over spheres
+	 * @param spheres Primitive spheres (tested exactly at the leaves)
+	 * @param count Number of spheres
+	 */
+	void build(const Sphere* spheres, size_t count);
+
+	/// Removes all primitives and nodes
+	void clear();
+
+	/// Returns the number of primitives
+	size_t size() const;
+
+	/// Returns the number of nodes
+	size_t getNodeCount() const;
+
+	/// Returns the bounds of all primitives (empty if there are none)
+	AABB getBounds() const;
+
+	/**
+	 * @brief Finds the closest primitive hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit if one is found
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any primitive is hit within maxDistance
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Tests if a ray hits any primitive, stopping at the first one found
+	 * @param ray The ray to cast
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any primitive is hit within maxDistance
+	 * @note Cheaper than raycast(); suited to shadow and line-of-sight tests
+	 */
+	bool raycastAny(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds the closest primitive hit by each ray of a packet
+	 *
+	 * Gives the same hits as calling raycast() for each ray. Equal distances
+	 * go to the lower primitive index in both.
+	 *
+	 * @param packet The rays to cast
+	 * @param[out] hits Set, for each lane that hits, to the closest hit
+	 * @param maxDistance Hits further along the rays are ignored
+	 * @return Mask of the active lanes that hit any primitive within maxDistance
+	 */
+	uint32_t raycast(const RayPacket& packet, RayHit hits[RayPacket::Width],
+		float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/// Returns the mask of packet lanes that hit any primitive; each lane stops at its first hit
+	uint32_t raycastAny(const RayPacket& packet, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds every primitive overlapping a box
+	 * @param box Query box
+	 * @param[out] results Receives the primitive indices (unordered)
+	 */
+	void queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Finds every primitive overlapping a sphere
+	 * @param sphere Query sphere
+	 * @param[out] results Receives the primitive indices (unordered)
+	 */
+	void queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const;
+
+private:
+	/// Flattened node, 32 bytes
+	struct Node {
+		AABB bounds;       ///< Bounds of everything below this node
+		uint32_t offset;   ///< Leaf: first primitive; interior: right child index
+		uint32_t count;    ///< Number of primitives (0 for interior nodes)
+	};
+
+	std::vector<Node> nodes;                 ///< Depth-first node array, root first
+	std::vector<AABB> primitiveBounds;       ///< Primitive bounds in leaf order
+	std::vector<Sphere> spheres;             ///< Primitive spheres in leaf order (empty for box primitives)
+	std::vector<uint32_t> primitiveIndices;  ///< Leaf order -> index passed to build()
+
+	/// Builds the tree over primitiveBounds, then reorders the primitive arrays
+	void buildNodes();
+
+	/// Exact ray test against one primitive in leaf order
+	bool intersectPrimitive(const Ray& ray, uint32_t primitive, float& distance) const;
+
+	/// Walks the tree; stops at the first hit if anyHit is set
+	bool traverse(const Ray& ray, RayHit& hit, float maxDistance, bool anyHit) const;
+
+	/// Walks the tree with a packet; lanes retire at their first hit if anyHit is set
+	uint32_t traversePacket(const RayPacket& packet, RayHit hits[RayPacket::Width], float maxDistance, bool anyHit) const;
+
+	/// Collects primitives whose node and own test both pass
+	template<typename NodeTest, typename PrimitiveTest>
+	void collect(const NodeTest& nodeTest, const PrimitiveTest& primitiveTest, std::vector<uint32_t>& results) const;
+};
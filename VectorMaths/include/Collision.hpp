@@ -10,6 +10,7 @@
 #include "Vector.hpp"
 
 #include <cmath>
+#include <cstdint>
 
 /**
  * @brief Represents a ray in 3D space for collision detection and raycasting
@@ -18,12 +19,13 @@
  * extending infinitely in one direction. Commonly used for mouse picking,
  * line-of-sight tests, and physics queries.
  *
- * @note The direction vector is automatically normalized in the constructor
+ * @note The direction vector is automatically normalized in the constructor.
+ *       It is only changed through setDirection, which keeps the cached
+ *       inverse direction and signs used by the slab tests in step.
  */
 class Ray {
 public:
-	Vec3 origin;     ///< Starting point of the ray
-	Vec3 direction;  ///< Normalized direction vector
+	Vec3 origin;  ///< Starting point of the ray
 
 	/// Default constructor - ray at origin pointing along positive Z axis
 	Ray();
@@ -35,12 +37,34 @@ public:
 	 */
 	Ray(const Vec3& origin, const Vec3& direction);
 
+	/**
+	 * @brief Changes the direction, refreshing the cached inverse and signs
+	 * @param direction Direction vector (will be normalized automatically)
+	 */
+	void setDirection(const Vec3& direction);
+
+	/// Returns the normalized direction
+	const Vec3& getDirection() const { return direction; }
+
+	/// Returns 1 / direction per component (infinite for axis-parallel components)
+	const Vec3& getInverseDirection() const { return inverseDirection; }
+
+	/// Returns 1 if the inverse direction is negative on an axis, selecting the near box face
+	int getSign(int axis) const { return sign[axis]; }
+
 	/**
 	 * @brief Returns a point at distance t along the ray
 	 * @param t Distance along the ray (t=0 is origin, t=1 is one unit away)
 	 * @return Point at position origin + direction * t
 	 */
 	Vec3 getPoint(float t) const;
+
+private:
+	friend class RayPacket;  // Rebuilds lanes exactly, without renormalizing
+
+	Vec3 direction;         ///< Normalized direction vector
+	Vec3 inverseDirection;  ///< 1 / direction per component
+	int sign[3];            ///< 1 where inverseDirection is negative
 };
 
 /**
@@ -72,6 +96,17 @@ public:
 	 */
 	static AABB fromCenterAndExtents(const Vec3& center, const Vec3& halfExtents);
 
+	/**
+	 * @brief Creates an inverted box that contains nothing
+	 *
+	 * Merging or expanding an empty box yields the other operand, so it is the
+	 * starting value for accumulating bounds.
+	 */
+	static AABB empty();
+
+	/// Returns true if the box contains no points (min exceeds max on some axis)
+	bool isEmpty() const;
+
 	/// Returns the half-extents (half-size) of the box in each dimension
 	Vec3 getExtents() const;
 
@@ -81,6 +116,12 @@ public:
 	/// Returns true if the point is inside or on the surface of the box
 	bool contains(const Vec3& point) const;
 
+	/// Returns true if the other box lies entirely inside this one
+	bool contains(const AABB& other) const;
+
+	/// Returns the total area of the six faces (0 for an empty box)
+	float getSurfaceArea() const;
+
 	/**
 	 * @brief Expands the AABB to include the given point
 	 * @param point Point to include in the bounding box
@@ -92,7 +133,7 @@ public:
 	 * @param other The other bounding box to merge with
 	 * @return New AABB containing both boxes
 	 */
-	AABB merge(const AABB& other);
+	AABB merge(const AABB& other) const;
 };
 
 /**
@@ -120,6 +161,12 @@ public:
 	bool contains(const Vec3& point) const;
 };
 
+/// Result of a ray query against a set of primitives
+struct RayHit {
+	uint32_t index = 0;      ///< Index of the primitive that was hit
+	float distance = 0.0f;   ///< Distance along the ray to the hit point
+};
+
 // ========== Intersection Functions ==========
 
 /**
@@ -147,9 +194,31 @@ bool rayIntersectsPlane(const Ray& ray, const Vec3& planeNormal, const Vec3& pla
  * @param box The AABB to test against
  * @param[out] distance Set to distance along ray to intersection point if hit
  * @return true if intersection occurs, false otherwise
+ * @note Branchless slab test using the ray's cached inverse direction. A ray
+ *       parallel to an axis counts as inside that slab when it lies exactly on
+ *       one of its faces, so touching boxes are hit.
  */
 bool rayIntersectsAABB(const Ray& ray, const AABB& box, float& distance);
 
+/**
+ * @brief Tests if a ray intersects a triangle (either face)
+ *
+ * Watertight (Woop, Benthin and Wald): a ray through an edge or vertex shared
+ * by several triangles of a mesh hits at least one of them, so closed meshes
+ * have no cracks. The hit point is a * (1 - u - v) + b * u + c * v.
+ *
+ * @param ray The ray to test
+ * @param a First vertex
+ * @param b Second vertex
+ * @param c Third vertex
+ * @param[out] distance Set to distance along ray to intersection point if hit
+ * @param[out] u Set to the barycentric weight of b if hit
+ * @param[out] v Set to the barycentric weight of c if hit
+ * @return true if intersection occurs, false if the ray misses, is behind, or the triangle is degenerate
+ */
+bool rayIntersectsTriangle(const Ray& ray, const Vec3& a, const Vec3& b, const Vec3& c,
+	float& distance, float& u, float& v);
+
 /**
  * @brief Tests if two AABBs overlap
  * @param a First AABB
@@ -174,4 +243,13 @@ bool pointInAABB(const Vec3& point, const AABB& box);
  * @return true if spheres overlap (including touching), false otherwise
  * @note Uses squared distance to avoid sqrt
  */
-bool sphereIntersectsSphere(const Sphere& a, const Sphere& b);
\ No newline at end of file
+bool sphereIntersectsSphere(const Sphere& a, const Sphere& b);
+
+/**
+ * @brief Tests if a sphere overlaps an AABB
+ * @param sphere The sphere to test
+ * @param box The AABB to test against
+ * @return true if they overlap (including touching), false otherwise
+ * @note Compares the squared distance from the center to the closest point on the box
+ */
+bool sphereIntersectsAABB(const Sphere& sphere, const AABB& box);
\ No newline at end of file
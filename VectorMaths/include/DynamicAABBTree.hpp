@@ -0,0 +1,151 @@
+/**
+ * @file DynamicAABBTree.hpp
+ * @brief Incrementally updated AABB tree for moving objects
+ *
+ * A broad-phase structure in the style of Box2D's dynamic tree: every object
+ * is a leaf holding a fattened box, and internal nodes are kept balanced by
+ * tree rotations as leaves are inserted and removed.
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+#include "BVH.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dynamic bounding volume tree over moving boxes
+ *
+ * Each proxy stores its tight box and a fat box enlarged by a fixed margin
+ * and, after a move, by the predicted displacement. Moving a proxy whose
+ * tight box is still inside its fat box costs nothing; otherwise the leaf is
+ * removed and reinserted, which is O(log n). Insertion picks the sibling that
+ * least increases total surface area, and AVL-style rotations keep the tree
+ * height logarithmic.
+ *
+ * Overlap and pair queries work on fat boxes (a conservative broad phase);
+ * ray queries test the tight boxes.
+ */
+class DynamicAABBTree {
+public:
+	static constexpr uint32_t NullProxy = 0xFFFFFFFFu;  ///< Returned for "no proxy"
+	static constexpr uint32_t StackSize = 128;          ///< Traversal stack size (far above any balanced height)
+
+	/**
+	 * @brief Creates an empty tree
+	 * @param margin Distance added to every side of a proxy's tight box
+	 * @param displacementScale Multiple of a move's displacement added ahead of the box
+	 */
+	explicit DynamicAABBTree(float margin = 0.1f, float displacementScale = 4.0f);
+
+	/**
+	 * @brief Adds an object to the tree
+	 * @param bounds Tight bounds of the object
+	 * @return Proxy id, stable until the proxy is destroyed
+	 */
+	uint32_t createProxy(const AABB& bounds);
+
+	/// Removes an object from the tree; the id may be reused by a later proxy
+	void destroyProxy(uint32_t proxy);
+
+	/**
+	 * @brief Updates the bounds of an object
+	 *
+	 * The tree is only changed if the new tight box leaves the fat box.
+	 *
+	 * @param proxy Proxy to move
+	 * @param bounds New tight bounds
+	 * @param displacement Movement since the last update, used to predict the next one
+	 * @return true if the proxy was reinserted
+	 */
+	bool moveProxy(uint32_t proxy, const AABB& bounds, const Vec3& displacement = Vec3());
+
+	/// Removes every proxy
+	void clear();
+
+	/// Returns the number of proxies
+	size_t size() const;
+
+	/// Returns the height of the tree (0 for a single leaf or an empty tree)
+	uint32_t getHeight() const;
+
+	/// Returns the tight bounds of a proxy
+	const AABB& getBounds(uint32_t proxy) const;
+
+	/// Returns the fat bounds stored in the tree for a proxy
+	const AABB& getFatBounds(uint32_t proxy) const;
+
+	/**
+	 * @brief Finds every proxy whose fat box overlaps a box
+	 * @param box Query box
+	 * @param[out] results Receives the proxy ids (unordered)
+	 */
+	void queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Finds every pair of proxies whose fat boxes overlap
+	 * @param[out] pairs Receives each pair once, with the smaller id first
+	 */
+	void queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+
+	/**
+	 * @brief Finds the closest proxy whose tight box is hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit (index is the proxy id)
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any proxy is hit within maxDistance
+	 * @note Equal distances go to the lower proxy id, whatever the tree shape
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/// Tests if a ray hits any proxy's tight box, stopping at the first one found
+	bool raycastAny(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/// Tree node; leaves are proxies
+	struct Node {
+		AABB bounds;       ///< Fat box for leaves, union of children otherwise
+		uint32_t parent;   ///< Parent node, or next free node while on the free list
+		uint32_t child1;   ///< First child (NullProxy for leaves)
+		uint32_t child2;   ///< Second child (NullProxy for leaves)
+		int32_t height;    ///< 0 for leaves, -1 for free nodes
+	};
+
+	std::vector<Node> nodes;        ///< Node pool, indexed by node id (proxy ids are leaf node ids)
+	std::vector<AABB> tightBounds;  ///< Tight box of each leaf, indexed by node id
+	uint32_t root;                  ///< Root node (NullProxy if empty)
+	uint32_t freeList;              ///< First free node
+	size_t proxyCount;              ///< Number of live proxies
+	float margin;                   ///< Fixed fattening distance
+	float displacementScale;        ///< Fattening along the predicted movement
+
+	/// Takes a node from the free list, growing the pool if needed
+	uint32_t allocateNode();
+
+	/// Returns a node to the free list
+	void freeNode(uint32_t node);
+
+	/// Inserts a leaf next to the sibling that least increases the total area
+	void insertLeaf(uint32_t leaf);
+
+	/// Detaches a leaf and removes its parent node
+	void removeLeaf(uint32_t leaf);
+
+	/// Refits bounds and heights from a node up to the root, rotating where unbalanced
+	void refitAncestors(uint32_t node);
+
+	/// Rotates a child up if the subtree heights differ by more than one; returns the subtree root
+	uint32_t balance(uint32_t node);
+
+	/// Returns the fat box for given tight bounds and displacement
+	AABB fatten(const AABB& bounds, const Vec3& displacement) const;
+
+	/// Walks the tree; stops at the first hit if anyHit is set
+	bool traverse(const Ray& ray, RayHit& hit, float maxDistance, bool anyHit) const;
+};
@@ -0,0 +1,101 @@
+/**
+ * @file Frustum.hpp
+ * @brief View frustum built from a view-projection matrix, for visibility culling
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "Collision.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Six planes bounding the volume a camera can see
+ *
+ * Planes are (normal, distance) with inside points satisfying
+ * dot(normal, point) + distance >= 0. Volume tests are conservative: a box or
+ * sphere near a frustum corner may be reported as visible even though it is
+ * just outside, but a visible one is never reported as outside.
+ *
+ * Hierarchies can pass a plane mask from parent to child: planes a parent is
+ * entirely inside of are cleared from the mask, so its children skip them,
+ * and children of a node that is inside every plane need no tests at all.
+ */
+class Frustum {
+public:
+	/// Plane indices, also the bit positions in plane masks
+	enum : uint32_t {
+		Left,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+		PlaneCount
+	};
+
+	static constexpr uint32_t AllPlanes = (1u << PlaneCount) - 1;  ///< Plane mask with every plane set
+
+	/// Result of classifying a volume against the planes
+	enum Classification : uint8_t {
+		Outside,       ///< Entirely behind at least one plane
+		Intersecting,  ///< Possibly crossing the boundary
+		Inside         ///< Entirely inside every tested plane
+	};
+
+	Vec4 planes[PlaneCount];  ///< Planes in Left, Right, Bottom, Top, Near, Far order
+
+	/// Default constructor - a frustum containing everything
+	Frustum();
+
+	/**
+	 * @brief Extracts the planes of a view-projection matrix (Gribb/Hartmann)
+	 *
+	 * Each plane is a sum or difference of two rows of the matrix, normalized
+	 * so plane distances are in world units. Expects OpenGL clip space
+	 * (-w <= z <= w), as produced by Mat4::perspective and Mat4::ortho.
+	 *
+	 * @param viewProjection Projection * view matrix
+	 */
+	explicit Frustum(const Mat4& viewProjection);
+
+	/**
+	 * @brief Creates a frustum from explicit planes
+	 * @param planes The six planes, in Left, Right, Bottom, Top, Near, Far order
+	 * @note Planes are used as given; normalize them for exact sphere tests
+	 */
+	explicit Frustum(const Vec4 planes[PlaneCount]);
+
+	/// Returns true if the point is inside or on every plane
+	bool contains(const Vec3& point) const;
+
+	/// Returns true unless the box is entirely behind a plane
+	bool intersects(const AABB& box) const;
+
+	/// Returns true unless the sphere is entirely behind a plane
+	bool intersects(const Sphere& sphere) const;
+
+	/**
+	 * @brief Classifies a box, testing only the planes in a mask
+	 *
+	 * Tests the corner furthest along each plane normal to reject the box,
+	 * and the nearest corner to find planes the box is entirely inside of.
+	 *
+	 * @param box The box to classify
+	 * @param[in,out] planeMask Planes to test; on return, those the box straddles
+	 *                (left unspecified if the box is outside)
+	 * @return Outside, Intersecting, or Inside when no straddled plane is left
+	 */
+	Classification classify(const AABB& box, uint32_t& planeMask) const;
+
+	/// Classifies a sphere, testing only the planes in a mask (as for boxes)
+	Classification classify(const Sphere& sphere, uint32_t& planeMask) const;
+
+	/// Classifies a box against every plane
+	Classification classify(const AABB& box) const;
+
+	/// Classifies a sphere against every plane
+	Classification classify(const Sphere& sphere) const;
+};
@@ -0,0 +1,172 @@
+/**
+ * @file LooseOctree.hpp
+ * @brief Loose octree container for boxes and spheres in large, sparse worlds
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+#include "BVH.hpp"
+#include "Frustum.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Octree whose nodes overlap their neighbours by half a cell on every side
+ *
+ * A node at depth d covers a cubic cell of the world, enlarged to twice its
+ * size (looseness factor 2). Any object no larger than a cell then fits in the
+ * node whose cell contains its center, so the insertion depth follows directly
+ * from the object's size and the node from its center: nothing is ever split
+ * or pushed down, and moving an object only touches the two nodes involved.
+ *
+ * Nodes are taken from a pool when the first object reaches them and returned
+ * when their subtree empties, so memory follows the occupied parts of the
+ * world. Objects outside the world bounds, or larger than the world, are kept
+ * at the root and tested by every query.
+ */
+class LooseOctree {
+public:
+	static constexpr uint32_t NullObject = 0xFFFFFFFFu;  ///< Returned for "no object"
+	static constexpr uint32_t MaxDepthLimit = 16;        ///< Deepest level that can be requested
+
+	/**
+	 * @brief Creates an empty octree
+	 * @param worldBounds Region the octree subdivides; extended to a cube on its largest side
+	 * @param maxDepth Deepest level (0 is the root), at most MaxDepthLimit
+	 */
+	explicit LooseOctree(const AABB& worldBounds, uint32_t maxDepth = 8);
+
+	/// Adds a box; returns its object id, stable until it is removed
+	uint32_t insert(const AABB& bounds);
+
+	/// Adds a sphere; queries test the sphere itself rather than its box
+	uint32_t insert(const Sphere& sphere);
+
+	/// Removes an object; its id may be reused by a later insertion
+	void remove(uint32_t object);
+
+	/// Moves an object, replacing its shape with a box but keeping its id
+	void update(uint32_t object, const AABB& bounds);
+
+	/// Moves an object, replacing its shape with a sphere but keeping its id
+	void update(uint32_t object, const Sphere& sphere);
+
+	/// Removes every object and node
+	void clear();
+
+	/// Returns the number of objects
+	size_t size() const;
+
+	/// Returns the number of allocated nodes (including the root)
+	size_t getNodeCount() const;
+
+	/// Returns the depth of the node holding an object
+	uint32_t getObjectDepth(uint32_t object) const;
+
+	/// Returns the bounding box of an object
+	const AABB& getBounds(uint32_t object) const;
+
+	/**
+	 * @brief Finds every object that overlaps a box
+	 * @param box Query box
+	 * @param[out] results Receives the object ids (unordered)
+	 */
+	void queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Finds every object that is not fully outside a frustum
+	 *
+	 * Planes are (normal, distance) with inside points satisfying
+	 * dot(normal, point) + distance >= 0. The test is conservative: objects
+	 * near frustum corners may be reported even though they are just outside.
+	 *
+	 * @param planes The six frustum planes
+	 * @param[out] results Receives the object ids (unordered)
+	 */
+	void queryFrustum(const Vec4 planes[6], std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Finds every object that is not fully outside a frustum (as Frustum::intersects)
+	 *
+	 * Nodes pass the planes their bounds straddle down to their children, so
+	 * deeper nodes test fewer planes, and objects below a node that is
+	 * entirely inside the frustum are reported without any tests.
+	 *
+	 * @param frustum The frustum to test
+	 * @param[out] results Receives the object ids (unordered)
+	 */
+	void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Finds the closest object hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit (index is the object id)
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any object is hit within maxDistance
+	 * @note Equal distances go to the lower object id, whatever the tree shape
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/// Octree node; children are allocated on demand
+	struct Node {
+		AABB bounds;           ///< Loose bounds (twice the cell size)
+		uint32_t children[8];  ///< Child nodes by octant (NullObject if absent)
+		uint32_t parent;       ///< Parent node, or next free node while on the free list
+		uint32_t firstObject;  ///< Head of the node's object list
+		uint32_t objectCount;  ///< Objects in this node and all its descendants
+		uint16_t cell[3];      ///< Cell coordinates at this depth
+		uint8_t octant;        ///< Index in the parent's children
+		uint8_t depth;         ///< Depth below the root
+	};
+
+	/// Stored object, linked into its node's list
+	struct Object {
+		AABB bounds;     ///< Bounding box (of the sphere, for sphere objects)
+		Sphere sphere;   ///< Sphere shape, if isSphere
+		uint32_t node;   ///< Node holding the object (NullObject while free)
+		uint32_t prev;   ///< Previous object in the node list
+		uint32_t next;   ///< Next object in the node list, or next free object
+		bool isSphere;   ///< Whether queries test the sphere rather than the box
+	};
+
+	std::vector<Node> nodes;       ///< Node pool; node 0 is the root
+	std::vector<Object> objects;   ///< Object pool, indexed by id
+	uint32_t freeNodes;            ///< First free node
+	uint32_t freeObjects;          ///< First free object
+	size_t nodeCount;              ///< Nodes in use
+	size_t objectCount;            ///< Objects in use
+	Vec3 worldMin;                 ///< Minimum corner of the world cube
+	float worldSize;               ///< Edge length of the world cube
+	uint32_t maxDepth;
+
+	/// Takes an object slot from the free list
+	uint32_t allocateObject();
+
+	/// Creates an empty child node for a cell at the given depth
+	uint32_t allocateNode(uint32_t parent, uint32_t octant, uint32_t depth, const uint32_t cell[3]);
+
+	/// Picks the depth from the size of a box and the cell at that depth from its center
+	void locate(const AABB& bounds, uint32_t& depth, uint32_t cell[3]) const;
+
+	/// Links an object into the node for a cell, creating nodes on the way
+	void link(uint32_t object, uint32_t depth, const uint32_t cell[3]);
+
+	/// Moves an object to new bounds, relinking it only if its node changes
+	void relocate(uint32_t object, const AABB& bounds);
+
+	/// Unlinks an object from its node, freeing nodes whose subtree empties
+	void unlink(uint32_t object);
+
+	/// Tests an object against a ray
+	bool intersectObject(const Ray& ray, const Object& object, float& distance) const;
+
+	/// Walks nodes that pass nodeTest and reports objects that pass objectTest
+	template<typename NodeTest, typename ObjectTest>
+	void collect(const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector<uint32_t>& results) const;
+};
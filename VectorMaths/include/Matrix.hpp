@@ -238,6 +238,15 @@ public:
 	/// Returns the inverse of this matrix
 	Mat4 inverse() const;
 
+	/**
+	 * @brief Returns the inverse of an affine matrix (bottom row 0, 0, 0, 1)
+	 *
+	 * Inverts only the upper 3x3 block and applies it to the negated
+	 * translation, which is far cheaper than the general cofactor inverse.
+	 * Suitable for transform matrices; returns identity if not invertible.
+	 */
+	Mat4 affineInverse() const;
+
 	/// Returns the transpose of this matrix
 	Mat4 transpose() const;
 
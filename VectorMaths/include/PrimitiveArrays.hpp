@@ -0,0 +1,258 @@
+/**
+ * @file PrimitiveArrays.hpp
+ * @brief Structure-of-arrays primitive sets with SIMD one-versus-many tests
+ *
+ * Narrowphase after a broadphase usually tests one ray or query shape against
+ * hundreds or thousands of candidates. Storing each component in its own
+ * array lets one SIMD instruction test four primitives at once.
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Frustum;
+
+/**
+ * @brief Spheres stored component-wise
+ *
+ * Hits match rayIntersectsSphere exactly, including its distances. Ties
+ * between spheres at the same distance go to the lower index.
+ */
+class SphereArray {
+public:
+	/// Creates an empty array
+	SphereArray();
+
+	/**
+	 * @brief Creates an array holding copies of spheres
+	 * @param spheres Spheres to copy; queries refer to them by index
+	 * @param count Number of spheres
+	 */
+	SphereArray(const Sphere* spheres, size_t count);
+
+	/// Replaces the contents with copies of spheres
+	void assign(const Sphere* spheres, size_t count);
+
+	/// Appends a sphere; its index is the previous size()
+	void add(const Sphere& sphere);
+
+	/// Replaces the sphere at an index
+	void set(size_t index, const Sphere& sphere);
+
+	/// Returns the sphere at an index
+	Sphere get(size_t index) const;
+
+	/// Removes every sphere
+	void clear();
+
+	/// Returns the number of spheres
+	size_t size() const;
+
+	/**
+	 * @brief Finds the closest sphere hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit if one is found
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any sphere is hit within maxDistance
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds every sphere hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if sphere i is hit
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return Number of spheres hit
+	 */
+	size_t raycastMask(const Ray& ray, std::vector<uint32_t>& mask,
+		float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Culls the spheres against a frustum (as Frustum::intersects)
+	 * @param frustum The frustum to test
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if sphere i is visible
+	 * @return Number of visible spheres
+	 */
+	size_t frustumMask(const Frustum& frustum, std::vector<uint32_t>& mask) const;
+
+private:
+	// Each array is padded to a multiple of four with zeros
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	size_t count;
+};
+
+/**
+ * @brief Axis-aligned boxes stored component-wise
+ *
+ * Hits match rayIntersectsAABB exactly, including its distances. Ties
+ * between boxes at the same distance go to the lower index. Overlap queries
+ * match aabbIntersectsAABB, sphereIntersectsAABB and pointInAABB, and come
+ * back either as a bitmask or as a list of indices.
+ */
+class AABBArray {
+public:
+	/// Creates an empty array
+	AABBArray();
+
+	/**
+	 * @brief Creates an array holding copies of boxes
+	 * @param boxes Boxes to copy; queries refer to them by index
+	 * @param count Number of boxes
+	 */
+	AABBArray(const AABB* boxes, size_t count);
+
+	/// Replaces the contents with copies of boxes
+	void assign(const AABB* boxes, size_t count);
+
+	/// Appends a box; its index is the previous size()
+	void add(const AABB& box);
+
+	/// Replaces the box at an index
+	void set(size_t index, const AABB& box);
+
+	/// Returns the box at an index
+	AABB get(size_t index) const;
+
+	/// Removes every box
+	void clear();
+
+	/// Returns the number of boxes
+	size_t size() const;
+
+	/**
+	 * @brief Finds the closest box hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit if one is found
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any box is hit within maxDistance
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds every box hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if box i is hit
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return Number of boxes hit
+	 */
+	size_t raycastMask(const Ray& ray, std::vector<uint32_t>& mask,
+		float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds every box overlapping a query box
+	 * @param box Query box
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if box i overlaps
+	 * @return Number of overlapping boxes
+	 */
+	size_t overlapMask(const AABB& box, std::vector<uint32_t>& mask) const;
+
+	/// Sets a bit for every box overlapping a sphere (layout as above); returns the number set
+	size_t overlapMask(const Sphere& sphere, std::vector<uint32_t>& mask) const;
+
+	/// Sets a bit for every box containing a point, surface included (layout as above); returns the number set
+	size_t containingMask(const Vec3& point, std::vector<uint32_t>& mask) const;
+
+	/**
+	 * @brief Finds every box overlapping a query box
+	 * @param box Query box
+	 * @param[out] results Receives the indices of the overlapping boxes in increasing order
+	 */
+	void queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const;
+
+	/// Collects the indices of the boxes overlapping a sphere in increasing order
+	void queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const;
+
+	/// Collects the indices of the boxes containing a point in increasing order
+	void queryContaining(const Vec3& point, std::vector<uint32_t>& results) const;
+
+	/**
+	 * @brief Culls the boxes against a frustum (as Frustum::intersects)
+	 * @param frustum The frustum to test
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if box i is visible
+	 * @return Number of visible boxes
+	 */
+	size_t frustumMask(const Frustum& frustum, std::vector<uint32_t>& mask) const;
+
+private:
+	// Each array is padded to a multiple of four with zeros
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+	size_t count;
+};
+
+/**
+ * @brief Planes, each a normal and a point on it, stored component-wise
+ *
+ * Hits match rayIntersectsPlane exactly, including its distances. Ties
+ * between planes at the same distance go to the lower index.
+ */
+class PlaneArray {
+public:
+	/// Creates an empty array
+	PlaneArray();
+
+	/**
+	 * @brief Appends a plane; its index is the previous size()
+	 * @param normal Normal vector of the plane (should be normalized)
+	 * @param point Any point on the plane
+	 */
+	void add(const Vec3& normal, const Vec3& point);
+
+	/// Replaces the plane at an index
+	void set(size_t index, const Vec3& normal, const Vec3& point);
+
+	/// Returns the normal of the plane at an index
+	Vec3 getNormal(size_t index) const;
+
+	/// Returns the point stored for the plane at an index
+	Vec3 getPoint(size_t index) const;
+
+	/// Removes every plane
+	void clear();
+
+	/// Returns the number of planes
+	size_t size() const;
+
+	/**
+	 * @brief Finds the closest plane hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit if one is found
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any plane is hit within maxDistance
+	 */
+	bool raycast(const Ray& ray, RayHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds every plane hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] mask Resized to (size() + 31) / 32 words; bit i % 32 of word i / 32 is set if plane i is hit
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return Number of planes hit
+	 */
+	size_t raycastMask(const Ray& ray, std::vector<uint32_t>& mask,
+		float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	// Each array is padded to a multiple of four with zeros
+	std::vector<float> normalX;
+	std::vector<float> normalY;
+	std::vector<float> normalZ;
+	std::vector<float> pointX;
+	std::vector<float> pointY;
+	std::vector<float> pointZ;
+	size_t count;
+};
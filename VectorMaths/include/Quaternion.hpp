@@ -174,4 +174,18 @@ public:
      * @return Interpolated quaternion with constant angular velocity
      */
     static Quaternion slerp(const Quaternion& a, Quaternion b, float t);
+
+    /**
+     * @brief Normalized linear interpolation between two quaternions
+     *
+     * Much cheaper than slerp and follows the same path, but with slightly
+     * non-uniform angular velocity. Well suited to small steps such as
+     * interpolating between consecutive simulation frames.
+     *
+     * @param a Start quaternion
+     * @param b End quaternion
+     * @param t Interpolation parameter (0 = a, 1 = b)
+     * @return Normalized interpolated quaternion along the shortest path
+     */
+    static Quaternion nlerp(const Quaternion& a, Quaternion b, float t);
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file RayPacket.hpp
+ * @brief Groups of rays traced together with SIMD slab tests
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Four rays stored component-wise for SIMD traversal
+ *
+ * Coherent rays (picking around a cursor, shadow rays towards one light,
+ * sensor sweeps) mostly visit the same nodes, so testing them together shares
+ * each node fetch between four rays. Lanes without a ray are inactive and
+ * never report hits.
+ *
+ * Each lane computes exactly what the single-ray functions compute for the
+ * same Ray, so packet and single-ray queries return identical hits.
+ */
+struct RayPacket {
+	static constexpr uint32_t Width = 4;                     ///< Rays per packet (one SSE register)
+	static constexpr uint32_t FullMask = (1u << Width) - 1;  ///< Mask with every lane set
+
+	alignas(16) float originX[Width];     ///< Ray origins, x components
+	alignas(16) float originY[Width];     ///< Ray origins, y components
+	alignas(16) float originZ[Width];     ///< Ray origins, z components
+	alignas(16) float directionX[Width];  ///< Ray directions, x components
+	alignas(16) float directionY[Width];  ///< Ray directions, y components
+	alignas(16) float directionZ[Width];  ///< Ray directions, z components
+	alignas(16) float inverseX[Width];    ///< Cached Ray::getInverseDirection(), x components
+	alignas(16) float inverseY[Width];    ///< Cached Ray::getInverseDirection(), y components
+	alignas(16) float inverseZ[Width];    ///< Cached Ray::getInverseDirection(), z components
+	uint32_t activeMask;                  ///< Bit i is set if lane i holds a ray
+
+	/// Creates a packet with every lane inactive
+	RayPacket();
+
+	/**
+	 * @brief Creates a packet from consecutive rays
+	 * @param rays Rays to copy
+	 * @param count Number of rays (at most Width); later lanes stay inactive
+	 */
+	RayPacket(const Ray* rays, size_t count);
+
+	/// Stores a ray in a lane and marks the lane active
+	void setRay(uint32_t lane, const Ray& ray);
+
+	/// Returns the ray stored in a lane (exactly as it was set)
+	Ray getRay(uint32_t lane) const;
+};
+
+/**
+ * @brief Tests every ray of a packet against an AABB
+ * @param packet The rays to test
+ * @param box The AABB to test against
+ * @param[out] distances Set, for each lane that hits, to what rayIntersectsAABB returns
+ * @return Mask of the active lanes that hit the box
+ */
+uint32_t rayPacketIntersectsAABB(const RayPacket& packet, const AABB& box, float distances[RayPacket::Width]);
+
+/**
+ * @brief Finds the closest box hit by each ray of a packet
+ *
+ * Ties between boxes at the same distance go to the lower index.
+ *
+ * @param packet The rays to cast
+ * @param boxes Array of boxes
+ * @param count Number of boxes
+ * @param[out] hits Set, for each lane that hits, to the closest box
+ * @param maxDistance Hits further along the rays are ignored
+ * @return Mask of the active lanes that hit any box within maxDistance
+ */
+uint32_t raycastPacket(const RayPacket& packet, const AABB* boxes, size_t count, RayHit hits[RayPacket::Width],
+	float maxDistance = std::numeric_limits<float>::infinity());
+
+/**
+ * @brief Finds the closest sphere hit by each ray of a packet
+ *
+ * Sphere tests run per active lane through rayIntersectsSphere. Ties go to
+ * the lower index.
+ *
+ * @param packet The rays to cast
+ * @param spheres Array of spheres
+ * @param count Number of spheres
+ * @param[out] hits Set, for each lane that hits, to the closest sphere
+ * @param maxDistance Hits further along the rays are ignored
+ * @return Mask of the active lanes that hit any sphere within maxDistance
+ */
+uint32_t raycastPacket(const RayPacket& packet, const Sphere* spheres, size_t count, RayHit hits[RayPacket::Width],
+	float maxDistance = std::numeric_limits<float>::infinity());
@@ -0,0 +1,95 @@
+/**
+ * @file SpatialHashGrid.hpp
+ * @brief Hashed uniform grid broadphase for spheres of similar size
+ */
+
+#pragma once
+
+#include "Collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Uniform grid over sphere centers, stored in a hash table of cells
+ *
+ * The grid is rebuilt from scratch each frame. Sphere centers are hashed by
+ * their integer cell coordinates and counting-sorted into one contiguous array
+ * per hash bucket, so a build is two linear passes with no per-cell
+ * allocation. Only occupied cells cost memory, and the grid has no bounds.
+ *
+ * Works best when the cell size is about the diameter of the largest sphere:
+ * then each sphere only needs to be tested against its own and the
+ * neighbouring cells. Larger spheres still give correct results but search
+ * more cells.
+ */
+class SpatialHashGrid {
+public:
+	/**
+	 * @brief Creates an empty grid
+	 * @param cellSize Edge length of a grid cell (must be positive)
+	 */
+	explicit SpatialHashGrid(float cellSize = 1.0f);
+
+	/// Sets the edge length of a grid cell; takes effect on the next build
+	void setCellSize(float cellSize);
+
+	/// Returns the edge length of a grid cell
+	float getCellSize() const;
+
+	/**
+	 * @brief Rebuilds the grid over a set of spheres
+	 * @param spheres Spheres to insert; results refer to them by index
+	 * @param count Number of spheres
+	 */
+	void build(const Sphere* spheres, size_t count);
+
+	/// Removes every sphere
+	void clear();
+
+	/// Returns the number of spheres in the grid
+	size_t size() const;
+
+	/**
+	 * @brief Finds every pair of spheres that intersect (as sphereIntersectsSphere)
+	 * @param[out] pairs Receives each pair once, with the smaller index first
+	 */
+	void queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+
+	/**
+	 * @brief Finds every sphere that intersects a query sphere
+	 * @param sphere Query sphere
+	 * @param[out] results Receives the sphere indices (unordered)
+	 */
+	void queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const;
+
+private:
+	/// Sphere copied into bucket order
+	struct Entry {
+		float x, y, z;
+		float radius;
+	};
+
+	/// Integer cell coordinates
+	struct Cell {
+		int32_t x, y, z;
+	};
+
+	std::vector<uint32_t> bucketStart;  ///< First entry of each bucket; one extra element marks the end
+	std::vector<Entry> entries;         ///< Spheres sorted by bucket
+	std::vector<Cell> cells;            ///< Cell of each entry
+	std::vector<uint32_t> indices;      ///< Original sphere index of each entry
+	std::vector<uint32_t> entryBucket;  ///< Scratch: bucket of each input sphere during a build
+	float cellSize;
+	float inverseCellSize;
+	float maxRadius;                    ///< Largest radius in the grid
+	uint32_t bucketMask;                ///< Bucket count - 1 (the count is a power of two)
+
+	/// Returns the cell containing a coordinate
+	Cell cellOf(float x, float y, float z) const;
+
+	/// Returns the bucket a cell hashes to
+	uint32_t bucketOf(const Cell& cell) const;
+};
@@ -0,0 +1,117 @@
+/**
+ * @file SweepAndPrune.hpp
+ * @brief Sort-and-sweep broadphase with persistent overlapping pairs
+ */
+
+#pragma once
+
+#include "Collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Broadphase that finds overlapping boxes by sorting them along one axis
+ *
+ * Boxes are kept sorted by their minimum on the sweep axis. Each update
+ * re-sorts with insertion sort, which is close to O(n) when objects move a
+ * little between frames, then sweeps the list: a box can only overlap the
+ * boxes that start before it ends. The overlapping pairs are kept between
+ * updates so callers can react to pairs that start or stop overlapping.
+ *
+ * By default the sweep axis is the one along which box centers vary most,
+ * which keeps the number of boxes overlapping on that axis low. Changing axis
+ * costs a full sort, so the axis only changes once another axis varies
+ * AxisSwitchRatio times more than the current one.
+ */
+class SweepAndPrune {
+public:
+	typedef std::pair<uint32_t, uint32_t> Pair;  ///< Proxy pair, smaller id first
+
+	static constexpr uint32_t NullProxy = 0xFFFFFFFFu;  ///< Returned for "no proxy"
+	static constexpr int AutoAxis = -1;                 ///< Pick the axis by variance on every update
+	static constexpr double AxisSwitchRatio = 1.2;      ///< Variance ratio another axis needs to replace the current one
+
+	/**
+	 * @brief Creates an empty broadphase
+	 * @param axis Fixed sweep axis (0 = x, 1 = y, 2 = z) or AutoAxis
+	 */
+	explicit SweepAndPrune(int axis = AutoAxis);
+
+	/**
+	 * @brief Adds a box; its pairs are reported by the next update
+	 * @return Proxy id, stable until the proxy is destroyed
+	 */
+	uint32_t createProxy(const AABB& bounds);
+
+	/// Removes a box; its pairs are reported as removed by the next update, after which the id may be reused
+	void destroyProxy(uint32_t proxy);
+
+	/// Sets the bounds of a box; takes effect on the next update
+	void moveProxy(uint32_t proxy, const AABB& bounds);
+
+	/// Returns the current bounds of a proxy
+	const AABB& getBounds(uint32_t proxy) const;
+
+	/**
+	 * @brief Re-sorts the boxes and recomputes the overlapping pairs
+	 *
+	 * After this call getPairs() holds every overlapping pair, and
+	 * getAddedPairs() / getRemovedPairs() hold the changes since the last update.
+	 */
+	void update();
+
+	/// Returns every overlapping pair found by the last update, sorted
+	const std::vector<Pair>& getPairs() const;
+
+	/// Returns the pairs that started overlapping in the last update, sorted
+	const std::vector<Pair>& getAddedPairs() const;
+
+	/// Returns the pairs that stopped overlapping (or lost a proxy) in the last update, sorted
+	const std::vector<Pair>& getRemovedPairs() const;
+
+	/// Fixes the sweep axis, or sets AutoAxis to pick it by variance
+	void setAxis(int axis);
+
+	/// Returns the axis used by the last update
+	int getAxis() const;
+
+	/// Removes every proxy and pair
+	void clear();
+
+	/// Returns the number of proxies
+	size_t size() const;
+
+private:
+	/// A box in sweep order, copied out of the proxy bounds for cache-friendly sweeps
+	struct Entry {
+		float min[3];
+		float max[3];
+		uint32_t proxy;
+	};
+
+	std::vector<AABB> bounds;          ///< Bounds of each proxy, indexed by id
+	std::vector<uint8_t> alive;        ///< 1 for live proxies, indexed by id
+	std::vector<uint32_t> freeIds;     ///< Ids that can be reused
+	std::vector<uint32_t> pendingFree; ///< Destroyed ids, reusable after the next update
+	std::vector<Entry> entries;        ///< Live proxies sorted by min on the sweep axis
+	std::vector<Pair> pairs;           ///< Current overlapping pairs, sorted
+	std::vector<Pair> added;           ///< Pairs added by the last update
+	std::vector<Pair> removed;         ///< Pairs removed by the last update
+	std::vector<Pair> scratch;         ///< Pairs found by the sweep in progress
+	size_t proxyCount;                 ///< Number of live proxies
+	size_t sortedCount;                ///< Entries sorted by the last update; the rest are new
+	int requestedAxis;                 ///< Fixed axis or AutoAxis
+	int axis;                          ///< Axis the entries are sorted on
+	bool entriesDirty;                 ///< Entries must drop destroyed proxies
+
+	/**
+	 * @brief Returns the axis with the largest variance of box centers
+	 *
+	 * While the entries hold a sorted order, the current axis is kept unless
+	 * another axis beats its variance by AxisSwitchRatio.
+	 */
+	int chooseAxis() const;
+};
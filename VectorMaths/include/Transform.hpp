@@ -12,6 +12,8 @@
 #include "Vector.hpp"
 #include "Quaternion.hpp"
 #include "Matrix.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 /**
@@ -21,7 +23,12 @@
  * parent-child relationships. Local and world matrices are cached and
  * only recalculated when the transform changes (lazy evaluation).
  *
- * @note Matrices are marked dirty when transform changes or parent hierarchy updates
+ * @note Mutations are O(1): they only flag this transform. Descendants detect a
+ *       changed ancestor lazily at query time by comparing world versions.
+ *       Queries are O(1) when no ancestor in the same hierarchy changed since
+ *       the last check; changes to leaves and to other hierarchies are never
+ *       seen. SetParent is O(subtree), as the moved subtree joins its new
+ *       hierarchy's counter.
  */
 class Transform {
 private:
@@ -34,7 +41,25 @@ private:
 
 	mutable Mat4 localMatrix;   ///< Cached local transformation matrix
 	mutable Mat4 worldMatrix;   ///< Cached world transformation matrix
-	mutable bool dirty;         ///< True if matrices need recalculation
+	mutable bool localDirty;    ///< True if localMatrix needs recalculation
+	mutable bool worldDirty;    ///< True if own local matrix or parent link changed
+	mutable uint32_t worldVersion;          ///< Bumped whenever worldMatrix is rebuilt
+	mutable uint32_t parentWorldVersion;    ///< Parent's worldVersion used for worldMatrix
+	mutable uint64_t validatedGeneration;   ///< Hierarchy generation worldMatrix was last checked at
+	mutable Mat4 inverseWorldMatrix;        ///< Cached inverse of worldMatrix
+	mutable uint32_t inverseWorldVersion;   ///< worldVersion inverseWorldMatrix was computed from
+
+	/// Incremented when a transform with children changes; shared by every transform under the same root
+	mutable std::shared_ptr<uint64_t> hierarchyGeneration;
+
+	/// Returns the hierarchy's generation counter, creating it on first use
+	const std::shared_ptr<uint64_t>& HierarchyGeneration() const;
+
+	/// Marks the world matrix of this transform as stale (descendants notice lazily)
+	void MarkWorldDirty();
+
+	/// Brings the cached world matrix of this transform and its ancestors up to date
+	void UpdateWorldMatrix() const;
 
 public:
 	/// Default constructor - creates identity transform at origin
@@ -48,6 +73,14 @@ public:
 	 */
 	Transform(const Vec3& position, const Quaternion& rotation, const Vec3& scale);
 
+	/**
+	 * @brief Builds a local matrix from position, rotation and scale
+	 *
+	 * Applies scale, then rotation, then translation. Shared with TransformSystem
+	 * so both paths produce identical matrices.
+	 */
+	static Mat4 ComposeMatrix(const Vec3& position, const Quaternion& rotation, const Vec3& scale);
+
 	// Accessors
 	/// Returns the local transformation matrix (relative to parent)
 	Mat4 GetLocalMatrix() const;
@@ -55,6 +88,9 @@ public:
 	/// Returns the world transformation matrix (in world space)
 	Mat4 GetWorldMatrix() const;
 
+	/// Returns the inverse world matrix (world space to local space), cached until the world matrix changes
+	Mat4 GetInverseWorldMatrix() const;
+
 	/// Returns the local position
 	Vec3 GetPosition() const;
 
@@ -80,8 +116,24 @@ public:
 	/// Sets the local scale (marks dirty)
 	void SetScale(const Vec3& newScale);
 
+	/// Sets the local position so that the transform's origin ends up at a world-space point (marks dirty)
+	void SetWorldPosition(const Vec3& worldPosition);
+
+	/**
+	 * @brief Sets the local rotation so that the world-space rotation matches
+	 * @param worldRotation Desired rotation in world space
+	 * @note The parent's world rotation is taken from its world matrix with
+	 *       scale removed, which is exact unless ancestors combine rotation
+	 *       with non-uniform scale
+	 */
+	void SetWorldRotation(const Quaternion& worldRotation);
+
 	/**
 	 * @brief Sets the parent transform
+	 *
+	 * Also registers this transform in the new parent's child list (and removes
+	 * it from the old parent's), so world matrix invalidation reaches it.
+	 *
 	 * @param newParent New parent (nullptr to detach)
 	 */
 	void SetParent(Transform* newParent);
@@ -99,7 +151,7 @@ public:
 	void RemoveChild(Transform* child);
 
 	// Utility Methods
-	/// Marks matrices as needing recalculation (propagates to children)
+	/// Marks matrices as needing recalculation (descendants update lazily)
 	void MarkDirty();
 
 	/// Adds to current position (marks dirty)
@@ -115,13 +167,49 @@ public:
 	 */
 	void LookAt(const Vec3& target, const Vec3& up);
 
+	// Space conversions
+	/// Transforms a point from world space into this transform's local space
+	Vec3 InverseTransformPoint(const Vec3& worldPoint) const;
+
+	/// Transforms a direction from world space into local space (ignores translation, includes scale)
+	Vec3 InverseTransformDirection(const Vec3& worldDirection) const;
+
 	// Transform directions
-	/// Returns the forward direction vector in world space
+	/// Returns the forward direction vector in world space (read from the cached world matrix)
 	Vec3 Forward() const;
 
-	/// Returns the right direction vector in world space
+	/// Returns the right direction vector in world space (read from the cached world matrix)
 	Vec3 Right() const;
 
-	/// Returns the up direction vector in world space
+	/// Returns the up direction vector in world space (read from the cached world matrix)
 	Vec3 Up() const;
+
+	/// Returns all three world-space direction vectors with a single world matrix lookup
+	void GetWorldBasis(Vec3& right, Vec3& up, Vec3& forward) const;
+
+	// Hierarchy traversal
+	/**
+	 * @brief Visits this transform and all of its descendants in pre-order
+	 *
+	 * Uses an explicit stack rather than recursion, so arbitrarily deep
+	 * hierarchies are safe to traverse.
+	 *
+	 * @param visitor Callable invoked as visitor(Transform&) for each node
+	 */
+	template<typename Visitor>
+	void VisitSubtree(Visitor&& visitor) {
+		std::vector<Transform*> stack;
+		stack.push_back(this);
+
+		while (!stack.empty()) {
+			Transform* node = stack.back();
+			stack.pop_back();
+			visitor(*node);
+
+			// Pushed in reverse so children are visited in insertion order
+			for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+				stack.push_back(*it);
+			}
+		}
+	}
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ * @file TransformFile.hpp
+ * @brief Binary, memory-mappable snapshots of a transform hierarchy
+ *
+ * Stores a whole TransformSystem as flat arrays (positions, rotations,
+ * scales, parent indices and optionally world matrices) that can be mapped
+ * into memory and copied straight into a TransformSystem, with no per-node
+ * parsing or hierarchy edits.
+ *
+ * File layout (little-endian, every section 16-byte aligned):
+ *   Header (64 bytes): magic, version, count, flags, section offsets
+ *   Vec3 positions[count]
+ *   Quaternion rotations[count]   (w, x, y, z)
+ *   Vec3 scales[count]
+ *   uint32_t parents[count]       (parent index, 0xFFFFFFFF for roots, always < own index)
+ *   Mat4 worldMatrices[count]     (only if HasWorldMatrices is set)
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Quaternion.hpp"
+#include "Matrix.hpp"
+#include "TransformSystem.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only, memory-mapped transform hierarchy file
+ *
+ * The arrays returned by the accessors point directly into the mapping and
+ * stay valid until the file is closed.
+ */
+class TransformFile {
+public:
+	static constexpr uint32_t Magic = 0x46544D56u;  ///< "VMTF" in file byte order
+	static constexpr uint32_t Version = 1;          ///< Current format version
+
+	/// Header flags
+	enum : uint32_t {
+		HasWorldMatrices = 1 << 0  ///< World matrices are stored after the parent indices
+	};
+
+	/**
+	 * @brief Writes every transform of a system to a file
+	 *
+	 * Brings world matrices up to date first, so the file is written in the
+	 * system's parent-before-child order.
+	 *
+	 * @param path File to create or overwrite
+	 * @param system Transforms to save
+	 * @param includeWorldMatrices Store baked world matrices so loading needs no update pass
+	 * @throws std::runtime_error if the file cannot be written
+	 */
+	static void Save(const std::string& path, TransformSystem& system, bool includeWorldMatrices = true);
+
+	/// Creates a closed file
+	TransformFile();
+
+	/// Maps a file (see Open)
+	explicit TransformFile(const std::string& path);
+
+	TransformFile(const TransformFile&) = delete;
+	TransformFile& operator=(const TransformFile&) = delete;
+
+	/// Unmaps the file
+	~TransformFile();
+
+	/**
+	 * @brief Maps a file into memory and validates its header and parent indices
+	 * @param path File to open
+	 * @throws std::runtime_error if the file cannot be mapped or is not a valid transform file
+	 */
+	void Open(const std::string& path);
+
+	/// Unmaps the file (no-op if not open)
+	void Close();
+
+	/// Returns true if a file is mapped
+	bool IsOpen() const;
+
+	/// Returns the number of transforms stored
+	uint32_t Size() const;
+
+	/// Returns the stored local positions
+	const Vec3* GetPositions() const;
+
+	/// Returns the stored local rotations
+	const Quaternion* GetRotations() const;
+
+	/// Returns the stored local scales
+	const Vec3* GetScales() const;
+
+	/// Returns the stored parent indices (TransformSystem::NoParent for roots)
+	const uint32_t* GetParentIndices() const;
+
+	/// Returns the stored world matrices (nullptr if the file has none)
+	const Mat4* GetWorldMatrices() const;
+
+	/**
+	 * @brief Replaces the contents of a system with the stored hierarchy
+	 * @param system System to load into
+	 * @param[out] outHandles Receives Size() handles in file order (may be nullptr)
+	 */
+	void LoadInto(TransformSystem& system, TransformHandle* outHandles = nullptr) const;
+
+private:
+	/// On-disk header, padded to 64 bytes
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t count;
+		uint32_t flags;
+		uint64_t positionsOffset;
+		uint64_t rotationsOffset;
+		uint64_t scalesOffset;
+		uint64_t parentsOffset;
+		uint64_t worldMatricesOffset;  ///< 0 if not stored
+		uint64_t reserved;
+	};
+
+	const unsigned char* data;  ///< Start of the mapping (nullptr if closed)
+	size_t size;                ///< Mapped size in bytes
+	const Header* header;       ///< Header at the start of the mapping
+	void* fileHandle;           ///< Platform file handle (Windows only)
+	void* mappingHandle;        ///< Platform mapping handle (Windows only)
+
+	/// Throws and unmaps if the mapped contents are not a valid transform file
+	void Validate();
+};
@@ -0,0 +1,136 @@
+/**
+ * @file TransformSnapshot.hpp
+ * @brief Immutable world matrix snapshots for concurrent readers
+ *
+ * Provides a triple-buffered snapshot mechanism: the simulation thread
+ * publishes the world matrices of a TransformSystem at a sync point, and
+ * any number of reader threads (rendering, audio, networking) read the
+ * latest published snapshot lock-free while the next frame is simulated.
+ */
+
+#pragma once
+
+#include "Matrix.hpp"
+#include "TransformSystem.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One published frame of world matrices
+ *
+ * Matrices are stored contiguously in hierarchy order (parents before
+ * children). The contents never change while a reader holds the snapshot.
+ */
+class TransformSnapshot {
+public:
+	/// Creates an empty snapshot
+	TransformSnapshot();
+
+	/// Returns the frame number assigned when the snapshot was published
+	uint64_t GetFrame() const;
+
+	/// Returns the number of transforms in the snapshot
+	size_t Size() const;
+
+	/// Returns the contiguous world matrix array
+	const Mat4* GetWorldMatrices() const;
+
+	/// Returns the handle of each entry in the world matrix array
+	const TransformHandle* GetHandles() const;
+
+	/**
+	 * @brief Looks up the world matrix of a transform
+	 * @param handle Transform to look up
+	 * @param[out] worldMatrix Set to the transform's world matrix if found
+	 * @return true if the transform existed when the snapshot was published
+	 */
+	bool TryGetWorldMatrix(TransformHandle handle, Mat4& worldMatrix) const;
+
+private:
+	friend class TransformSnapshotBuffer;
+
+	uint64_t frame;                       ///< Publish counter
+	std::vector<Mat4> worldMatrices;      ///< World matrices in hierarchy order
+	std::vector<TransformHandle> handles; ///< Handle of each entry
+	std::vector<uint32_t> idToIndex;      ///< Handle id -> entry index
+};
+
+class TransformSnapshotBuffer;
+
+/**
+ * @brief Read access to a published snapshot
+ *
+ * Keeps the snapshot alive (it will not be overwritten) until destroyed.
+ * Hold it for the duration of a frame at most, otherwise the writer has to
+ * wait for a free buffer.
+ */
+class TransformSnapshotView {
+public:
+	/// Creates an empty view
+	TransformSnapshotView();
+
+	TransformSnapshotView(TransformSnapshotView&& other) noexcept;
+	TransformSnapshotView& operator=(TransformSnapshotView&& other) noexcept;
+	TransformSnapshotView(const TransformSnapshotView&) = delete;
+	TransformSnapshotView& operator=(const TransformSnapshotView&) = delete;
+
+	/// Releases the snapshot
+	~TransformSnapshotView();
+
+	/// Returns true if a snapshot was available when the view was acquired
+	bool IsValid() const { return snapshot != nullptr; }
+
+	const TransformSnapshot& operator*() const { return *snapshot; }
+	const TransformSnapshot* operator->() const { return snapshot; }
+
+private:
+	friend class TransformSnapshotBuffer;
+
+	TransformSnapshotView(const TransformSnapshot* snapshot, std::atomic<uint32_t>* readerCount);
+
+	const TransformSnapshot* snapshot;      ///< Snapshot being read (nullptr if empty)
+	std::atomic<uint32_t>* readerCount;     ///< Reader count released on destruction
+};
+
+/**
+ * @brief Triple buffer of world matrix snapshots
+ *
+ * Publish() must be called from a single writer thread. Acquire() may be
+ * called from any number of threads at the same time and never blocks; a
+ * reader sees either the previous or the newly published snapshot, never a
+ * partially written one.
+ */
+class TransformSnapshotBuffer {
+public:
+	static constexpr uint32_t BufferCount = 3;  ///< Published, being read, being written
+
+	/// Creates a buffer with no published snapshot
+	TransformSnapshotBuffer();
+
+	TransformSnapshotBuffer(const TransformSnapshotBuffer&) = delete;
+	TransformSnapshotBuffer& operator=(const TransformSnapshotBuffer&) = delete;
+
+	/**
+	 * @brief Brings the system's world matrices up to date and publishes them
+	 *
+	 * Copies into a buffer no reader is using, then makes it the latest
+	 * snapshot. Waits only if readers still hold both older snapshots.
+	 *
+	 * @param system Transform system to snapshot (writer thread only)
+	 */
+	void Publish(TransformSystem& system);
+
+	/// Acquires the latest published snapshot (lock-free, any thread)
+	TransformSnapshotView Acquire() const;
+
+private:
+	static constexpr uint32_t NoSnapshot = 0xFFFFFFFFu;
+
+	TransformSnapshot snapshots[BufferCount];                 ///< Snapshot storage
+	mutable std::atomic<uint32_t> readerCounts[BufferCount];  ///< Active readers per buffer
+	std::atomic<uint32_t> published;                          ///< Latest complete buffer
+	uint64_t frameCounter;                                    ///< Number of publishes so far
+};
@@ -0,0 +1,514 @@
+/**
+ * @file TransformSystem.hpp
+ * @brief Flat, contiguous storage for large transform hierarchies
+ *
+ * Provides a transform store that keeps position, rotation, scale, parent
+ * indices and cached matrices in contiguous arrays sorted so that every
+ * parent comes before its children. World matrices for the whole hierarchy
+ * can then be computed in a single forward pass over the arrays.
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Quaternion.hpp"
+#include "Matrix.hpp"
+#include "Collision.hpp"
+#include "Frustum.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Generational handle to a transform owned by a TransformSystem
+ *
+ * Handles stay valid when the system reorders its internal arrays. Slots are
+ * reused after a transform is destroyed; the generation distinguishes the new
+ * occupant from stale handles (see TransformSystem::IsAlive).
+ */
+struct TransformHandle {
+	static constexpr uint32_t InvalidId = 0xFFFFFFFFu;
+
+	uint32_t id = InvalidId;   ///< Slot index inside the owning system
+	uint32_t generation = 0;   ///< Slot generation the handle was issued for
+
+	/// Returns true if the handle refers to a transform (which may since have been destroyed)
+	bool IsValid() const { return id != InvalidId; }
+
+	bool operator==(const TransformHandle& other) const {
+		return id == other.id && generation == other.generation;
+	}
+
+	bool operator!=(const TransformHandle& other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * @brief Data-oriented store for a transform hierarchy
+ *
+ * Mirrors the Transform API, with a handle as the first argument. Matrix
+ * queries are lazy and always return up-to-date results, exactly like
+ * Transform. For bulk work, call UpdateWorldMatrices() once per frame and
+ * read the contiguous world matrix array directly.
+ *
+ * Internally the arrays are sorted by hierarchy depth (roots first). The
+ * order is restored lazily by the next UpdateWorldMatrices() after a
+ * structural change, so dense indices are only stable between updates.
+ *
+ * Storage is pooled: slots of destroyed transforms are recycled, children are
+ * kept in intrusive linked lists, and Reserve/CreateBatch/Clear let a whole
+ * scene be set up and torn down with a handful of allocations.
+ *
+ * Transforms may carry a local bounding box. The world-space bounds of every
+ * subtree are refit incrementally: only transforms whose world matrix or
+ * bounds changed, and their ancestors, are touched.
+ *
+ * @note Mutating a transform is O(1): only that transform is flagged. Stale
+ *       descendants are detected through per-transform world versions.
+ * @note The system owns the worker threads of UpdateWorldMatricesParallel(),
+ *       so it can be moved but not copied.
+ */
+class TransformSystem {
+public:
+	static constexpr uint32_t NoParent = 0xFFFFFFFFu;  ///< Parent index of root transforms
+	static constexpr uint32_t ParallelGrain = 512;     ///< Transforms per parallel work chunk
+
+	/// Creates an empty system
+	TransformSystem();
+
+	/// Stops and joins the parallel update's worker threads
+	~TransformSystem();
+
+	TransformSystem(TransformSystem&& other) noexcept;
+	TransformSystem& operator=(TransformSystem&& other) noexcept;
+	TransformSystem(const TransformSystem&) = delete;
+	TransformSystem& operator=(const TransformSystem&) = delete;
+
+	/// Reserves storage for the given number of transforms
+	void Reserve(size_t count);
+
+	/// Returns the number of transforms in the system
+	size_t Size() const;
+
+	/// Returns true if the handle refers to a transform that has not been destroyed
+	bool IsAlive(TransformHandle handle) const;
+
+	/// Creates an identity transform at the origin with no parent
+	TransformHandle Create();
+
+	/**
+	 * @brief Creates a root transform with given position, rotation, and scale
+	 * @param position Local position
+	 * @param rotation Local rotation
+	 * @param scale Local scale
+	 * @return Handle to the new transform
+	 */
+	TransformHandle Create(const Vec3& position, const Quaternion& rotation, const Vec3& scale);
+
+	/**
+	 * @brief Creates many transforms at once
+	 *
+	 * Any of the input arrays may be nullptr to use defaults (identity
+	 * transform, no parent). Parents are given as indices into this batch and
+	 * may appear after their children.
+	 *
+	 * @param count Number of transforms to create
+	 * @param parentIndices Parent of each transform as a batch index (NoParent for roots)
+	 * @param positions Local positions
+	 * @param rotations Local rotations
+	 * @param scales Local scales
+	 * @param[out] outHandles Receives count handles (may be nullptr)
+	 */
+	void CreateBatch(size_t count, const uint32_t* parentIndices, const Vec3* positions,
+		const Quaternion* rotations, const Vec3* scales, TransformHandle* outHandles);
+
+	/**
+	 * @brief Replaces the whole contents of the system with the given hierarchy
+	 *
+	 * Fills the internal arrays by bulk copy instead of creating and
+	 * parenting transforms one at a time. When parents precede their
+	 * children and the input is sorted by depth (as written by
+	 * TransformFile::Save), no reordering is needed. With world matrices
+	 * supplied, the first update has nothing to recompute.
+	 *
+	 * @param count Number of transforms
+	 * @param parentIndices Parent of each transform as an input index (NoParent for roots)
+	 * @param positions Local positions
+	 * @param rotations Local rotations
+	 * @param scales Local scales
+	 * @param worldMatrices Matching world matrices (nullptr to compute them on the next update)
+	 * @param[out] outHandles Receives count handles in input order (may be nullptr)
+	 */
+	void LoadHierarchy(size_t count, const uint32_t* parentIndices, const Vec3* positions,
+		const Quaternion* rotations, const Vec3* scales, const Mat4* worldMatrices, TransformHandle* outHandles);
+
+	/**
+	 * @brief Destroys a transform together with all of its descendants
+	 * @note Compacts the arrays in O(n); prefer DestroyBatch for many transforms
+	 */
+	void Destroy(TransformHandle handle);
+
+	/// Destroys several transforms and their descendants with a single compaction
+	void DestroyBatch(const TransformHandle* handles, size_t count);
+
+	/// Destroys every transform, keeping allocated storage for reuse
+	void Clear();
+
+	// Accessors
+	/// Returns the local transformation matrix (relative to parent)
+	Mat4 GetLocalMatrix(TransformHandle handle) const;
+
+	/// Returns the world transformation matrix (in world space)
+	Mat4 GetWorldMatrix(TransformHandle handle) const;
+
+	/// Returns the local position
+	Vec3 GetPosition(TransformHandle handle) const;
+
+	/// Returns the local rotation
+	Quaternion GetRotation(TransformHandle handle) const;
+
+	/// Returns the local scale
+	Vec3 GetScale(TransformHandle handle) const;
+
+	/// Returns the parent handle (invalid handle if root)
+	TransformHandle GetParent(TransformHandle handle) const;
+
+	/// Returns the first child (invalid handle if none)
+	TransformHandle GetFirstChild(TransformHandle handle) const;
+
+	/// Returns the next sibling in the parent's child list (invalid handle if last)
+	TransformHandle GetNextSibling(TransformHandle handle) const;
+
+	/// Returns the handles of all direct children, in insertion order
+	std::vector<TransformHandle> GetChildren(TransformHandle handle) const;
+
+	// Transform directions
+	/// Returns the forward direction vector in world space
+	Vec3 Forward(TransformHandle handle) const;
+
+	/// Returns the right direction vector in world space
+	Vec3 Right(TransformHandle handle) const;
+
+	/// Returns the up direction vector in world space
+	Vec3 Up(TransformHandle handle) const;
+
+	/**
+	 * @brief Returns the world-space direction vectors of many transforms
+	 *
+	 * Reads the normalized columns of each cached world matrix, bringing
+	 * stale matrices up to date first.
+	 *
+	 * @param handles Transforms to query
+	 * @param count Number of handles
+	 * @param[out] rights Receives right vectors (may be nullptr)
+	 * @param[out] ups Receives up vectors (may be nullptr)
+	 * @param[out] forwards Receives forward vectors (may be nullptr)
+	 */
+	void GetWorldBasis(const TransformHandle* handles, size_t count, Vec3* rights, Vec3* ups, Vec3* forwards) const;
+
+	// Mutators
+	/// Sets the local position (marks dirty)
+	void SetPosition(TransformHandle handle, const Vec3& newPosition);
+
+	/// Sets the local rotation (marks dirty)
+	void SetRotation(TransformHandle handle, const Quaternion& newRotation);
+
+	/// Sets the local scale (marks dirty)
+	void SetScale(TransformHandle handle, const Vec3& newScale);
+
+	/**
+	 * @brief Sets the parent transform
+	 * @param handle Transform to reparent
+	 * @param newParent New parent (invalid handle to detach)
+	 */
+	void SetParent(TransformHandle handle, TransformHandle newParent);
+
+	/// Makes child a child of parent
+	void AddChild(TransformHandle parent, TransformHandle child);
+
+	/// Detaches child if it is currently a child of parent
+	void RemoveChild(TransformHandle parent, TransformHandle child);
+
+	/// Adds to current position (marks dirty)
+	void Translate(TransformHandle handle, const Vec3& translation);
+
+	/// Applies additional rotation (marks dirty)
+	void Rotate(TransformHandle handle, const Quaternion& extraRotation);
+
+	// Batched mutators
+	/**
+	 * @brief Sets local position, rotation and scale for many transforms
+	 *
+	 * All values are written first; each transform is flagged once and the
+	 * combined propagation to descendants happens in the next update.
+	 *
+	 * @param handles Transforms to modify
+	 * @param newPositions New local positions (nullptr to leave unchanged)
+	 * @param newRotations New local rotations (nullptr to leave unchanged)
+	 * @param newScales New local scales (nullptr to leave unchanged)
+	 * @param count Number of entries in each array
+	 */
+	void SetLocalTransforms(const TransformHandle* handles, const Vec3* newPositions,
+		const Quaternion* newRotations, const Vec3* newScales, size_t count);
+
+	/// Sets the local positions of many transforms (see SetLocalTransforms)
+	void SetPositions(const TransformHandle* handles, const Vec3* newPositions, size_t count);
+
+	/// Sets the local rotations of many transforms (see SetLocalTransforms)
+	void SetRotations(const TransformHandle* handles, const Quaternion* newRotations, size_t count);
+
+	/// Sets the local scales of many transforms (see SetLocalTransforms)
+	void SetScales(const TransformHandle* handles, const Vec3* newScales, size_t count);
+
+	// Bulk update
+	/**
+	 * @brief Brings every world matrix up to date in one forward pass
+	 *
+	 * Restores the parent-before-child order first if the hierarchy changed.
+	 * Only transforms that changed, or whose parent's world matrix changed,
+	 * are recomputed. When few transforms changed since the last update, only
+	 * the subtrees below them are visited, each exactly once.
+	 */
+	void UpdateWorldMatrices();
+
+	/**
+	 * @brief Multithreaded version of UpdateWorldMatrices()
+	 *
+	 * Processes one depth level at a time, splitting each level into chunks
+	 * that worker threads claim dynamically. Every transform is computed with
+	 * the same arithmetic as the serial path, so results are bit-identical.
+	 * Falls back to the serial pass when only a few subtrees changed, and for
+	 * small or very deep, narrow hierarchies.
+	 *
+	 * Worker threads are started by the first call that needs them and parked
+	 * between calls, so a per-frame update does not create any threads.
+	 *
+	 * @param threadCount Number of threads to use, including the caller
+	 *                    (0 = std::thread::hardware_concurrency())
+	 */
+	void UpdateWorldMatricesParallel(unsigned threadCount = 0);
+
+	/// Returns how many transforms the last world matrix update visited (0 if nothing had changed)
+	uint32_t GetLastUpdateVisitCount() const;
+
+	/**
+	 * @brief Returns the dense index of a transform
+	 * @note Only stable until the next structural change followed by an update
+	 */
+	uint32_t GetIndex(TransformHandle handle) const;
+
+	/// Returns the handle stored at a dense index
+	TransformHandle GetHandle(uint32_t index) const;
+
+	/**
+	 * @brief Returns the transforms whose world matrix changed since the last call
+	 *
+	 * Each transform is listed once, parents before children. A world matrix
+	 * counts as changed only if its recomputed value differs; newly created
+	 * transforms are always listed. Destroyed transforms are not reported.
+	 * Call after UpdateWorldMatrices() so the list is complete.
+	 *
+	 * @param[out] changed Receives the changed transforms
+	 */
+	void ConsumeChangedTransforms(std::vector<TransformHandle>& changed);
+
+	/// Returns the contiguous world matrix array (valid after UpdateWorldMatrices)
+	const Mat4* GetWorldMatrices() const;
+
+	// Fixed-timestep interpolation
+	/**
+	 * @brief Stores the current local transforms as the previous simulation state
+	 *
+	 * Call once at the start of every fixed simulation step, before the step
+	 * moves anything. Only transforms that moved since the last call are copied.
+	 */
+	void SavePreviousState();
+
+	/**
+	 * @brief Computes world matrices interpolated between the previous and current state
+	 *
+	 * Each moving transform blends its local position and scale linearly and
+	 * its rotation with nlerp, then is composed with its parent's interpolated
+	 * matrix. Transforms that did not move, and whose ancestors did not move,
+	 * reuse their world matrix unchanged.
+	 *
+	 * @param alpha Blend factor between the previous (0) and current (1) step
+	 * @param[out] renderMatrices Receives one matrix per transform, in dense order
+	 */
+	void InterpolateWorldMatrices(float alpha, std::vector<Mat4>& renderMatrices);
+
+	// Hierarchical bounds
+	/**
+	 * @brief Sets the bounding box of a transform in its local space
+	 * @param handle Transform to modify
+	 * @param bounds Local bounds (AABB::empty() for a transform with no geometry of its own)
+	 */
+	void SetLocalBounds(TransformHandle handle, const AABB& bounds);
+
+	/// Returns the local bounds (empty if none were set)
+	AABB GetLocalBounds(TransformHandle handle) const;
+
+	/// Returns the world-space box around the transform's own local bounds
+	AABB GetWorldBounds(TransformHandle handle);
+
+	/// Returns the world-space box around the transform and all of its descendants
+	AABB GetSubtreeBounds(TransformHandle handle);
+
+	/**
+	 * @brief Brings world matrices and subtree bounds up to date
+	 *
+	 * Buckets the transforms whose world matrix or local bounds changed by
+	 * depth and refits the deepest level first, so every child is refit before
+	 * its parent. A parent is refit only if a child's subtree bounds actually
+	 * changed, so the cost follows the changed transforms and their ancestors,
+	 * not the size of the system. Called automatically by the bounds queries.
+	 */
+	void UpdateBounds();
+
+	/**
+	 * @brief Finds every transform whose world bounds overlap a region
+	 *
+	 * Walks the hierarchy from the roots and skips a whole subtree as soon as
+	 * its subtree bounds miss the region. Results are in depth-first order.
+	 *
+	 * @param region World-space box to test
+	 * @param[out] results Receives the overlapping transforms
+	 */
+	void QueryBounds(const AABB& region, std::vector<TransformHandle>& results);
+
+	/**
+	 * @brief Finds every transform whose world bounds are not fully outside a frustum
+	 *
+	 * Same walk as QueryBounds, testing bounds with Frustum::intersects.
+	 *
+	 * @param frustum World-space view frustum
+	 * @param[out] results Receives the visible transforms
+	 */
+	void QueryFrustum(const Frustum& frustum, std::vector<TransformHandle>& results);
+
+	/// Returns the contiguous parent index array (NoParent for roots)
+	const uint32_t* GetParentIndices() const;
+
+	/// Returns the contiguous local position array
+	const Vec3* GetPositions() const;
+
+	/// Returns the contiguous local rotation array
+	const Quaternion* GetRotations() const;
+
+	/// Returns the contiguous local scale array
+	const Vec3* GetScales() const;
+
+private:
+	/// Per-transform state flags
+	enum : uint8_t {
+		LocalDirty = 1 << 0,  ///< Local matrix needs recalculation
+		WorldDirty = 1 << 1,  ///< Own local matrix or parent link changed
+		Queued = 1 << 2,      ///< Listed in dirtyIds
+		Journaled = 1 << 3,   ///< Listed in changedIds
+		Moving = 1 << 4,      ///< Local transform changed since SavePreviousState, listed in movingIds
+		BoundsDirty = 1 << 5  ///< World bounds or a child's subtree bounds must be refit, listed in boundsDirtyIds
+	};
+
+	// Dense arrays, sorted by depth
+	std::vector<Vec3> positions;               ///< Local positions
+	std::vector<Quaternion> rotations;         ///< Local rotations
+	std::vector<Vec3> scales;                  ///< Local scales
+	std::vector<uint32_t> parents;             ///< Dense parent index (NoParent for roots)
+	std::vector<uint32_t> depths;              ///< Distance from the root
+	mutable std::vector<Mat4> localMatrices;   ///< Cached local matrices
+	mutable std::vector<Mat4> worldMatrices;   ///< Cached world matrices
+	mutable std::vector<uint8_t> flags;        ///< LocalDirty / WorldDirty bits
+	mutable std::vector<uint32_t> worldVersions;   ///< Bumped whenever a world matrix is rebuilt
+	mutable std::vector<uint32_t> parentVersions;  ///< Parent's world version used for the cached world matrix
+	std::vector<uint32_t> denseToId;           ///< Dense index -> handle id
+	std::vector<Vec3> previousPositions;       ///< Local positions at the last SavePreviousState
+	std::vector<Quaternion> previousRotations; ///< Local rotations at the last SavePreviousState
+	std::vector<Vec3> previousScales;          ///< Local scales at the last SavePreviousState
+	std::vector<AABB> localBounds;             ///< Bounds in local space (empty if none)
+	std::vector<AABB> worldBounds;             ///< Local bounds transformed to world space
+	std::vector<AABB> subtreeBounds;           ///< World bounds merged with all descendants
+
+	// Slot arrays, indexed by handle id
+	std::vector<uint32_t> idToDense;           ///< Handle id -> dense index (NoParent if free)
+	std::vector<uint32_t> generations;         ///< Current generation of each slot
+	std::vector<uint32_t> firstChild;          ///< Intrusive child list head (handle id)
+	std::vector<uint32_t> lastChild;           ///< Intrusive child list tail (handle id)
+	std::vector<uint32_t> nextSibling;         ///< Next sibling (handle id)
+	std::vector<uint32_t> prevSibling;         ///< Previous sibling (handle id)
+	std::vector<uint32_t> freeIds;             ///< Released slots available for reuse
+	std::vector<uint32_t> levelOffsets;        ///< First dense index of each depth, plus the total count
+
+	std::vector<uint32_t> dirtyIds;            ///< Transforms mutated since the last update (handle ids)
+	mutable std::vector<uint32_t> changedIds;  ///< World matrices changed since the last consume (handle ids)
+	std::vector<uint32_t> visitPasses;         ///< Subtree pass that last visited each dense index
+	std::vector<uint32_t> visitStack;          ///< Scratch stack for subtree visits
+	uint32_t updatePass;                       ///< Incremented by every subtree pass
+	uint32_t lastUpdateVisits;                 ///< Transforms visited by the last world matrix update
+	std::vector<uint32_t> movingIds;           ///< Transforms moved since SavePreviousState (handle ids)
+	std::vector<uint8_t> interpolatedScratch;  ///< Marks render matrices that differ from world matrices
+	mutable std::vector<uint32_t> boundsDirtyIds;     ///< Transforms flagged BoundsDirty (handle ids)
+	std::vector<std::vector<uint32_t>> boundsLevels;  ///< Scratch: bounds-dirty dense indices bucketed by depth
+
+	bool orderDirty;                           ///< True if the depth order must be restored
+	mutable bool pendingChanges;               ///< True if any cached matrix may be stale
+	mutable std::vector<uint32_t> chainScratch;  ///< Ancestor chain used by lazy queries
+
+	/// Parked worker threads plus the per-call cursors and change lists they share
+	class WorkerPool;
+	std::unique_ptr<WorkerPool> workerPool;    ///< Created by the first parallel update that needs it
+
+	/// Claims a slot and appends a root transform to the dense arrays
+	TransformHandle Allocate(const Vec3& position, const Quaternion& rotation, const Vec3& scale);
+
+	/// Inserts a slot at the end of its parent's child list
+	void LinkChild(uint32_t parentId, uint32_t childId);
+
+	/// Removes a slot from its parent's child list
+	void UnlinkChild(uint32_t parentId, uint32_t childId);
+
+	/// Removes dense entries whose slot was released, preserving order
+	void Compact();
+
+	/// Recomputes levelOffsets from the (sorted) depth array
+	void RebuildLevelOffsets();
+
+	/// Marks a transform's local and world matrices as stale
+	void MarkDirty(uint32_t index);
+
+	/// Records a mutated transform for the next update (once per update)
+	void QueueDirty(uint32_t index);
+
+	/// Clears the dirty list after an update
+	void ClearDirtyList();
+
+	/// Flags a transform's bounds for the next refit (listed once per refit)
+	void MarkBoundsDirty(uint32_t index) const;
+
+	/// Journals a rebuilt world matrix and flags its bounds
+	void RecordWorldChange(uint32_t index) const;
+
+	/// Updates only the subtrees below queued transforms, each exactly once
+	void UpdateDirtySubtrees();
+
+	/// Rebuilds the local matrix of a transform if it is stale
+	void UpdateLocalMatrix(uint32_t index) const;
+
+	/**
+	 * @brief Rebuilds the world matrix of a transform if it or its parent changed
+	 * @return true if the matrix changed and must be passed to RecordWorldChange
+	 */
+	bool UpdateWorldMatrix(uint32_t index) const;
+
+	/// Brings one transform and its ancestors up to date
+	void ResolveWorldMatrix(uint32_t index) const;
+
+	/// Re-sorts all arrays by depth so parents precede children
+	void SortByDepth();
+
+	/// Depth-first walk that skips subtrees whose bounds fail the test
+	template<typename BoundsTest>
+	void CullSubtrees(const BoundsTest& overlaps, std::vector<TransformHandle>& results);
+};
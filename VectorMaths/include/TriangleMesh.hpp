@@ -0,0 +1,127 @@
+/**
+ * @file TriangleMesh.hpp
+ * @brief Triangle mesh collider with its own bounding volume hierarchy
+ *
+ * Built from vertex and index buffers. Ray queries use the watertight
+ * ray-triangle test, so rays through shared edges and vertices never slip
+ * through the mesh.
+ */
+
+#pragma once
+
+#include "Vector.hpp"
+#include "Collision.hpp"
+#include "RayPacket.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// Result of a ray query against a triangle mesh
+struct TriangleHit {
+	uint32_t index = 0;      ///< Index of the triangle that was hit (its first index is at 3 * index)
+	float distance = 0.0f;   ///< Distance along the ray to the hit point
+	float u = 0.0f;          ///< Barycentric weight of the triangle's second vertex
+	float v = 0.0f;          ///< Barycentric weight of the third vertex (the first has 1 - u - v)
+};
+
+/**
+ * @brief Static triangle mesh with a compact SAH bounding volume hierarchy
+ *
+ * Uses the same binned SAH build and 32-byte node layout as BVH. Triangle
+ * vertices are copied into leaf order, so a leaf reads its triangles from one
+ * contiguous range without going through the index buffer.
+ *
+ * Leaf tests use rayIntersectsTriangle, so results match a loop over every
+ * triangle. Both faces are hit; equal distances go to the lower triangle index.
+ * Node tests are widened by a few ulps so rounding in the box test cannot
+ * skip a node whose triangles meet the ray exactly on the node's face.
+ *
+ * @note The mesh is static: rebuild it after vertices move.
+ */
+class TriangleMesh {
+public:
+	/// Creates an empty mesh
+	TriangleMesh();
+
+	/**
+	 * @brief Builds the mesh and its hierarchy from vertex and index buffers
+	 * @param vertices Vertex positions
+	 * @param vertexCount Number of vertices
+	 * @param indices Three vertex indices per triangle
+	 * @param indexCount Number of indices (a multiple of 3)
+	 */
+	void build(const Vec3* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+	/// Removes all triangles and nodes
+	void clear();
+
+	/// Returns the number of triangles
+	size_t getTriangleCount() const;
+
+	/// Returns the number of nodes
+	size_t getNodeCount() const;
+
+	/// Returns the bounds of all triangles (empty if there are none)
+	AABB getBounds() const;
+
+	/**
+	 * @brief Finds the closest triangle hit by a ray
+	 * @param ray The ray to cast
+	 * @param[out] hit Set to the closest hit, with its barycentric coordinates, if one is found
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any triangle is hit within maxDistance
+	 */
+	bool raycast(const Ray& ray, TriangleHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Tests if a ray hits any triangle, stopping at the first one found
+	 * @param ray The ray to cast
+	 * @param maxDistance Hits further along the ray are ignored
+	 * @return true if any triangle is hit within maxDistance
+	 * @note Cheaper than raycast(); suited to shadow and line-of-sight tests
+	 */
+	bool raycastAny(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * @brief Finds the closest triangle hit by each ray of a packet
+	 *
+	 * Gives the same hits as calling raycast() for each ray.
+	 *
+	 * @param packet The rays to cast
+	 * @param[out] hits Set, for each lane that hits, to the closest hit
+	 * @param maxDistance Hits further along the rays are ignored
+	 * @return Mask of the active lanes that hit any triangle within maxDistance
+	 */
+	uint32_t raycast(const RayPacket& packet, TriangleHit hits[RayPacket::Width],
+		float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	/// Returns the mask of packet lanes that hit any triangle; each lane stops at its first hit
+	uint32_t raycastAny(const RayPacket& packet, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/// Flattened node, 32 bytes (same layout as BVH)
+	struct Node {
+		AABB bounds;       ///< Bounds of everything below this node
+		uint32_t offset;   ///< Leaf: first triangle; interior: right child index
+		uint32_t count;    ///< Number of triangles (0 for interior nodes)
+	};
+
+	/// Triangle vertices copied out of the buffers
+	struct Triangle {
+		Vec3 a;
+		Vec3 b;
+		Vec3 c;
+	};
+
+	std::vector<Node> nodes;                ///< Depth-first node array, root first
+	std::vector<Triangle> triangles;        ///< Triangles in leaf order
+	std::vector<uint32_t> triangleIndices;  ///< Leaf order -> triangle index in the index buffer
+
+	/// Walks the tree; stops at the first hit if anyHit is set
+	bool traverse(const Ray& ray, TriangleHit& hit, float maxDistance, bool anyHit) const;
+
+	/// Walks the tree with a packet; lanes retire at their first hit if anyHit is set
+	uint32_t traversePacket(const RayPacket& packet, TriangleHit hits[RayPacket::Width], float maxDistance, bool anyHit) const;
+};
@@ -0,0 +1,327 @@
+/**
+ * @file BVH.cpp
+ * @brief Implementation of the SAH bounding volume hierarchy
+ */
+
+#include "../include/BVH.hpp"
+#include "BVHBuilder.hpp"
+#include "RayTraversal.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static_assert(sizeof(AABB) == 6 * sizeof(float), "BVH nodes assume a tightly packed AABB");
+
+// Constructors
+BVH::BVH() {}
+
+void BVH::build(const AABB* boxes, size_t count) {
+	clear();
+	primitiveBounds.assign(boxes, boxes + count);
+	buildNodes();
+}
+
+void BVH::build(const Sphere* spheres, size_t count) {
+	clear();
+	this->spheres.assign(spheres, spheres + count);
+	primitiveBounds.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		float r = spheres[i].radius;
+		primitiveBounds.push_back(AABB::fromCenterAndExtents(spheres[i].center, Vec3(r, r, r)));
+	}
+	buildNodes();
+}
+
+void BVH::clear() {
+	nodes.clear();
+	primitiveBounds.clear();
+	spheres.clear();
+	primitiveIndices.clear();
+}
+
+size_t BVH::size() const {
+	return primitiveBounds.size();
+}
+
+size_t BVH::getNodeCount() const {
+	return nodes.size();
+}
+
+AABB BVH::getBounds() const {
+	return nodes.empty() ? AABB::empty() : nodes[0].bounds;
+}
+
+// Ray queries
+bool BVH::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	return traverse(ray, hit, maxDistance, false);
+}
+
+bool BVH::raycastAny(const Ray& ray, float maxDistance) const {
+	RayHit hit;
+	return traverse(ray, hit, maxDistance, true);
+}
+
+uint32_t BVH::raycast(const RayPacket& packet, RayHit hits[RayPacket::Width], float maxDistance) const {
+	return traversePacket(packet, hits, maxDistance, false);
+}
+
+uint32_t BVH::raycastAny(const RayPacket& packet, float maxDistance) const {
+	RayHit hits[RayPacket::Width];
+	return traversePacket(packet, hits, maxDistance, true);
+}
+
+// Overlap queries
+void BVH::queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const {
+	collect(
+		[&](const AABB& bounds) { return aabbIntersectsAABB(bounds, box); },
+		[&](uint32_t primitive) {
+			return spheres.empty()
+				? aabbIntersectsAABB(primitiveBounds[primitive], box)
+				: sphereIntersectsAABB(spheres[primitive], box);
+		},
+		results);
+}
+
+void BVH::queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const {
+	collect(
+		[&](const AABB& bounds) { return sphereIntersectsAABB(sphere, bounds); },
+		[&](uint32_t primitive) {
+			return spheres.empty()
+				? sphereIntersectsAABB(sphere, primitiveBounds[primitive])
+				: sphereIntersectsSphere(spheres[primitive], sphere);
+		},
+		results);
+}
+
+// Internal helpers
+void BVH::buildNodes() {
+	uint32_t count = static_cast<uint32_t>(primitiveBounds.size());
+	if (count == 0) {
+		return;
+	}
+
+	// Partitioning copies of the primitives keeps every build pass sequential in memory
+	std::vector<bvhbuild::BuildPrimitive> primitives(count);
+	for (uint32_t i = 0; i < count; i++) {
+		bvhbuild::InitPrimitive(primitives[i], primitiveBounds[i], i);
+	}
+	bvhbuild::Build(nodes, primitives);
+
+	// Store primitives in leaf order so each leaf reads a contiguous range
+	primitiveIndices.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		primitiveBounds[i] = primitives[i].bounds.toAABB();
+		primitiveIndices[i] = primitives[i].index;
+	}
+
+	if (!spheres.empty()) {
+		std::vector<Sphere> sortedSpheres;
+		sortedSpheres.reserve(count);
+		for (uint32_t index : primitiveIndices) {
+			sortedSpheres.push_back(spheres[index]);
+		}
+		spheres.swap(sortedSpheres);
+	}
+}
+
+bool BVH::intersectPrimitive(const Ray& ray, uint32_t primitive, float& distance) const {
+	if (spheres.empty()) {
+		return rayIntersectsAABB(ray, primitiveBounds[primitive], distance);
+	}
+	return rayIntersectsSphere(ray, spheres[primitive], distance);
+}
+
+bool BVH::traverse(const Ray& ray, RayHit& hit, float maxDistance, bool anyHit) const {
+	if (nodes.empty()) {
+		return false;
+	}
+
+	float closest = maxDistance;
+	bool found = false;
+
+	traversal::StackEntry stack[MaxDepth];
+	uint32_t stackSize = 0;
+	float entry;
+	if (traversal::RayHitsBox(ray, nodes[0].bounds, closest, entry)) {
+		stack[stackSize++] = { 0, entry };
+	}
+
+	while (stackSize > 0) {
+		traversal::StackEntry current = stack[--stackSize];
+
+		// A closer hit was found after this node was pushed
+		if (current.entry > closest) {
+			continue;
+		}
+
+		const Node& node = nodes[current.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+				float distance;
+				if (intersectPrimitive(ray, i, distance) &&
+					traversal::IsCloserHit(distance, primitiveIndices[i], closest, found, hit.index)) {
+					closest = distance;
+					hit.index = primitiveIndices[i];
+					hit.distance = distance;
+					found = true;
+					if (anyHit) {
+						return true;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so later boxes can be pruned
+		uint32_t left = current.node + 1;
+		uint32_t right = node.offset;
+		float leftEntry;
+		float rightEntry;
+		bool hitLeft = traversal::RayHitsBox(ray, nodes[left].bounds, closest, leftEntry);
+		bool hitRight = traversal::RayHitsBox(ray, nodes[right].bounds, closest, rightEntry);
+
+		if (hitLeft && hitRight) {
+			if (leftEntry <= rightEntry) {
+				stack[stackSize++] = { right, rightEntry };
+				stack[stackSize++] = { left, leftEntry };
+			}
+			else {
+				stack[stackSize++] = { left, leftEntry };
+				stack[stackSize++] = { right, rightEntry };
+			}
+		}
+		else if (hitLeft) {
+			stack[stackSize++] = { left, leftEntry };
+		}
+		else if (hitRight) {
+			stack[stackSize++] = { right, rightEntry };
+		}
+	}
+
+	return found;
+}
+
+uint32_t BVH::traversePacket(const RayPacket& packet, RayHit hits[RayPacket::Width], float maxDistance, bool anyHit) const {
+	uint32_t active = packet.activeMask;
+	if (nodes.empty() || active == 0) {
+		return 0;
+	}
+
+	float closest[RayPacket::Width];
+	std::fill(closest, closest + RayPacket::Width, maxDistance);
+	uint32_t found = 0;
+
+	uint32_t stack[MaxDepth];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		uint32_t current = stack[--stackSize];
+		const Node& node = nodes[current];
+
+		// Lanes that still reach this node, given their closest hits so far
+		float entry[RayPacket::Width];
+		uint32_t mask = simd::PacketHitsBox(packet, node.bounds, closest, entry) & active;
+		if (mask == 0) {
+			continue;
+		}
+
+		if (node.count > 0) {
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+				float distance[RayPacket::Width];
+				uint32_t hitMask;
+				if (spheres.empty()) {
+					hitMask = simd::PacketIntersectsAABB(packet, primitiveBounds[i], distance) & mask;
+				}
+				else {
+					hitMask = 0;
+					for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+						if (((mask >> lane) & 1u) && intersectPrimitive(packet.getRay(lane), i, distance[lane])) {
+							hitMask |= 1u << lane;
+						}
+					}
+				}
+
+				for (uint32_t lane = 0; hitMask != 0; lane++, hitMask >>= 1) {
+					if ((hitMask & 1u) &&
+						traversal::IsCloserHit(distance[lane], primitiveIndices[i], closest[lane], (found >> lane) & 1u, hits[lane].index)) {
+						closest[lane] = distance[lane];
+						hits[lane].index = primitiveIndices[i];
+						hits[lane].distance = distance[lane];
+						found |= 1u << lane;
+					}
+				}
+
+				if (anyHit) {
+					active &= ~found;
+					mask &= ~found;
+					if (active == 0) {
+						return found;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Visit the child whose center is further along the first lane's ray last, so it's popped first
+		uint32_t lane = 0;
+		while (!((mask >> lane) & 1u)) {
+			lane++;
+		}
+		uint32_t left = current + 1;
+		uint32_t right = node.offset;
+		const AABB& leftBounds = nodes[left].bounds;
+		const AABB& rightBounds = nodes[right].bounds;
+		float leftAlong = (leftBounds.min.x + leftBounds.max.x) * packet.directionX[lane] +
+			(leftBounds.min.y + leftBounds.max.y) * packet.directionY[lane] +
+			(leftBounds.min.z + leftBounds.max.z) * packet.directionZ[lane];
+		float rightAlong = (rightBounds.min.x + rightBounds.max.x) * packet.directionX[lane] +
+			(rightBounds.min.y + rightBounds.max.y) * packet.directionY[lane] +
+			(rightBounds.min.z + rightBounds.max.z) * packet.directionZ[lane];
+
+		if (leftAlong <= rightAlong) {
+			stack[stackSize++] = right;
+			stack[stackSize++] = left;
+		}
+		else {
+			stack[stackSize++] = left;
+			stack[stackSize++] = right;
+		}
+	}
+
+	return found;
+}
+
+template<typename NodeTest, typename PrimitiveTest>
+void BVH::collect(const NodeTest& nodeTest, const PrimitiveTest& primitiveTest, std::vector<uint32_t>& results) const {
+	results.clear();
+	if (nodes.empty()) {
+		return;
+	}
+
+	uint32_t stack[MaxDepth];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		uint32_t current = stack[--stackSize];
+		const Node& node = nodes[current];
+		if (!nodeTest(node.bounds)) {
+			continue;
+		}
+
+		if (node.count > 0) {
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+				if (primitiveTest(i)) {
+					results.push_back(primitiveIndices[i]);
+				}
+			}
+		}
+		else {
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = current + 1;
+		}
+	}
+}
@@ -0,0 +1,235 @@
+/**
+ * @file BVHBuilder.hpp
+ * @brief Internal binned SAH builder shared by the BVH and the triangle mesh
+ *
+ * Private to the library.
+ */
+
+#pragma once
+
+#include "../include/Collision.hpp"
+#include "../include/BVH.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace bvhbuild {
+
+/// Cost of visiting a node relative to one primitive test
+const float TraversalCost = 1.0f;
+
+/// Plain min/max bounds for the builder's scratch bins (no constructor calls in the inner loops)
+struct BuildBounds {
+	float min[3];
+	float max[3];
+
+	void reset() {
+		const float inf = std::numeric_limits<float>::infinity();
+		min[0] = min[1] = min[2] = inf;
+		max[0] = max[1] = max[2] = -inf;
+	}
+
+	void grow(const float lo[3], const float hi[3]) {
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = std::min(min[axis], lo[axis]);
+			max[axis] = std::max(max[axis], hi[axis]);
+		}
+	}
+
+	void grow(const BuildBounds& other) {
+		grow(other.min, other.max);
+	}
+
+	/// Surface area (0 for empty bounds)
+	float area() const {
+		if (min[0] > max[0]) {
+			return 0.0f;
+		}
+		float dx = max[0] - min[0];
+		float dy = max[1] - min[1];
+		float dz = max[2] - min[2];
+		return 2.0f * (dx * dy + dy * dz + dz * dx);
+	}
+
+	AABB toAABB() const {
+		return AABB(Vec3(min[0], min[1], min[2]), Vec3(max[0], max[1], max[2]));
+	}
+};
+
+/// Primitive bounds, centroid and original index, partitioned in place during the build
+struct BuildPrimitive {
+	BuildBounds bounds;
+	float centroid[3];
+	uint32_t index;
+};
+
+/// Fills a build primitive from a box and its original index
+inline void InitPrimitive(BuildPrimitive& primitive, const AABB& box, uint32_t index) {
+	primitive.bounds.min[0] = box.min.x;
+	primitive.bounds.min[1] = box.min.y;
+	primitive.bounds.min[2] = box.min.z;
+	primitive.bounds.max[0] = box.max.x;
+	primitive.bounds.max[1] = box.max.y;
+	primitive.bounds.max[2] = box.max.z;
+	for (int axis = 0; axis < 3; axis++) {
+		primitive.centroid[axis] = 0.5f * (primitive.bounds.min[axis] + primitive.bounds.max[axis]);
+	}
+	primitive.index = index;
+}
+
+/**
+ * @brief Splits the primitives [first, first + count) below a node
+ *
+ * Node must have bounds, offset and count members laid out as in BVH: a leaf
+ * stores its first primitive and count, an interior node stores the index of
+ * its right child with count 0, and the left child directly follows it.
+ * Primitives end up in leaf order.
+ */
+template<typename Node>
+void BuildNode(std::vector<Node>& nodes, uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth,
+	std::vector<BuildPrimitive>& primitives) {
+	const uint32_t BinCount = BVH::BinCount;
+	BuildPrimitive* begin = primitives.data() + first;
+	BuildPrimitive* end = begin + count;
+
+	BuildBounds bounds;
+	BuildBounds centroidBounds;
+	bounds.reset();
+	centroidBounds.reset();
+	for (const BuildPrimitive* p = begin; p != end; p++) {
+		bounds.grow(p->bounds);
+		centroidBounds.grow(p->centroid, p->centroid);
+	}
+	nodes[nodeIndex].bounds = bounds.toAABB();
+
+	auto makeLeaf = [&]() {
+		nodes[nodeIndex].offset = first;
+		nodes[nodeIndex].count = count;
+	};
+
+	if (count == 1) {
+		makeLeaf();
+		return;
+	}
+
+	// Binned SAH: try BinCount - 1 split planes per axis, spaced over the centroid bounds.
+	// Below half the depth budget, only median splits are used so depth stays bounded.
+	int bestAxis = -1;
+	uint32_t bestSplit = 0;
+	float bestCost = std::numeric_limits<float>::infinity();
+	if (depth < BVH::MaxDepth / 2) {
+		for (int axis = 0; axis < 3; axis++) {
+			float lo = centroidBounds.min[axis];
+			float extent = centroidBounds.max[axis] - lo;
+			if (extent <= 0.0f) {
+				continue;
+			}
+			float scale = BinCount / extent;
+
+			uint32_t binCounts[BVH::BinCount] = {};
+			BuildBounds binBounds[BVH::BinCount];
+			for (BuildBounds& bin : binBounds) {
+				bin.reset();
+			}
+			for (const BuildPrimitive* p = begin; p != end; p++) {
+				uint32_t bin = std::min(BinCount - 1, static_cast<uint32_t>((p->centroid[axis] - lo) * scale));
+				binCounts[bin]++;
+				binBounds[bin].grow(p->bounds);
+			}
+
+			// Sweep from the right, then evaluate each plane sweeping from the left
+			float rightAreas[BVH::BinCount];
+			uint32_t rightCounts[BVH::BinCount];
+			BuildBounds accumulated;
+			accumulated.reset();
+			uint32_t accumulatedCount = 0;
+			for (uint32_t bin = BinCount - 1; bin > 0; bin--) {
+				accumulated.grow(binBounds[bin]);
+				accumulatedCount += binCounts[bin];
+				rightAreas[bin] = accumulated.area();
+				rightCounts[bin] = accumulatedCount;
+			}
+
+			accumulated.reset();
+			accumulatedCount = 0;
+			for (uint32_t split = 1; split < BinCount; split++) {
+				accumulated.grow(binBounds[split - 1]);
+				accumulatedCount += binCounts[split - 1];
+				if (accumulatedCount == 0 || rightCounts[split] == 0) {
+					continue;
+				}
+
+				float cost = accumulated.area() * accumulatedCount + rightAreas[split] * rightCounts[split];
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+	}
+
+	float area = bounds.area();
+	bool splitPays = bestAxis >= 0 && area * TraversalCost + bestCost < area * count;
+	if (!splitPays && count <= BVH::MaxLeafSize) {
+		makeLeaf();
+		return;
+	}
+
+	BuildPrimitive* middle;
+	if (bestAxis >= 0) {
+		float lo = centroidBounds.min[bestAxis];
+		float scale = BinCount / (centroidBounds.max[bestAxis] - lo);
+		middle = std::partition(begin, end, [&](const BuildPrimitive& p) {
+			uint32_t bin = std::min(BinCount - 1, static_cast<uint32_t>((p.centroid[bestAxis] - lo) * scale));
+			return bin < bestSplit;
+		});
+	}
+	else {
+		// No usable plane (coincident centroids or depth limit): split at the median
+		int axis = 0;
+		for (int candidate = 1; candidate < 3; candidate++) {
+			if (centroidBounds.max[candidate] - centroidBounds.min[candidate] >
+				centroidBounds.max[axis] - centroidBounds.min[axis]) {
+				axis = candidate;
+			}
+		}
+		middle = begin + count / 2;
+		std::nth_element(begin, middle, end, [&](const BuildPrimitive& a, const BuildPrimitive& b) {
+			return a.centroid[axis] < b.centroid[axis];
+		});
+	}
+
+	uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+
+	// The left child directly follows its parent; only the right index is stored
+	uint32_t left = static_cast<uint32_t>(nodes.size());
+	nodes.push_back(Node());
+	BuildNode(nodes, left, first, leftCount, depth + 1, primitives);
+
+	uint32_t right = static_cast<uint32_t>(nodes.size());
+	nodes.push_back(Node());
+	nodes[nodeIndex].offset = right;
+	nodes[nodeIndex].count = 0;
+	BuildNode(nodes, right, first + leftCount, count - leftCount, depth + 1, primitives);
+}
+
+/// Builds the whole tree into nodes (cleared first); primitives end up in leaf order
+template<typename Node>
+void Build(std::vector<Node>& nodes, std::vector<BuildPrimitive>& primitives) {
+	nodes.clear();
+	uint32_t count = static_cast<uint32_t>(primitives.size());
+	if (count == 0) {
+		return;
+	}
+
+	// A binary tree with count leaves at most has 2 * count - 1 nodes
+	nodes.reserve(2 * static_cast<size_t>(count) - 1);
+	nodes.push_back(Node());
+	BuildNode(nodes, 0, 0, count, 1, primitives);
+	nodes.shrink_to_fit();
+}
+
+} // namespace bvhbuild
@@ -4,14 +4,29 @@
  */
 
 #include "../include/Collision.hpp"
+#include "RayTraversal.hpp"
 #include <cmath>
+#include <limits>
 
 
-Ray::Ray() : origin(0.0f, 0.0f, 0.0f), direction(0.0f, 0.0f, 1.0f) {}
+Ray::Ray() : origin(0.0f, 0.0f, 0.0f) {
+	setDirection(Vec3(0.0f, 0.0f, 1.0f));
+}
 
 Ray::Ray(const Vec3& origin, const Vec3& direction)
-	: origin(origin),
-	direction(direction.normalised()) {}
+	: origin(origin) {
+	setDirection(direction);
+}
+
+void Ray::setDirection(const Vec3& newDirection) {
+	direction = newDirection.normalised();
+
+	// Zero components give signed infinities, which the slab tests handle explicitly
+	inverseDirection = Vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+	sign[0] = inverseDirection.x < 0.0f ? 1 : 0;
+	sign[1] = inverseDirection.y < 0.0f ? 1 : 0;
+	sign[2] = inverseDirection.z < 0.0f ? 1 : 0;
+}
 
 Vec3 Ray::getPoint(float t) const {
 	return origin + (direction * t);
@@ -24,6 +39,15 @@ AABB AABB::fromCenterAndExtents(const Vec3& center, const Vec3& halfExtents) {
 	return AABB(center - halfExtents, center + halfExtents);
 }
 
+AABB AABB::empty() {
+	const float inf = std::numeric_limits<float>::infinity();
+	return AABB(Vec3(inf, inf, inf), Vec3(-inf, -inf, -inf));
+}
+
+bool AABB::isEmpty() const {
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
 Vec3 AABB::getExtents() const {
 	return (max - min) / 2;
 }
@@ -41,6 +65,19 @@ bool AABB::contains(const Vec3& point) const {
 	return inX && inY && inZ;
 }
 
+bool AABB::contains(const AABB& other) const {
+	return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+		other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+}
+
+float AABB::getSurfaceArea() const {
+	if (isEmpty()) {
+		return 0.0f;
+	}
+	Vec3 size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
 void AABB::expand(const Vec3& point) {
 	max.x = std::fmax(max.x, point.x);
 	max.y = std::fmax(max.y, point.y);
@@ -50,7 +87,7 @@ void AABB::expand(const Vec3& point) {
 	min.z = std::fmin(min.z, point.z);
 }
 
-AABB AABB::merge(const AABB& other) {
+AABB AABB::merge(const AABB& other) const {
 	float maxX = std::fmax(max.x, other.max.x);
 	float maxY = std::fmax(max.y, other.max.y);
 	float maxZ = std::fmax(max.z, other.max.z);
@@ -85,22 +122,23 @@ bool Sphere::contains(const Vec3& point) const {
  */
 bool rayIntersectsSphere(const Ray& ray, const Sphere& sphere, float& distance) {
 	// Early out: sphere behind ray
-	float raySphereDot = (sphere.center - ray.origin).dot(ray.direction);
+	float raySphereDot = (sphere.center - ray.origin).dot(ray.getDirection());
 	if (raySphereDot < 0) {
 		return false;
 	}
 
 	// Find closest point on ray to sphere center
-	Vec3 p = ray.origin + (ray.direction * raySphereDot);
-	float d = (p - sphere.center).length();
+	Vec3 p = ray.origin + (ray.getDirection() * raySphereDot);
+	float distanceSquared = (p - sphere.center).lengthSquared();
+	float radiusSquared = sphere.radius * sphere.radius;
 
-	// Check if ray misses sphere
-	if (d > sphere.radius) {
+	// Check if ray misses sphere (squared, so the only sqrt is the one below)
+	if (distanceSquared > radiusSquared) {
 		return false;
 	}
 
 	// Calculate intersection distances (near and far)
-	float offset = std::sqrt(std::pow(sphere.radius, 2) - std::pow(d, 2));
+	float offset = std::sqrt(radiusSquared - distanceSquared);
 	float t1 = raySphereDot - offset;  // Near intersection
 
 	// Handle ray origin inside sphere
@@ -118,7 +156,7 @@ bool rayIntersectsSphere(const Ray& ray, const Sphere& sphere, float& distance)
 }
 
 bool rayIntersectsPlane(const Ray& ray, const Vec3& planeNormal, const Vec3& planePoint, float& distance) {
-	float dotProduct = planeNormal.dot(ray.direction);
+	float dotProduct = planeNormal.dot(ray.getDirection());
 	if (std::abs(dotProduct) < 1e-6f) {
 		return false;
 	}
@@ -139,24 +177,9 @@ bool rayIntersectsPlane(const Ray& ray, const Vec3& planeNormal, const Vec3& pla
  * the ray passes through all three slabs simultaneously.
  */
 bool rayIntersectsAABB(const Ray& ray, const AABB& box, float& distance) {
-	// Calculate t values for each axis slab
-	float tMinX = (box.min.x - ray.origin.x) / ray.direction.x;
-	float tMaxX = (box.max.x - ray.origin.x) / ray.direction.x;
-
-	float tMinY = (box.min.y - ray.origin.y) / ray.direction.y;
-	float tMaxY = (box.max.y - ray.origin.y) / ray.direction.y;
-
-	float tMinZ = (box.min.z - ray.origin.z) / ray.direction.z;
-	float tMaxZ = (box.max.z - ray.origin.z) / ray.direction.z;
-
-	// Swap if ray direction is negative (ensures tMin < tMax)
-	if (ray.direction.x < 0) std::swap(tMinX, tMaxX);
-	if (ray.direction.y < 0) std::swap(tMinY, tMaxY);
-	if (ray.direction.z < 0) std::swap(tMinZ, tMaxZ);
-
-	// Find the latest entry and earliest exit
-	float tMin = std::max(std::max(tMinX, tMinY), tMinZ);
-	float tMax = std::min(std::min(tMaxX, tMaxY), tMaxZ);
+	float tMin;
+	float tMax;
+	traversal::SlabInterval(ray, box, tMin, tMax);
 
 	// No intersection if entry is after exit or box is entirely behind ray
 	if (tMin > tMax) return false;  // Ray misses box
@@ -167,6 +190,11 @@ bool rayIntersectsAABB(const Ray& ray, const AABB& box, float& distance) {
 	return true;
 }
 
+bool rayIntersectsTriangle(const Ray& ray, const Vec3& a, const Vec3& b, const Vec3& c,
+	float& distance, float& u, float& v) {
+	return traversal::IntersectTriangle(traversal::ShearRay(ray), a, b, c, distance, u, v);
+}
+
 bool aabbIntersectsAABB(const AABB& a, const AABB& b) {
 	return (a.min.x <= b.max.x && a.max.x >= b.min.x) &&
 		(a.min.y <= b.max.y && a.max.y >= b.min.y) &&
@@ -183,4 +211,14 @@ bool sphereIntersectsSphere(const Sphere& a, const Sphere& b) {
 	Vec3 diff = (a.center - b.center);
 	float radiusSum = a.radius + b.radius;
 	return diff.lengthSquared() <= (radiusSum * radiusSum);
-}
\ No newline at end of file
+}
+
+bool sphereIntersectsAABB(const Sphere& sphere, const AABB& box) {
+	// Closest point on the box to the sphere center
+	float x = std::fmax(box.min.x, std::fmin(sphere.center.x, box.max.x));
+	float y = std::fmax(box.min.y, std::fmin(sphere.center.y, box.max.y));
+	float z = std::fmax(box.min.z, std::fmin(sphere.center.z, box.max.z));
+
+	Vec3 diff = sphere.center - Vec3(x, y, z);
+	return diff.lengthSquared() <= (sphere.radius * sphere.radius);
+}
@@ -0,0 +1,400 @@
+/**
+ * @file DynamicAABBTree.cpp
+ * @brief Implementation of the dynamic AABB tree
+ */
+
+#include "../include/DynamicAABBTree.hpp"
+#include "RayTraversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// Constructors
+DynamicAABBTree::DynamicAABBTree(float margin, float displacementScale)
+	: root(NullProxy),
+	freeList(NullProxy),
+	proxyCount(0),
+	margin(margin),
+	displacementScale(displacementScale) {
+}
+
+uint32_t DynamicAABBTree::createProxy(const AABB& bounds) {
+	uint32_t proxy = allocateNode();
+	nodes[proxy].bounds = fatten(bounds, Vec3());
+	nodes[proxy].height = 0;
+	tightBounds[proxy] = bounds;
+
+	insertLeaf(proxy);
+	proxyCount++;
+	return proxy;
+}
+
+void DynamicAABBTree::destroyProxy(uint32_t proxy) {
+	assert(proxy < nodes.size() && nodes[proxy].height == 0 && "Invalid proxy");
+	removeLeaf(proxy);
+	freeNode(proxy);
+	proxyCount--;
+}
+
+bool DynamicAABBTree::moveProxy(uint32_t proxy, const AABB& bounds, const Vec3& displacement) {
+	assert(proxy < nodes.size() && nodes[proxy].height == 0 && "Invalid proxy");
+	tightBounds[proxy] = bounds;
+
+	// Still enclosed: the tree needs no change
+	if (nodes[proxy].bounds.contains(bounds)) {
+		return false;
+	}
+
+	removeLeaf(proxy);
+	nodes[proxy].bounds = fatten(bounds, displacement);
+	insertLeaf(proxy);
+	return true;
+}
+
+void DynamicAABBTree::clear() {
+	nodes.clear();
+	tightBounds.clear();
+	root = NullProxy;
+	freeList = NullProxy;
+	proxyCount = 0;
+}
+
+size_t DynamicAABBTree::size() const {
+	return proxyCount;
+}
+
+uint32_t DynamicAABBTree::getHeight() const {
+	return root == NullProxy ? 0 : static_cast<uint32_t>(nodes[root].height);
+}
+
+const AABB& DynamicAABBTree::getBounds(uint32_t proxy) const {
+	assert(proxy < nodes.size() && nodes[proxy].height == 0 && "Invalid proxy");
+	return tightBounds[proxy];
+}
+
+const AABB& DynamicAABBTree::getFatBounds(uint32_t proxy) const {
+	assert(proxy < nodes.size() && nodes[proxy].height == 0 && "Invalid proxy");
+	return nodes[proxy].bounds;
+}
+
+// Queries
+void DynamicAABBTree::queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const {
+	results.clear();
+	if (root == NullProxy) {
+		return;
+	}
+
+	uint32_t stack[StackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = root;
+
+	while (stackSize > 0) {
+		uint32_t index = stack[--stackSize];
+		const Node& node = nodes[index];
+		if (!aabbIntersectsAABB(node.bounds, box)) {
+			continue;
+		}
+
+		if (node.height == 0) {
+			results.push_back(index);
+		}
+		else {
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+void DynamicAABBTree::queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const {
+	pairs.clear();
+
+	// Query the tree with every leaf, keeping each pair from its smaller id only
+	std::vector<uint32_t> overlaps;
+	for (uint32_t proxy = 0; proxy < nodes.size(); proxy++) {
+		if (nodes[proxy].height != 0) {
+			continue;
+		}
+
+		queryOverlaps(nodes[proxy].bounds, overlaps);
+		for (uint32_t other : overlaps) {
+			if (other > proxy) {
+				pairs.emplace_back(proxy, other);
+			}
+		}
+	}
+}
+
+bool DynamicAABBTree::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	return traverse(ray, hit, maxDistance, false);
+}
+
+bool DynamicAABBTree::raycastAny(const Ray& ray, float maxDistance) const {
+	RayHit hit;
+	return traverse(ray, hit, maxDistance, true);
+}
+
+// Internal helpers
+uint32_t DynamicAABBTree::allocateNode() {
+	uint32_t node;
+	if (freeList != NullProxy) {
+		node = freeList;
+		freeList = nodes[node].parent;
+	}
+	else {
+		node = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+		tightBounds.emplace_back();
+	}
+
+	nodes[node].parent = NullProxy;
+	nodes[node].child1 = NullProxy;
+	nodes[node].child2 = NullProxy;
+	nodes[node].height = 0;
+	return node;
+}
+
+void DynamicAABBTree::freeNode(uint32_t node) {
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void DynamicAABBTree::insertLeaf(uint32_t leaf) {
+	if (root == NullProxy) {
+		root = leaf;
+		nodes[leaf].parent = NullProxy;
+		return;
+	}
+
+	// Descend towards the sibling with the lowest cost: the area of the new
+	// parent plus the growth inherited by every ancestor
+	AABB leafBounds = nodes[leaf].bounds;
+	uint32_t index = root;
+	while (nodes[index].height > 0) {
+		const Node& node = nodes[index];
+		float area = node.bounds.getSurfaceArea();
+		float combinedArea = node.bounds.merge(leafBounds).getSurfaceArea();
+
+		// Cost of making the leaf a sibling of this node
+		float cost = 2.0f * combinedArea;
+		// Minimum growth pushed onto this node if the leaf goes further down
+		float inheritedCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](uint32_t child) {
+			const Node& childNode = nodes[child];
+			float grown = childNode.bounds.merge(leafBounds).getSurfaceArea();
+			if (childNode.height == 0) {
+				return grown + inheritedCost;
+			}
+			return grown - childNode.bounds.getSurfaceArea() + inheritedCost;
+		};
+		float cost1 = descendCost(node.child1);
+		float cost2 = descendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	uint32_t sibling = index;
+	uint32_t oldParent = nodes[sibling].parent;
+	uint32_t newParent = allocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = leafBounds.merge(nodes[sibling].bounds);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == NullProxy) {
+		root = newParent;
+		return;
+	}
+
+	if (nodes[oldParent].child1 == sibling) {
+		nodes[oldParent].child1 = newParent;
+	}
+	else {
+		nodes[oldParent].child2 = newParent;
+	}
+	refitAncestors(oldParent);
+}
+
+void DynamicAABBTree::removeLeaf(uint32_t leaf) {
+	if (leaf == root) {
+		root = NullProxy;
+		return;
+	}
+
+	uint32_t parent = nodes[leaf].parent;
+	uint32_t grandParent = nodes[parent].parent;
+	uint32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	// The sibling takes the parent's place
+	nodes[sibling].parent = grandParent;
+	freeNode(parent);
+	if (grandParent == NullProxy) {
+		root = sibling;
+		return;
+	}
+
+	if (nodes[grandParent].child1 == parent) {
+		nodes[grandParent].child1 = sibling;
+	}
+	else {
+		nodes[grandParent].child2 = sibling;
+	}
+	refitAncestors(grandParent);
+}
+
+void DynamicAABBTree::refitAncestors(uint32_t node) {
+	for (uint32_t index = node; index != NullProxy; index = nodes[index].parent) {
+		index = balance(index);
+
+		Node& current = nodes[index];
+		const Node& child1 = nodes[current.child1];
+		const Node& child2 = nodes[current.child2];
+		current.height = 1 + std::max(child1.height, child2.height);
+		current.bounds = child1.bounds.merge(child2.bounds);
+	}
+}
+
+uint32_t DynamicAABBTree::balance(uint32_t iA) {
+	Node& a = nodes[iA];
+	if (a.height < 2) {
+		return iA;
+	}
+
+	uint32_t iB = a.child1;
+	uint32_t iC = a.child2;
+	Node& b = nodes[iB];
+	Node& c = nodes[iC];
+	int32_t difference = c.height - b.height;
+
+	// Rotate the taller child up into A's place; A keeps the shorter of the
+	// taller child's children
+	auto rotateUp = [&](uint32_t iUp, Node& up, const Node& stay, bool upWasChild2) {
+		uint32_t iF = up.child1;
+		uint32_t iG = up.child2;
+		Node& f = nodes[iF];
+		Node& g = nodes[iG];
+
+		up.child1 = iA;
+		up.parent = a.parent;
+		a.parent = iUp;
+
+		if (up.parent == NullProxy) {
+			root = iUp;
+		}
+		else if (nodes[up.parent].child1 == iA) {
+			nodes[up.parent].child1 = iUp;
+		}
+		else {
+			nodes[up.parent].child2 = iUp;
+		}
+
+		// The taller grandchild stays with the rotated node
+		uint32_t iKeep = f.height > g.height ? iF : iG;
+		uint32_t iMove = f.height > g.height ? iG : iF;
+		up.child2 = iKeep;
+		if (upWasChild2) {
+			a.child2 = iMove;
+		}
+		else {
+			a.child1 = iMove;
+		}
+		nodes[iMove].parent = iA;
+
+		a.bounds = stay.bounds.merge(nodes[iMove].bounds);
+		a.height = 1 + std::max(stay.height, nodes[iMove].height);
+		up.bounds = a.bounds.merge(nodes[iKeep].bounds);
+		up.height = 1 + std::max(a.height, nodes[iKeep].height);
+		return iUp;
+	};
+
+	if (difference > 1) {
+		return rotateUp(iC, c, b, true);
+	}
+	if (difference < -1) {
+		return rotateUp(iB, b, c, false);
+	}
+	return iA;
+}
+
+AABB DynamicAABBTree::fatten(const AABB& bounds, const Vec3& displacement) const {
+	Vec3 extension(margin, margin, margin);
+	AABB fat(bounds.min - extension, bounds.max + extension);
+
+	// Extend ahead of the movement so the next few moves fit
+	Vec3 d = displacement * displacementScale;
+	(d.x < 0.0f ? fat.min.x : fat.max.x) += d.x;
+	(d.y < 0.0f ? fat.min.y : fat.max.y) += d.y;
+	(d.z < 0.0f ? fat.min.z : fat.max.z) += d.z;
+	return fat;
+}
+
+bool DynamicAABBTree::traverse(const Ray& ray, RayHit& hit, float maxDistance, bool anyHit) const {
+	if (root == NullProxy) {
+		return false;
+	}
+
+	float closest = maxDistance;
+	bool found = false;
+
+	traversal::StackEntry stack[StackSize];
+	uint32_t stackSize = 0;
+	float entry;
+	if (traversal::RayHitsBox(ray, nodes[root].bounds, closest, entry)) {
+		stack[stackSize++] = { root, entry };
+	}
+
+	while (stackSize > 0) {
+		traversal::StackEntry current = stack[--stackSize];
+		if (current.entry > closest) {
+			continue;
+		}
+
+		const Node& node = nodes[current.node];
+		if (node.height == 0) {
+			float distance;
+			if (rayIntersectsAABB(ray, tightBounds[current.node], distance) &&
+				traversal::IsCloserHit(distance, current.node, closest, found, hit.index)) {
+				closest = distance;
+				hit.index = current.node;
+				hit.distance = distance;
+				found = true;
+				if (anyHit) {
+					return true;
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so later boxes can be pruned
+		float entry1;
+		float entry2;
+		bool hit1 = traversal::RayHitsBox(ray, nodes[node.child1].bounds, closest, entry1);
+		bool hit2 = traversal::RayHitsBox(ray, nodes[node.child2].bounds, closest, entry2);
+
+		if (hit1 && hit2) {
+			if (entry1 <= entry2) {
+				stack[stackSize++] = { node.child2, entry2 };
+				stack[stackSize++] = { node.child1, entry1 };
+			}
+			else {
+				stack[stackSize++] = { node.child1, entry1 };
+				stack[stackSize++] = { node.child2, entry2 };
+			}
+		}
+		else if (hit1) {
+			stack[stackSize++] = { node.child1, entry1 };
+		}
+		else if (hit2) {
+			stack[stackSize++] = { node.child2, entry2 };
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file Frustum.cpp
+ * @brief Implementation of the view frustum
+ */
+
+#include "../include/Frustum.hpp"
+
+#include <cmath>
+
+namespace {
+
+/// Signed distance of the box corner furthest along the plane normal
+inline float FurthestCorner(const Vec4& plane, const AABB& box) {
+	float x = plane.x >= 0.0f ? box.max.x : box.min.x;
+	float y = plane.y >= 0.0f ? box.max.y : box.min.y;
+	float z = plane.z >= 0.0f ? box.max.z : box.min.z;
+	return plane.x * x + plane.y * y + plane.z * z + plane.w;
+}
+
+/// Signed distance of the box corner furthest against the plane normal
+inline float NearestCorner(const Vec4& plane, const AABB& box) {
+	float x = plane.x >= 0.0f ? box.min.x : box.max.x;
+	float y = plane.y >= 0.0f ? box.min.y : box.max.y;
+	float z = plane.z >= 0.0f ? box.min.z : box.max.z;
+	return plane.x * x + plane.y * y + plane.z * z + plane.w;
+}
+
+inline float SignedDistance(const Vec4& plane, const Vec3& point) {
+	return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+} // namespace
+
+// Constructors
+Frustum::Frustum() {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		planes[i] = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Frustum::Frustum(const Mat4& viewProjection) {
+	const Mat4& m = viewProjection;
+	Vec4 rows[4];
+	for (int row = 0; row < 4; row++) {
+		rows[row] = Vec4(m.at(row, 0), m.at(row, 1), m.at(row, 2), m.at(row, 3));
+	}
+
+	// Clip-space tests -w <= x, y, z <= w become w + x >= 0 and w - x >= 0
+	planes[Left] = rows[3] + rows[0];
+	planes[Right] = rows[3] - rows[0];
+	planes[Bottom] = rows[3] + rows[1];
+	planes[Top] = rows[3] - rows[1];
+	planes[Near] = rows[3] + rows[2];
+	planes[Far] = rows[3] - rows[2];
+
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		Vec4& plane = planes[i];
+		float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f) {
+			plane = plane / length;
+		}
+	}
+}
+
+Frustum::Frustum(const Vec4 newPlanes[PlaneCount]) {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		planes[i] = newPlanes[i];
+	}
+}
+
+// Tests
+bool Frustum::contains(const Vec3& point) const {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		if (SignedDistance(planes[i], point) < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		if (FurthestCorner(planes[i], box) < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::intersects(const Sphere& sphere) const {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		if (SignedDistance(planes[i], sphere.center) < -sphere.radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Frustum::Classification Frustum::classify(const AABB& box, uint32_t& planeMask) const {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		uint32_t bit = 1u << i;
+		if (!(planeMask & bit)) {
+			continue;
+		}
+		if (FurthestCorner(planes[i], box) < 0.0f) {
+			return Outside;
+		}
+		if (NearestCorner(planes[i], box) >= 0.0f) {
+			planeMask &= ~bit;
+		}
+	}
+	return planeMask == 0 ? Inside : Intersecting;
+}
+
+Frustum::Classification Frustum::classify(const Sphere& sphere, uint32_t& planeMask) const {
+	for (uint32_t i = 0; i < PlaneCount; i++) {
+		uint32_t bit = 1u << i;
+		if (!(planeMask & bit)) {
+			continue;
+		}
+		float distance = SignedDistance(planes[i], sphere.center);
+		if (distance < -sphere.radius) {
+			return Outside;
+		}
+		if (distance >= sphere.radius) {
+			planeMask &= ~bit;
+		}
+	}
+	return planeMask == 0 ? Inside : Intersecting;
+}
+
+Frustum::Classification Frustum::classify(const AABB& box) const {
+	uint32_t planeMask = AllPlanes;
+	return classify(box, planeMask);
+}
+
+Frustum::Classification Frustum::classify(const Sphere& sphere) const {
+	uint32_t planeMask = AllPlanes;
+	return classify(sphere, planeMask);
+}
@@ -0,0 +1,410 @@
+/**
+ * @file LooseOctree.cpp
+ * @brief Implementation of the loose octree
+ */
+
+#include "../include/LooseOctree.hpp"
+#include "RayTraversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+/// Most nodes a traversal stack can hold: each level replaces one node by at most eight
+constexpr uint32_t StackSize = 7 * LooseOctree::MaxDepthLimit + 1;
+
+} // namespace
+
+// Constructors
+LooseOctree::LooseOctree(const AABB& worldBounds, uint32_t maxDepth)
+	: worldMin(worldBounds.min),
+	maxDepth(maxDepth) {
+	assert(maxDepth <= MaxDepthLimit && "Octree depth limit exceeded");
+	Vec3 size = worldBounds.max - worldBounds.min;
+	worldSize = std::max(size.x, std::max(size.y, size.z));
+	assert(worldSize > 0.0f && "World bounds must not be empty");
+	clear();
+}
+
+uint32_t LooseOctree::insert(const AABB& bounds) {
+	uint32_t object = allocateObject();
+	objects[object].bounds = bounds;
+	objects[object].isSphere = false;
+	uint32_t depth;
+	uint32_t cell[3];
+	locate(bounds, depth, cell);
+	link(object, depth, cell);
+	return object;
+}
+
+uint32_t LooseOctree::insert(const Sphere& sphere) {
+	uint32_t object = allocateObject();
+	Vec3 extents(sphere.radius, sphere.radius, sphere.radius);
+	objects[object].bounds = AABB(sphere.center - extents, sphere.center + extents);
+	objects[object].sphere = sphere;
+	objects[object].isSphere = true;
+	uint32_t depth;
+	uint32_t cell[3];
+	locate(objects[object].bounds, depth, cell);
+	link(object, depth, cell);
+	return object;
+}
+
+void LooseOctree::remove(uint32_t object) {
+	assert(object < objects.size() && objects[object].node != NullObject && "Invalid object");
+	unlink(object);
+	objects[object].next = freeObjects;
+	freeObjects = object;
+	objectCount--;
+}
+
+void LooseOctree::update(uint32_t object, const AABB& bounds) {
+	assert(object < objects.size() && objects[object].node != NullObject && "Invalid object");
+	objects[object].isSphere = false;
+	relocate(object, bounds);
+}
+
+void LooseOctree::update(uint32_t object, const Sphere& sphere) {
+	assert(object < objects.size() && objects[object].node != NullObject && "Invalid object");
+	Vec3 extents(sphere.radius, sphere.radius, sphere.radius);
+	objects[object].sphere = sphere;
+	objects[object].isSphere = true;
+	relocate(object, AABB(sphere.center - extents, sphere.center + extents));
+}
+
+void LooseOctree::clear() {
+	nodes.clear();
+	objects.clear();
+	freeNodes = NullObject;
+	freeObjects = NullObject;
+	objectCount = 0;
+
+	// The root always exists; its bounds are only used to derive its children
+	Node root;
+	float half = 0.5f * worldSize;
+	Vec3 grow(half, half, half);
+	root.bounds = AABB(worldMin - grow, worldMin + Vec3(worldSize, worldSize, worldSize) + grow);
+	std::fill(root.children, root.children + 8, NullObject);
+	root.parent = NullObject;
+	root.firstObject = NullObject;
+	root.objectCount = 0;
+	std::fill(root.cell, root.cell + 3, static_cast<uint16_t>(0));
+	root.octant = 0;
+	root.depth = 0;
+	nodes.push_back(root);
+	nodeCount = 1;
+}
+
+size_t LooseOctree::size() const {
+	return objectCount;
+}
+
+size_t LooseOctree::getNodeCount() const {
+	return nodeCount;
+}
+
+uint32_t LooseOctree::getObjectDepth(uint32_t object) const {
+	assert(object < objects.size() && objects[object].node != NullObject && "Invalid object");
+	return nodes[objects[object].node].depth;
+}
+
+const AABB& LooseOctree::getBounds(uint32_t object) const {
+	assert(object < objects.size() && objects[object].node != NullObject && "Invalid object");
+	return objects[object].bounds;
+}
+
+// Queries
+void LooseOctree::queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const {
+	collect(
+		[&](const AABB& bounds) { return aabbIntersectsAABB(bounds, box); },
+		[&](const Object& object) {
+			return object.isSphere
+				? sphereIntersectsAABB(object.sphere, box)
+				: aabbIntersectsAABB(object.bounds, box);
+		},
+		results);
+}
+
+void LooseOctree::queryFrustum(const Vec4 planes[6], std::vector<uint32_t>& results) const {
+	queryFrustum(Frustum(planes), results);
+}
+
+void LooseOctree::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const {
+	results.clear();
+
+	// Pending node with the planes its bounds straddle; 0 means entirely inside the frustum
+	struct PendingNode {
+		uint32_t node;
+		uint32_t planeMask;
+	};
+	PendingNode stack[StackSize];
+	uint32_t stackSize = 0;
+
+	// The root is visited unconditionally and its objects see every plane, since it also
+	// holds objects outside the world. Any other object lies inside its node's bounds.
+	stack[stackSize++] = { 0, Frustum::AllPlanes };
+
+	while (stackSize > 0) {
+		PendingNode current = stack[--stackSize];
+		const Node& node = nodes[current.node];
+		for (uint32_t i = node.firstObject; i != NullObject; i = objects[i].next) {
+			uint32_t planeMask = current.planeMask;
+			const Object& object = objects[i];
+			bool visible = planeMask == 0 || (object.isSphere
+				? frustum.classify(object.sphere, planeMask)
+				: frustum.classify(object.bounds, planeMask)) != Frustum::Outside;
+			if (visible) {
+				results.push_back(i);
+			}
+		}
+		for (uint32_t octant = 0; octant < 8; octant++) {
+			uint32_t child = node.children[octant];
+			uint32_t planeMask = current.planeMask;
+			if (child != NullObject &&
+				(planeMask == 0 || frustum.classify(nodes[child].bounds, planeMask) != Frustum::Outside)) {
+				stack[stackSize++] = { child, planeMask };
+			}
+		}
+	}
+}
+
+bool LooseOctree::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	float closest = maxDistance;
+	bool found = false;
+
+	// The root also holds objects outside the world, so it is always visited
+	traversal::StackEntry stack[StackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = { 0, 0.0f };
+
+	while (stackSize > 0) {
+		traversal::StackEntry current = stack[--stackSize];
+
+		// A closer hit was found after this node was pushed
+		if (current.entry > closest) {
+			continue;
+		}
+
+		const Node& node = nodes[current.node];
+		for (uint32_t i = node.firstObject; i != NullObject; i = objects[i].next) {
+			float distance;
+			if (intersectObject(ray, objects[i], distance) &&
+				traversal::IsCloserHit(distance, i, closest, found, hit.index)) {
+				closest = distance;
+				hit.index = i;
+				hit.distance = distance;
+				found = true;
+			}
+		}
+
+		// Loose children overlap, so sort the hit ones and push the nearest last
+		traversal::StackEntry children[8];
+		uint32_t childCount = 0;
+		for (uint32_t octant = 0; octant < 8; octant++) {
+			uint32_t child = node.children[octant];
+			float entry;
+			if (child != NullObject && traversal::RayHitsBox(ray, nodes[child].bounds, closest, entry)) {
+				uint32_t j = childCount++;
+				while (j > 0 && children[j - 1].entry < entry) {
+					children[j] = children[j - 1];
+					j--;
+				}
+				children[j] = { child, entry };
+			}
+		}
+		for (uint32_t i = 0; i < childCount; i++) {
+			stack[stackSize++] = children[i];
+		}
+	}
+
+	return found;
+}
+
+// Internal helpers
+uint32_t LooseOctree::allocateObject() {
+	uint32_t object;
+	if (freeObjects != NullObject) {
+		object = freeObjects;
+		freeObjects = objects[object].next;
+	}
+	else {
+		object = static_cast<uint32_t>(objects.size());
+		objects.push_back(Object());
+	}
+	objectCount++;
+	return object;
+}
+
+uint32_t LooseOctree::allocateNode(uint32_t parent, uint32_t octant, uint32_t depth, const uint32_t cell[3]) {
+	uint32_t index;
+	if (freeNodes != NullObject) {
+		index = freeNodes;
+		freeNodes = nodes[index].parent;
+	}
+	else {
+		index = static_cast<uint32_t>(nodes.size());
+		nodes.push_back(Node());
+	}
+
+	// Loose bounds: the cell grown by half a cell on every side, padded by a hair so
+	// rounding in the cell arithmetic can never leave an object poking out
+	float cellSize = std::ldexp(worldSize, -static_cast<int>(depth));
+	float grow = cellSize * (0.5f + 1.0f / 1024.0f);
+	Vec3 cellMin(worldMin.x + static_cast<float>(cell[0]) * cellSize,
+		worldMin.y + static_cast<float>(cell[1]) * cellSize,
+		worldMin.z + static_cast<float>(cell[2]) * cellSize);
+
+	Node& node = nodes[index];
+	node.bounds = AABB(cellMin - Vec3(grow, grow, grow), cellMin + Vec3(cellSize + grow, cellSize + grow, cellSize + grow));
+	std::fill(node.children, node.children + 8, NullObject);
+	node.parent = parent;
+	node.firstObject = NullObject;
+	node.objectCount = 0;
+	for (int axis = 0; axis < 3; axis++) {
+		node.cell[axis] = static_cast<uint16_t>(cell[axis]);
+	}
+	node.octant = static_cast<uint8_t>(octant);
+	node.depth = static_cast<uint8_t>(depth);
+	nodes[parent].children[octant] = index;
+	nodeCount++;
+	return index;
+}
+
+void LooseOctree::locate(const AABB& bounds, uint32_t& depth, uint32_t cell[3]) const {
+	Vec3 size = bounds.max - bounds.min;
+	float extent = std::max(size.x, std::max(size.y, size.z));
+	Vec3 offset = (bounds.min + bounds.max) * 0.5f - worldMin;
+
+	// Depth straight from the size: the deepest level whose cells are at least as large as the object
+	depth = 0;
+	bool inWorld = offset.x >= 0.0f && offset.y >= 0.0f && offset.z >= 0.0f &&
+		offset.x <= worldSize && offset.y <= worldSize && offset.z <= worldSize;
+	if (inWorld && extent <= worldSize) {
+		if (extent <= std::ldexp(worldSize, -static_cast<int>(maxDepth))) {
+			depth = maxDepth;
+		}
+		else {
+			int exponent;
+			std::frexp(worldSize / extent, &exponent);
+			depth = static_cast<uint32_t>(std::min(std::max(exponent - 1, 0), static_cast<int>(maxDepth)));
+			while (depth > 0 && extent > std::ldexp(worldSize, -static_cast<int>(depth))) {
+				depth--;
+			}
+		}
+	}
+
+	// Cell of the center at that depth
+	std::fill(cell, cell + 3, 0u);
+	if (depth > 0) {
+		float inverseCellSize = std::ldexp(1.0f / worldSize, static_cast<int>(depth));
+		uint32_t last = (1u << depth) - 1;
+		const float components[3] = { offset.x, offset.y, offset.z };
+		for (int axis = 0; axis < 3; axis++) {
+			cell[axis] = std::min(static_cast<uint32_t>(components[axis] * inverseCellSize), last);
+		}
+	}
+}
+
+void LooseOctree::link(uint32_t object, uint32_t depth, const uint32_t cell[3]) {
+	// Walk down to the cell, creating missing nodes
+	uint32_t node = 0;
+	nodes[0].objectCount++;
+	for (uint32_t level = 1; level <= depth; level++) {
+		uint32_t shift = depth - level;
+		uint32_t octant = ((cell[0] >> shift) & 1u) | (((cell[1] >> shift) & 1u) << 1) | (((cell[2] >> shift) & 1u) << 2);
+		uint32_t child = nodes[node].children[octant];
+		if (child == NullObject) {
+			const uint32_t childCell[3] = { cell[0] >> shift, cell[1] >> shift, cell[2] >> shift };
+			child = allocateNode(node, octant, level, childCell);
+		}
+		node = child;
+		nodes[node].objectCount++;
+	}
+
+	Object& stored = objects[object];
+	stored.node = node;
+	stored.prev = NullObject;
+	stored.next = nodes[node].firstObject;
+	if (stored.next != NullObject) {
+		objects[stored.next].prev = object;
+	}
+	nodes[node].firstObject = object;
+}
+
+void LooseOctree::unlink(uint32_t object) {
+	Object& stored = objects[object];
+	uint32_t node = stored.node;
+	if (stored.prev != NullObject) {
+		objects[stored.prev].next = stored.next;
+	}
+	else {
+		nodes[node].firstObject = stored.next;
+	}
+	if (stored.next != NullObject) {
+		objects[stored.next].prev = stored.prev;
+	}
+	stored.node = NullObject;
+
+	// Walk back to the root, returning nodes whose subtree is now empty to the pool
+	while (node != 0) {
+		Node& current = nodes[node];
+		uint32_t parent = current.parent;
+		if (--current.objectCount == 0) {
+			nodes[parent].children[current.octant] = NullObject;
+			current.parent = freeNodes;
+			freeNodes = node;
+			nodeCount--;
+		}
+		node = parent;
+	}
+	nodes[0].objectCount--;
+}
+
+void LooseOctree::relocate(uint32_t object, const AABB& bounds) {
+	uint32_t depth;
+	uint32_t cell[3];
+	locate(bounds, depth, cell);
+	objects[object].bounds = bounds;
+
+	// Most moves stay within the same cell
+	const Node& node = nodes[objects[object].node];
+	if (node.depth == depth && node.cell[0] == cell[0] && node.cell[1] == cell[1] && node.cell[2] == cell[2]) {
+		return;
+	}
+	unlink(object);
+	link(object, depth, cell);
+}
+
+bool LooseOctree::intersectObject(const Ray& ray, const Object& object, float& distance) const {
+	if (object.isSphere) {
+		return rayIntersectsSphere(ray, object.sphere, distance);
+	}
+	return rayIntersectsAABB(ray, object.bounds, distance);
+}
+
+template<typename NodeTest, typename ObjectTest>
+void LooseOctree::collect(const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector<uint32_t>& results) const {
+	results.clear();
+
+	// The root is visited unconditionally since it also holds objects outside the world
+	uint32_t stack[StackSize];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const Node& node = nodes[stack[--stackSize]];
+		for (uint32_t i = node.firstObject; i != NullObject; i = objects[i].next) {
+			if (objectTest(objects[i])) {
+				results.push_back(i);
+			}
+		}
+		for (uint32_t octant = 0; octant < 8; octant++) {
+			uint32_t child = node.children[octant];
+			if (child != NullObject && nodeTest(nodes[child].bounds)) {
+				stack[stackSize++] = child;
+			}
+		}
+	}
+}
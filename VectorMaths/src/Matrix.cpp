@@ -256,6 +256,44 @@ Mat4 Mat4::inverse() const {
 	return adjugate_matrix * (1 / determinant);
 }
 
+Mat4 Mat4::affineInverse() const {
+	// Cofactors of the upper 3x3 block
+	float c00 = m[5] * m[10] - m[9] * m[6];
+	float c01 = m[8] * m[6] - m[4] * m[10];
+	float c02 = m[4] * m[9] - m[8] * m[5];
+
+	float determinant = m[0] * c00 + m[1] * c01 + m[2] * c02;
+
+	// Check for non-invertible matrix
+	if (std::abs(determinant) < 1e-12f) {
+		return Mat4();
+	}
+
+	float inv = 1.0f / determinant;
+
+	// Inverse of the 3x3 block (column-major)
+	float a0 = c00 * inv;
+	float a1 = (m[9] * m[2] - m[1] * m[10]) * inv;
+	float a2 = (m[1] * m[6] - m[5] * m[2]) * inv;
+	float a4 = c01 * inv;
+	float a5 = (m[0] * m[10] - m[8] * m[2]) * inv;
+	float a6 = (m[4] * m[2] - m[0] * m[6]) * inv;
+	float a8 = c02 * inv;
+	float a9 = (m[8] * m[1] - m[0] * m[9]) * inv;
+	float a10 = (m[0] * m[5] - m[4] * m[1]) * inv;
+
+	float result[16] = {
+		a0, a1, a2, 0.0f,
+		a4, a5, a6, 0.0f,
+		a8, a9, a10, 0.0f,
+		-(a0 * m[12] + a4 * m[13] + a8 * m[14]),
+		-(a1 * m[12] + a5 * m[13] + a9 * m[14]),
+		-(a2 * m[12] + a6 * m[13] + a10 * m[14]),
+		1.0f
+	};
+	return Mat4(result);
+}
+
 Mat4 Mat4::transpose() const {
 	float result[16] = {
 		m[0], m[4], m[8], m[12],
@@ -0,0 +1,341 @@
+/**
+ * @file PrimitiveArrays.cpp
+ * @brief Implementation of the structure-of-arrays primitive sets
+ */
+
+#include "../include/PrimitiveArrays.hpp"
+#include "RayTraversal.hpp"
+#include "Simd.hpp"
+
+#include <cassert>
+
+namespace {
+
+/// Kernels always read four entries; arrays are padded to a multiple of this
+const size_t BlockSize = 4;
+
+/// Lanes of the block starting at first that hold an entry
+inline uint32_t ValidLanes(size_t count, size_t first) {
+	size_t remaining = count - first;
+	return remaining >= BlockSize ? 0xFu : (1u << remaining) - 1u;
+}
+
+/// Number of set bits in a 4-bit lane mask
+inline uint32_t LaneCount(uint32_t lanes) {
+	static const uint8_t counts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+	return counts[lanes];
+}
+
+/// Resizes component arrays to hold count entries plus zero padding
+void ResizePadded(std::vector<float>* arrays[], size_t arrayCount, size_t count) {
+	size_t padded = (count + BlockSize - 1) / BlockSize * BlockSize;
+	for (size_t i = 0; i < arrayCount; i++) {
+		arrays[i]->resize(padded, 0.0f);
+	}
+}
+
+/**
+ * @brief Closest hit over an array, four entries per kernel call
+ *
+ * The kernel is called as kernel(first, maxDistance, distance) and returns the
+ * lanes of entries [first, first + 4) that hit within maxDistance. Passing
+ * the closest distance found so far prunes later blocks early.
+ */
+template<typename Kernel>
+bool ClosestHit(size_t count, float maxDistance, RayHit& hit, const Kernel& kernel) {
+	float closest = maxDistance;
+	bool found = false;
+	for (size_t first = 0; first < count; first += BlockSize) {
+		float distance[BlockSize];
+		uint32_t lanes = kernel(first, closest, distance) & ValidLanes(count, first);
+		for (uint32_t lane = 0; lanes != 0; lane++, lanes >>= 1) {
+			uint32_t index = static_cast<uint32_t>(first + lane);
+			if ((lanes & 1u) && traversal::IsCloserHit(distance[lane], index, closest, found, hit.index)) {
+				closest = distance[lane];
+				hit.index = index;
+				hit.distance = distance[lane];
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+/**
+ * @brief Collects the kernel's lanes into one bit per entry
+ *
+ * The kernel is called as kernel(first) and returns the lanes of entries
+ * [first, first + 4) that pass. Returns the number of bits set.
+ */
+template<typename Kernel>
+size_t CollectMask(size_t count, std::vector<uint32_t>& mask, const Kernel& kernel) {
+	mask.assign((count + 31) / 32, 0u);
+	size_t hits = 0;
+	for (size_t first = 0; first < count; first += BlockSize) {
+		uint32_t lanes = kernel(first) & ValidLanes(count, first);
+
+		// Blocks of four never straddle a 32-bit word
+		mask[first / 32] |= lanes << (first % 32);
+		hits += LaneCount(lanes);
+	}
+	return hits;
+}
+
+/// Collects the indices of the kernel's lanes in increasing order (kernel as for CollectMask)
+template<typename Kernel>
+void CollectIndices(size_t count, std::vector<uint32_t>& results, const Kernel& kernel) {
+	results.clear();
+	for (size_t first = 0; first < count; first += BlockSize) {
+		uint32_t lanes = kernel(first) & ValidLanes(count, first);
+		for (uint32_t lane = 0; lanes != 0; lane++, lanes >>= 1) {
+			if (lanes & 1u) {
+				results.push_back(static_cast<uint32_t>(first + lane));
+			}
+		}
+	}
+}
+
+} // namespace
+
+// SphereArray
+SphereArray::SphereArray() : count(0) {}
+
+SphereArray::SphereArray(const Sphere* spheres, size_t count) : count(0) {
+	assign(spheres, count);
+}
+
+void SphereArray::assign(const Sphere* spheres, size_t newCount) {
+	clear();
+	count = newCount;
+	std::vector<float>* arrays[] = { &centerX, &centerY, &centerZ, &radius };
+	ResizePadded(arrays, 4, count);
+	for (size_t i = 0; i < count; i++) {
+		set(i, spheres[i]);
+	}
+}
+
+void SphereArray::add(const Sphere& sphere) {
+	std::vector<float>* arrays[] = { &centerX, &centerY, &centerZ, &radius };
+	ResizePadded(arrays, 4, ++count);
+	set(count - 1, sphere);
+}
+
+void SphereArray::set(size_t index, const Sphere& sphere) {
+	assert(index < count);
+	centerX[index] = sphere.center.x;
+	centerY[index] = sphere.center.y;
+	centerZ[index] = sphere.center.z;
+	radius[index] = sphere.radius;
+}
+
+Sphere SphereArray::get(size_t index) const {
+	assert(index < count);
+	return Sphere(Vec3(centerX[index], centerY[index], centerZ[index]), radius[index]);
+}
+
+void SphereArray::clear() {
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	radius.clear();
+	count = 0;
+}
+
+size_t SphereArray::size() const {
+	return count;
+}
+
+bool SphereArray::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	return ClosestHit(count, maxDistance, hit, [&](size_t first, float limit, float* distance) {
+		return simd::RayHitsSpheres(ray, &centerX[first], &centerY[first], &centerZ[first], &radius[first],
+			limit, distance);
+	});
+}
+
+size_t SphereArray::raycastMask(const Ray& ray, std::vector<uint32_t>& mask, float maxDistance) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		float distance[BlockSize];
+		return simd::RayHitsSpheres(ray, &centerX[first], &centerY[first], &centerZ[first], &radius[first],
+			maxDistance, distance);
+	});
+}
+
+size_t SphereArray::frustumMask(const Frustum& frustum, std::vector<uint32_t>& mask) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		return simd::SpheresInFrustum(&centerX[first], &centerY[first], &centerZ[first], &radius[first], frustum);
+	});
+}
+
+// AABBArray
+AABBArray::AABBArray() : count(0) {}
+
+AABBArray::AABBArray(const AABB* boxes, size_t count) : count(0) {
+	assign(boxes, count);
+}
+
+void AABBArray::assign(const AABB* boxes, size_t newCount) {
+	clear();
+	count = newCount;
+	std::vector<float>* arrays[] = { &minX, &minY, &minZ, &maxX, &maxY, &maxZ };
+	ResizePadded(arrays, 6, count);
+	for (size_t i = 0; i < count; i++) {
+		set(i, boxes[i]);
+	}
+}
+
+void AABBArray::add(const AABB& box) {
+	std::vector<float>* arrays[] = { &minX, &minY, &minZ, &maxX, &maxY, &maxZ };
+	ResizePadded(arrays, 6, ++count);
+	set(count - 1, box);
+}
+
+void AABBArray::set(size_t index, const AABB& box) {
+	assert(index < count);
+	minX[index] = box.min.x;
+	minY[index] = box.min.y;
+	minZ[index] = box.min.z;
+	maxX[index] = box.max.x;
+	maxY[index] = box.max.y;
+	maxZ[index] = box.max.z;
+}
+
+AABB AABBArray::get(size_t index) const {
+	assert(index < count);
+	return AABB(Vec3(minX[index], minY[index], minZ[index]), Vec3(maxX[index], maxY[index], maxZ[index]));
+}
+
+void AABBArray::clear() {
+	minX.clear();
+	minY.clear();
+	minZ.clear();
+	maxX.clear();
+	maxY.clear();
+	maxZ.clear();
+	count = 0;
+}
+
+size_t AABBArray::size() const {
+	return count;
+}
+
+bool AABBArray::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	return ClosestHit(count, maxDistance, hit, [&](size_t first, float limit, float* distance) {
+		return simd::RayHitsBoxes(ray, &minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], limit, distance);
+	});
+}
+
+size_t AABBArray::raycastMask(const Ray& ray, std::vector<uint32_t>& mask, float maxDistance) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		float distance[BlockSize];
+		return simd::RayHitsBoxes(ray, &minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], maxDistance, distance);
+	});
+}
+
+size_t AABBArray::overlapMask(const AABB& box, std::vector<uint32_t>& mask) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		return simd::BoxesOverlapBox(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], box);
+	});
+}
+
+size_t AABBArray::overlapMask(const Sphere& sphere, std::vector<uint32_t>& mask) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		return simd::BoxesOverlapSphere(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], sphere);
+	});
+}
+
+size_t AABBArray::containingMask(const Vec3& point, std::vector<uint32_t>& mask) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		return simd::BoxesContainPoint(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], point);
+	});
+}
+
+void AABBArray::queryOverlaps(const AABB& box, std::vector<uint32_t>& results) const {
+	CollectIndices(count, results, [&](size_t first) {
+		return simd::BoxesOverlapBox(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], box);
+	});
+}
+
+void AABBArray::queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const {
+	CollectIndices(count, results, [&](size_t first) {
+		return simd::BoxesOverlapSphere(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], sphere);
+	});
+}
+
+void AABBArray::queryContaining(const Vec3& point, std::vector<uint32_t>& results) const {
+	CollectIndices(count, results, [&](size_t first) {
+		return simd::BoxesContainPoint(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], point);
+	});
+}
+
+size_t AABBArray::frustumMask(const Frustum& frustum, std::vector<uint32_t>& mask) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		return simd::BoxesInFrustum(&minX[first], &minY[first], &minZ[first],
+			&maxX[first], &maxY[first], &maxZ[first], frustum);
+	});
+}
+
+// PlaneArray
+PlaneArray::PlaneArray() : count(0) {}
+
+void PlaneArray::add(const Vec3& normal, const Vec3& point) {
+	std::vector<float>* arrays[] = { &normalX, &normalY, &normalZ, &pointX, &pointY, &pointZ };
+	ResizePadded(arrays, 6, ++count);
+	set(count - 1, normal, point);
+}
+
+void PlaneArray::set(size_t index, const Vec3& normal, const Vec3& point) {
+	assert(index < count);
+	normalX[index] = normal.x;
+	normalY[index] = normal.y;
+	normalZ[index] = normal.z;
+	pointX[index] = point.x;
+	pointY[index] = point.y;
+	pointZ[index] = point.z;
+}
+
+Vec3 PlaneArray::getNormal(size_t index) const {
+	assert(index < count);
+	return Vec3(normalX[index], normalY[index], normalZ[index]);
+}
+
+Vec3 PlaneArray::getPoint(size_t index) const {
+	assert(index < count);
+	return Vec3(pointX[index], pointY[index], pointZ[index]);
+}
+
+void PlaneArray::clear() {
+	normalX.clear();
+	normalY.clear();
+	normalZ.clear();
+	pointX.clear();
+	pointY.clear();
+	pointZ.clear();
+	count = 0;
+}
+
+size_t PlaneArray::size() const {
+	return count;
+}
+
+bool PlaneArray::raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+	return ClosestHit(count, maxDistance, hit, [&](size_t first, float limit, float* distance) {
+		return simd::RayHitsPlanes(ray, &normalX[first], &normalY[first], &normalZ[first],
+			&pointX[first], &pointY[first], &pointZ[first], limit, distance);
+	});
+}
+
+size_t PlaneArray::raycastMask(const Ray& ray, std::vector<uint32_t>& mask, float maxDistance) const {
+	return CollectMask(count, mask, [&](size_t first) {
+		float distance[BlockSize];
+		return simd::RayHitsPlanes(ray, &normalX[first], &normalY[first], &normalZ[first],
+			&pointX[first], &pointY[first], &pointZ[first], maxDistance, distance);
+	});
+}
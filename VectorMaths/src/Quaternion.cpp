@@ -53,7 +53,7 @@ Mat4 Quaternion::toRotationMatrix() const {
 	float result[16] = {
 			((2 * ((w * w) + (x * x))) - 1), (2 * ((x * y) + (w * z))), (2 * ((x * z) - (w * y))), 0.0f,
 			(2 * ((x * y) - (w * z))), ((2 * ((w * w) + (y * y))) - 1), (2 * ((y * z) + (w * x))), 0.0f,
-			(2 * ((x * z) + (w * y))), (2 * (y * z) - (w * x)), ((2 * ((w * w) + (z * z))) - 1), 0.0f,
+			(2 * ((x * z) + (w * y))), (2 * ((y * z) - (w * x))), ((2 * ((w * w) + (z * z))) - 1), 0.0f,
 			0.0f, 0.0f, 0.0f, 1.0f
 	};
 
@@ -101,27 +101,27 @@ Quaternion Quaternion::fromRotationMatrix(Mat3 rotMat) {
 	float trace = rotMat.m[0] + rotMat.m[4] + rotMat.m[8];
 
 	if (trace > 0) {
-		w = std::sqrt((trace + 1) / 2);
+		w = std::sqrt(trace + 1) / 2;
 		x = (rotMat.m[5] - rotMat.m[7]) / (4 * w);
 		y = (rotMat.m[6] - rotMat.m[2]) / (4 * w);
 		z = (rotMat.m[1] - rotMat.m[3]) / (4 * w);
 	}
 	else {
 		if ((rotMat.m[0] > rotMat.m[4]) && (rotMat.m[0] > rotMat.m[8])) {
-			x = std::sqrt((1 + (rotMat.m[0] - rotMat.m[4] - rotMat.m[8])) / 2);
+			x = std::sqrt(1 + (rotMat.m[0] - rotMat.m[4] - rotMat.m[8])) / 2;
 			y = (rotMat.m[3] + rotMat.m[1]) / (4 * x);
 			z = (rotMat.m[6] + rotMat.m[2]) / (4 * x);
 			w = (rotMat.m[5] - rotMat.m[7]) / (4 * x);
 
 		}
 		else if (rotMat.m[4] > rotMat.m[8]) {
-			y = std::sqrt((1 + (rotMat.m[4] - rotMat.m[0] - rotMat.m[8])) / 2);
+			y = std::sqrt(1 + (rotMat.m[4] - rotMat.m[0] - rotMat.m[8])) / 2;
 			z = (rotMat.m[7] + rotMat.m[5]) / (4 * y);
 			w = (rotMat.m[6] - rotMat.m[2]) / (4 * y);
 			x = (rotMat.m[3] + rotMat.m[1]) / (4 * y);
 		}
 		else {
-			z = std::sqrt((1 + (rotMat.m[8] - rotMat.m[0] - rotMat.m[4])) / 2);
+			z = std::sqrt(1 + (rotMat.m[8] - rotMat.m[0] - rotMat.m[4])) / 2;
 			w = (rotMat.m[1] - rotMat.m[3]) / (4 * z);
 			x = (rotMat.m[6] + rotMat.m[2]) / (4 * z);
 			y = (rotMat.m[7] + rotMat.m[5]) / (4 * z);
@@ -214,4 +214,12 @@ Quaternion Quaternion::slerp(const Quaternion& a, Quaternion b, float t) {
 	return (w1 * a) + (w2 * b);
 }
 
+Quaternion Quaternion::nlerp(const Quaternion& a, Quaternion b, float t) {
+	float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+	if (dot < 0.0f) {
+		b = -b;
+	}
 
+	Quaternion result = a + t * (b - a);
+	return result.normalised();
+}
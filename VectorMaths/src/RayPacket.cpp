@@ -0,0 +1,107 @@
+/**
+ * @file RayPacket.cpp
+ * @brief Implementation of ray packets and packet queries over primitive arrays
+ */
+
+#include "../include/RayPacket.hpp"
+#include "RayTraversal.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// Constructors
+RayPacket::RayPacket() : activeMask(0) {
+	// Inactive lanes hold a harmless ray so kernels never read uninitialised values
+	for (uint32_t lane = 0; lane < Width; lane++) {
+		originX[lane] = originY[lane] = originZ[lane] = 0.0f;
+		directionX[lane] = directionY[lane] = 0.0f;
+		directionZ[lane] = 1.0f;
+		inverseX[lane] = inverseY[lane] = std::numeric_limits<float>::infinity();
+		inverseZ[lane] = 1.0f;
+	}
+}
+
+RayPacket::RayPacket(const Ray* rays, size_t count) : RayPacket() {
+	for (uint32_t lane = 0; lane < Width && lane < count; lane++) {
+		setRay(lane, rays[lane]);
+	}
+}
+
+void RayPacket::setRay(uint32_t lane, const Ray& ray) {
+	originX[lane] = ray.origin.x;
+	originY[lane] = ray.origin.y;
+	originZ[lane] = ray.origin.z;
+	directionX[lane] = ray.getDirection().x;
+	directionY[lane] = ray.getDirection().y;
+	directionZ[lane] = ray.getDirection().z;
+
+	inverseX[lane] = ray.getInverseDirection().x;
+	inverseY[lane] = ray.getInverseDirection().y;
+	inverseZ[lane] = ray.getInverseDirection().z;
+	activeMask |= 1u << lane;
+}
+
+Ray RayPacket::getRay(uint32_t lane) const {
+	// Fill the cache directly (RayPacket is a friend of Ray): setDirection would renormalize
+	Ray ray;
+	ray.origin = Vec3(originX[lane], originY[lane], originZ[lane]);
+	ray.direction = Vec3(directionX[lane], directionY[lane], directionZ[lane]);
+	ray.inverseDirection = Vec3(inverseX[lane], inverseY[lane], inverseZ[lane]);
+	ray.sign[0] = inverseX[lane] < 0.0f ? 1 : 0;
+	ray.sign[1] = inverseY[lane] < 0.0f ? 1 : 0;
+	ray.sign[2] = inverseZ[lane] < 0.0f ? 1 : 0;
+	return ray;
+}
+
+// Packet queries
+uint32_t rayPacketIntersectsAABB(const RayPacket& packet, const AABB& box, float distances[RayPacket::Width]) {
+	return simd::PacketIntersectsAABB(packet, box, distances) & packet.activeMask;
+}
+
+uint32_t raycastPacket(const RayPacket& packet, const AABB* boxes, size_t count, RayHit hits[RayPacket::Width],
+	float maxDistance) {
+	float closest[RayPacket::Width];
+	std::fill(closest, closest + RayPacket::Width, maxDistance);
+	uint32_t found = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		float distance[RayPacket::Width];
+		uint32_t mask = simd::PacketIntersectsAABB(packet, boxes[i], distance) & packet.activeMask;
+		for (uint32_t lane = 0; mask != 0; lane++, mask >>= 1) {
+			uint32_t index = static_cast<uint32_t>(i);
+			if ((mask & 1u) && traversal::IsCloserHit(distance[lane], index, closest[lane], (found >> lane) & 1u, hits[lane].index)) {
+				closest[lane] = distance[lane];
+				hits[lane].index = index;
+				hits[lane].distance = distance[lane];
+				found |= 1u << lane;
+			}
+		}
+	}
+	return found;
+}
+
+uint32_t raycastPacket(const RayPacket& packet, const Sphere* spheres, size_t count, RayHit hits[RayPacket::Width],
+	float maxDistance) {
+	uint32_t found = 0;
+	for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+		if (!((packet.activeMask >> lane) & 1u)) {
+			continue;
+		}
+
+		Ray ray = packet.getRay(lane);
+		float closest = maxDistance;
+		for (size_t i = 0; i < count; i++) {
+			float distance;
+			uint32_t index = static_cast<uint32_t>(i);
+			if (rayIntersectsSphere(ray, spheres[i], distance) &&
+				traversal::IsCloserHit(distance, index, closest, (found >> lane) & 1u, hits[lane].index)) {
+				closest = distance;
+				hits[lane].index = index;
+				hits[lane].distance = distance;
+				found |= 1u << lane;
+			}
+		}
+	}
+	return found;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file RayTraversal.hpp
+ * @brief Internal helpers shared by the ray queries of the bounding volume trees
+ *
+ * Private to the library.
+ */
+
+#pragma once
+
+#include "../include/Collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace traversal {
+
+/**
+ * @brief Entry and exit distances of a ray's line through a box
+ *
+ * Uses the ray's cached inverse direction and signs to pick the near and far
+ * face on each axis, so there are no divisions or swaps. An axis-parallel ray
+ * lying exactly on a face plane gives 0 * infinity = NaN for that axis; the
+ * comparisons below are written so a NaN never replaces the running interval,
+ * which treats the ray as inside that slab (touching counts as a hit).
+ *
+ * @param[out] tMin Entry distance (may be negative)
+ * @param[out] tMax Exit distance; the line misses the box if tMin > tMax
+ */
+inline void SlabInterval(const Ray& ray, const AABB& box, float& tMin, float& tMax) {
+	tMin = -std::numeric_limits<float>::infinity();
+	tMax = std::numeric_limits<float>::infinity();
+
+	const Vec3& inverse = ray.getInverseDirection();
+
+	float tNear = ((ray.getSign(0) ? box.max.x : box.min.x) - ray.origin.x) * inverse.x;
+	float tFar = ((ray.getSign(0) ? box.min.x : box.max.x) - ray.origin.x) * inverse.x;
+	tMin = tNear > tMin ? tNear : tMin;
+	tMax = tFar < tMax ? tFar : tMax;
+
+	tNear = ((ray.getSign(1) ? box.max.y : box.min.y) - ray.origin.y) * inverse.y;
+	tFar = ((ray.getSign(1) ? box.min.y : box.max.y) - ray.origin.y) * inverse.y;
+	tMin = tNear > tMin ? tNear : tMin;
+	tMax = tFar < tMax ? tFar : tMax;
+
+	tNear = ((ray.getSign(2) ? box.max.z : box.min.z) - ray.origin.z) * inverse.z;
+	tFar = ((ray.getSign(2) ? box.min.z : box.max.z) - ray.origin.z) * inverse.z;
+	tMin = tNear > tMin ? tNear : tMin;
+	tMax = tFar < tMax ? tFar : tMax;
+}
+
+/**
+ * @brief Slab test for tree nodes
+ *
+ * Returns the entry distance clamped to [0, maxDistance], so callers can
+ * visit children front to back and prune boxes behind the closest hit.
+ */
+inline bool RayHitsBox(const Ray& ray, const AABB& box, float maxDistance, float& entry) {
+	float tMin;
+	float tMax;
+	SlabInterval(ray, box, tMin, tMax);
+	tMin = std::max(tMin, 0.0f);
+	tMax = std::min(tMax, maxDistance);
+	entry = tMin;
+	return tMin <= tMax;
+}
+
+/// Widening of slab exits in the conservative node test, just over 1 + 2 * gamma(3) (Ize 2013)
+constexpr float ConservativeScale = 1.0f + 4.0f * std::numeric_limits<float>::epsilon();
+
+/**
+ * @brief Node test that never rejects a box the exact ray touches
+ *
+ * As RayHitsBox, but the exit distance is widened by ConservativeScale to
+ * cover the rounding of the slab distances. Watertight triangle traversal
+ * needs this: a shared vertex or edge lying on a node face must reach every
+ * node holding one of its triangles. Prune popped nodes against
+ * closest * ConservativeScale to match.
+ */
+inline bool RayHitsBoxConservative(const Ray& ray, const AABB& box, float maxDistance, float& entry) {
+	float tMin;
+	float tMax;
+	SlabInterval(ray, box, tMin, tMax);
+	tMin = std::max(tMin, 0.0f);
+	tMax = std::min(tMax, maxDistance) * ConservativeScale;
+	entry = tMin;
+	return tMin <= tMax;
+}
+
+/**
+ * @brief Closest-hit rule shared by the ray queries
+ *
+ * Nearer hits win and equal distances go to the lower primitive index, so the
+ * result does not depend on the order primitives are visited in (single rays
+ * and packets walk trees in different orders).
+ */
+inline bool IsCloserHit(float distance, uint32_t index, float closest, bool found, uint32_t closestIndex) {
+	return distance < closest || (distance == closest && (!found || index < closestIndex));
+}
+
+/// Pending node on a traversal stack with its entry distance
+struct StackEntry {
+	uint32_t node;
+	float entry;
+};
+
+/**
+ * @brief Ray prepared for the watertight triangle test (Woop, Benthin and Wald 2013)
+ *
+ * The axes are permuted so z is the ray's dominant axis (x and y swapped when
+ * it points down z, keeping the winding), and the shear factors map the ray
+ * onto the +z axis through the origin. Triangles are then tested in 2D.
+ */
+struct ShearedRay {
+	float origin[3];  ///< Ray origin, subtracted from the vertices
+	int kx;           ///< Axis mapped to x
+	int ky;           ///< Axis mapped to y
+	int kz;           ///< Dominant axis, mapped to z
+	float sx;         ///< Shear of x per unit z
+	float sy;         ///< Shear of y per unit z
+	float sz;         ///< Scale of z (1 / dominant direction component)
+};
+
+/// Computes the permutation and shear of a ray (once per ray, not per triangle)
+inline ShearedRay ShearRay(const Ray& ray) {
+	const Vec3& rayDirection = ray.getDirection();
+	const float direction[3] = { rayDirection.x, rayDirection.y, rayDirection.z };
+	ShearedRay sheared;
+	sheared.origin[0] = ray.origin.x;
+	sheared.origin[1] = ray.origin.y;
+	sheared.origin[2] = ray.origin.z;
+
+	sheared.kz = 0;
+	if (std::abs(direction[1]) > std::abs(direction[sheared.kz])) sheared.kz = 1;
+	if (std::abs(direction[2]) > std::abs(direction[sheared.kz])) sheared.kz = 2;
+	sheared.kx = sheared.kz == 2 ? 0 : sheared.kz + 1;
+	sheared.ky = sheared.kx == 2 ? 0 : sheared.kx + 1;
+	if (direction[sheared.kz] < 0.0f) {
+		std::swap(sheared.kx, sheared.ky);
+	}
+
+	sheared.sx = direction[sheared.kx] / direction[sheared.kz];
+	sheared.sy = direction[sheared.ky] / direction[sheared.kz];
+	sheared.sz = 1.0f / direction[sheared.kz];
+	return sheared;
+}
+
+/**
+ * @brief Watertight ray-triangle test, accepting both faces
+ *
+ * The edge functions U, V, W only depend on an edge's two vertices, and a
+ * triangle sharing that edge evaluates exactly the negated value, so a ray
+ * through a shared edge or vertex hits at least one of the triangles. When an
+ * edge function is exactly zero it is recomputed in double so the sign of a
+ * near-degenerate case is resolved consistently.
+ *
+ * @param[out] distance Distance along the ray (>= 0)
+ * @param[out] u Barycentric weight of b
+ * @param[out] v Barycentric weight of c (a has 1 - u - v)
+ */
+inline bool IntersectTriangle(const ShearedRay& ray, const Vec3& a, const Vec3& b, const Vec3& c,
+	float& distance, float& u, float& v) {
+	const float A[3] = { a.x - ray.origin[0], a.y - ray.origin[1], a.z - ray.origin[2] };
+	const float B[3] = { b.x - ray.origin[0], b.y - ray.origin[1], b.z - ray.origin[2] };
+	const float C[3] = { c.x - ray.origin[0], c.y - ray.origin[1], c.z - ray.origin[2] };
+
+	const float ax = A[ray.kx] - ray.sx * A[ray.kz];
+	const float ay = A[ray.ky] - ray.sy * A[ray.kz];
+	const float bx = B[ray.kx] - ray.sx * B[ray.kz];
+	const float by = B[ray.ky] - ray.sy * B[ray.kz];
+	const float cx = C[ray.kx] - ray.sx * C[ray.kz];
+	const float cy = C[ray.ky] - ray.sy * C[ray.kz];
+
+	float U = cx * by - cy * bx;
+	float V = ax * cy - ay * cx;
+	float W = bx * ay - by * ax;
+	if (U == 0.0f || V == 0.0f || W == 0.0f) {
+		U = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+		V = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+		W = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+	}
+
+	// The ray passes outside an edge if the signs differ
+	if ((U < 0.0f || V < 0.0f || W < 0.0f) && (U > 0.0f || V > 0.0f || W > 0.0f)) {
+		return false;
+	}
+	const float det = U + V + W;
+	if (det == 0.0f) {
+		return false;
+	}
+
+	const float T = U * ray.sz * A[ray.kz] + V * ray.sz * B[ray.kz] + W * ray.sz * C[ray.kz];
+	const float t = T / det;
+
+	// Also rejects the NaN of a zero-length direction
+	if (!(t >= 0.0f)) {
+		return false;
+	}
+
+	distance = t;
+	u = V / det;
+	v = W / det;
+	return true;
+}
+
+} // namespace traversal
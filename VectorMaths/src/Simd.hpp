@@ -0,0 +1,462 @@
+/**
+ * @file Simd.hpp
+ * @brief Internal SSE2 kernels with scalar fallbacks
+ *
+ * Private to the library. Every kernel performs the same IEEE operations in
+ * the same order as the corresponding scalar class method, so SIMD and
+ * scalar builds produce bit-identical results. Define VECTORMATHS_NO_SIMD to
+ * force the scalar path.
+ */
+
+#pragma once
+
+#include "../include/Matrix.hpp"
+#include "../include/Frustum.hpp"
+#include "../include/Quaternion.hpp"
+#include "../include/RayPacket.hpp"
+#include "RayTraversal.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if !defined(VECTORMATHS_NO_SIMD) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define VECTORMATHS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace simd {
+
+/// Computes a * b for column-major matrices (same result as Mat4::operator*)
+inline void MultiplyMat4(const Mat4& a, const Mat4& b, Mat4& out) {
+#ifdef VECTORMATHS_SSE2
+	__m128 col0 = _mm_loadu_ps(a.m);
+	__m128 col1 = _mm_loadu_ps(a.m + 4);
+	__m128 col2 = _mm_loadu_ps(a.m + 8);
+	__m128 col3 = _mm_loadu_ps(a.m + 12);
+
+	for (int j = 0; j < 4; j++) {
+		const float* column = b.m + j * 4;
+		__m128 result = _mm_mul_ps(col0, _mm_set1_ps(column[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(col1, _mm_set1_ps(column[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_set1_ps(column[2])));
+		result = _mm_add_ps(result, _mm_mul_ps(col3, _mm_set1_ps(column[3])));
+		_mm_storeu_ps(out.m + j * 4, result);
+	}
+#else
+	out = a * b;
+#endif
+}
+
+/// Normalized linear interpolation (same result as Quaternion::nlerp)
+inline Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t) {
+#ifdef VECTORMATHS_SSE2
+	float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+
+	__m128 qa = _mm_set_ps(a.z, a.y, a.x, a.w);
+	__m128 qb = _mm_set_ps(b.z, b.y, b.x, b.w);
+	if (dot < 0.0f) {
+		qb = _mm_sub_ps(_mm_setzero_ps(), qb);
+	}
+
+	__m128 q = _mm_add_ps(qa, _mm_mul_ps(_mm_set1_ps(t), _mm_sub_ps(qb, qa)));
+
+	// Sum the squares in w, x, y, z order to match Quaternion::length
+	__m128 squares = _mm_mul_ps(q, q);
+	__m128 sum = _mm_add_ss(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 1, 1, 1)));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 2, 2, 2)));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 3, 3, 3)));
+	__m128 length = _mm_sqrt_ss(sum);
+
+	if (_mm_cvtss_f32(length) < 1e-6f) {
+		return Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	float result[4];
+	_mm_storeu_ps(result, _mm_div_ps(q, _mm_shuffle_ps(length, length, 0)));
+	return Quaternion(result[0], result[1], result[2], result[3]);
+#else
+	return Quaternion::nlerp(a, b, t);
+#endif
+}
+
+#ifdef VECTORMATHS_SSE2
+// Operand order matters for NaNs: _mm_max_ps(a, b) is a > b ? a : b and _mm_min_ps(a, b) is
+// a < b ? a : b, so the packet kernels below follow the scalar comparisons exactly.
+
+/// Picks a where mask is set and b elsewhere
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// traversal::SlabInterval for every lane of a packet
+inline void PacketSlabInterval(const RayPacket& packet, const AABB& box, __m128& tMin, __m128& tMax) {
+	const __m128 zero = _mm_setzero_ps();
+	const float* origins[3] = { packet.originX, packet.originY, packet.originZ };
+	const float* inverses[3] = { packet.inverseX, packet.inverseY, packet.inverseZ };
+	const float lows[3] = { box.min.x, box.min.y, box.min.z };
+	const float highs[3] = { box.max.x, box.max.y, box.max.z };
+
+	tMin = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+	tMax = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	for (int axis = 0; axis < 3; axis++) {
+		__m128 origin = _mm_load_ps(origins[axis]);
+		__m128 inverse = _mm_load_ps(inverses[axis]);
+		__m128 negative = _mm_cmplt_ps(inverse, zero);
+		__m128 low = _mm_set1_ps(lows[axis]);
+		__m128 high = _mm_set1_ps(highs[axis]);
+		__m128 tNear = _mm_mul_ps(_mm_sub_ps(Select(negative, high, low), origin), inverse);
+		__m128 tFar = _mm_mul_ps(_mm_sub_ps(Select(negative, low, high), origin), inverse);
+		tMin = _mm_max_ps(tNear, tMin);
+		tMax = _mm_min_ps(tFar, tMax);
+	}
+}
+#endif
+
+/// Node test for every lane of a packet (same result per lane as traversal::RayHitsBox); returns the hit lanes
+inline uint32_t PacketHitsBox(const RayPacket& packet, const AABB& box, const float maxDistance[RayPacket::Width],
+	float entry[RayPacket::Width]) {
+#ifdef VECTORMATHS_SSE2
+	__m128 tMin;
+	__m128 tMax;
+	PacketSlabInterval(packet, box, tMin, tMax);
+	tMin = _mm_max_ps(_mm_setzero_ps(), tMin);
+	tMax = _mm_min_ps(_mm_loadu_ps(maxDistance), tMax);
+	_mm_storeu_ps(entry, tMin);
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+		if (traversal::RayHitsBox(packet.getRay(lane), box, maxDistance[lane], entry[lane])) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// Conservative node test for every lane of a packet (same result per lane as traversal::RayHitsBoxConservative)
+inline uint32_t PacketHitsBoxConservative(const RayPacket& packet, const AABB& box, const float maxDistance[RayPacket::Width],
+	float entry[RayPacket::Width]) {
+#ifdef VECTORMATHS_SSE2
+	__m128 tMin;
+	__m128 tMax;
+	PacketSlabInterval(packet, box, tMin, tMax);
+	tMin = _mm_max_ps(_mm_setzero_ps(), tMin);
+	tMax = _mm_mul_ps(_mm_min_ps(_mm_loadu_ps(maxDistance), tMax), _mm_set1_ps(traversal::ConservativeScale));
+	_mm_storeu_ps(entry, tMin);
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+		if (traversal::RayHitsBoxConservative(packet.getRay(lane), box, maxDistance[lane], entry[lane])) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// rayIntersectsAABB for every lane of a packet; returns the hit lanes
+inline uint32_t PacketIntersectsAABB(const RayPacket& packet, const AABB& box, float distance[RayPacket::Width]) {
+#ifdef VECTORMATHS_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	__m128 tMin;
+	__m128 tMax;
+	PacketSlabInterval(packet, box, tMin, tMax);
+
+	__m128 miss = _mm_or_ps(_mm_cmpgt_ps(tMin, tMax), _mm_cmplt_ps(tMax, zero));
+	_mm_storeu_ps(distance, Select(_mm_cmpge_ps(tMin, zero), tMin, tMax));
+	return static_cast<uint32_t>(_mm_movemask_ps(miss)) ^ RayPacket::FullMask;
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+		if (rayIntersectsAABB(packet.getRay(lane), box, distance[lane])) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+// One-ray-versus-four kernels over structure-of-arrays primitives. Each reads four consecutive
+// entries from its arrays and returns the lanes that hit within maxDistance, with the same
+// distances as the scalar intersection function.
+
+/// rayIntersectsSphere against four spheres
+inline uint32_t RayHitsSpheres(const Ray& ray, const float* centerX, const float* centerY, const float* centerZ,
+	const float* radius, float maxDistance, float distance[4]) {
+#ifdef VECTORMATHS_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 originX = _mm_set1_ps(ray.origin.x);
+	const __m128 originY = _mm_set1_ps(ray.origin.y);
+	const __m128 originZ = _mm_set1_ps(ray.origin.z);
+	const __m128 directionX = _mm_set1_ps(ray.getDirection().x);
+	const __m128 directionY = _mm_set1_ps(ray.getDirection().y);
+	const __m128 directionZ = _mm_set1_ps(ray.getDirection().z);
+	__m128 cx = _mm_loadu_ps(centerX);
+	__m128 cy = _mm_loadu_ps(centerY);
+	__m128 cz = _mm_loadu_ps(centerZ);
+	__m128 r = _mm_loadu_ps(radius);
+
+	// Projection of the center onto the ray
+	__m128 along = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(_mm_sub_ps(cx, originX), directionX),
+		_mm_mul_ps(_mm_sub_ps(cy, originY), directionY)),
+		_mm_mul_ps(_mm_sub_ps(cz, originZ), directionZ));
+
+	// Squared distance from the center to that point
+	__m128 ex = _mm_sub_ps(_mm_add_ps(originX, _mm_mul_ps(directionX, along)), cx);
+	__m128 ey = _mm_sub_ps(_mm_add_ps(originY, _mm_mul_ps(directionY, along)), cy);
+	__m128 ez = _mm_sub_ps(_mm_add_ps(originZ, _mm_mul_ps(directionZ, along)), cz);
+	__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), _mm_mul_ps(ez, ez));
+	__m128 radiusSquared = _mm_mul_ps(r, r);
+
+	__m128 offset = _mm_sqrt_ps(_mm_sub_ps(radiusSquared, distanceSquared));
+	__m128 nearT = _mm_sub_ps(along, offset);
+	__m128 farT = _mm_add_ps(along, offset);
+	__m128 nearBehind = _mm_cmplt_ps(nearT, zero);
+	__m128 t = Select(nearBehind, farT, nearT);
+
+	__m128 miss = _mm_or_ps(_mm_cmplt_ps(along, zero), _mm_cmpgt_ps(distanceSquared, radiusSquared));
+	miss = _mm_or_ps(miss, _mm_and_ps(nearBehind, _mm_cmplt_ps(farT, zero)));
+	__m128 hit = _mm_andnot_ps(miss, _mm_cmple_ps(t, _mm_set1_ps(maxDistance)));
+	_mm_storeu_ps(distance, t);
+	return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		Sphere sphere(Vec3(centerX[lane], centerY[lane], centerZ[lane]), radius[lane]);
+		if (rayIntersectsSphere(ray, sphere, distance[lane]) && distance[lane] <= maxDistance) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// rayIntersectsAABB against four boxes
+inline uint32_t RayHitsBoxes(const Ray& ray, const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, float maxDistance, float distance[4]) {
+#ifdef VECTORMATHS_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const float origins[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+	const float inverses[3] = { ray.getInverseDirection().x, ray.getInverseDirection().y, ray.getInverseDirection().z };
+	const float* lows[3] = { minX, minY, minZ };
+	const float* highs[3] = { maxX, maxY, maxZ };
+
+	// traversal::SlabInterval with the ray broadcast and the boxes across lanes
+	__m128 tMin = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+	__m128 tMax = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	for (int axis = 0; axis < 3; axis++) {
+		const float* nearFace = ray.getSign(axis) ? highs[axis] : lows[axis];
+		const float* farFace = ray.getSign(axis) ? lows[axis] : highs[axis];
+		__m128 origin = _mm_set1_ps(origins[axis]);
+		__m128 inverse = _mm_set1_ps(inverses[axis]);
+		__m128 tNear = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(nearFace), origin), inverse);
+		__m128 tFar = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(farFace), origin), inverse);
+		tMin = _mm_max_ps(tNear, tMin);
+		tMax = _mm_min_ps(tFar, tMax);
+	}
+
+	__m128 t = Select(_mm_cmpge_ps(tMin, zero), tMin, tMax);
+	__m128 miss = _mm_or_ps(_mm_cmpgt_ps(tMin, tMax), _mm_cmplt_ps(tMax, zero));
+	__m128 hit = _mm_andnot_ps(miss, _mm_cmple_ps(t, _mm_set1_ps(maxDistance)));
+	_mm_storeu_ps(distance, t);
+	return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		AABB box(Vec3(minX[lane], minY[lane], minZ[lane]), Vec3(maxX[lane], maxY[lane], maxZ[lane]));
+		if (rayIntersectsAABB(ray, box, distance[lane]) && distance[lane] <= maxDistance) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// rayIntersectsPlane against four planes
+inline uint32_t RayHitsPlanes(const Ray& ray, const float* normalX, const float* normalY, const float* normalZ,
+	const float* pointX, const float* pointY, const float* pointZ, float maxDistance, float distance[4]) {
+#ifdef VECTORMATHS_SSE2
+	__m128 nx = _mm_loadu_ps(normalX);
+	__m128 ny = _mm_loadu_ps(normalY);
+	__m128 nz = _mm_loadu_ps(normalZ);
+	__m128 facing = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(nx, _mm_set1_ps(ray.getDirection().x)),
+		_mm_mul_ps(ny, _mm_set1_ps(ray.getDirection().y))),
+		_mm_mul_ps(nz, _mm_set1_ps(ray.getDirection().z)));
+	__m128 offset = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pointX), _mm_set1_ps(ray.origin.x)), nx),
+		_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pointY), _mm_set1_ps(ray.origin.y)), ny)),
+		_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pointZ), _mm_set1_ps(ray.origin.z)), nz));
+	__m128 t = _mm_div_ps(offset, facing);
+
+	// Parallel planes (|facing| < 1e-6) and planes behind the ray miss
+	__m128 absFacing = _mm_andnot_ps(_mm_set1_ps(-0.0f), facing);
+	__m128 miss = _mm_or_ps(_mm_cmplt_ps(absFacing, _mm_set1_ps(1e-6f)), _mm_cmplt_ps(t, _mm_setzero_ps()));
+	__m128 hit = _mm_andnot_ps(miss, _mm_cmple_ps(t, _mm_set1_ps(maxDistance)));
+	_mm_storeu_ps(distance, t);
+	return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		Vec3 normal(normalX[lane], normalY[lane], normalZ[lane]);
+		Vec3 point(pointX[lane], pointY[lane], pointZ[lane]);
+		if (rayIntersectsPlane(ray, normal, point, distance[lane]) && distance[lane] <= maxDistance) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+// Overlap kernels: one query shape against four boxes stored component-wise. Each returns the
+// lanes whose box passes the same comparisons as the scalar function.
+
+/// aabbIntersectsAABB between four boxes and a query box
+inline uint32_t BoxesOverlapBox(const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, const AABB& box) {
+#ifdef VECTORMATHS_SSE2
+	__m128 inX = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX), _mm_set1_ps(box.max.x)),
+		_mm_cmpge_ps(_mm_loadu_ps(maxX), _mm_set1_ps(box.min.x)));
+	__m128 inY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY), _mm_set1_ps(box.max.y)),
+		_mm_cmpge_ps(_mm_loadu_ps(maxY), _mm_set1_ps(box.min.y)));
+	__m128 inZ = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minZ), _mm_set1_ps(box.max.z)),
+		_mm_cmpge_ps(_mm_loadu_ps(maxZ), _mm_set1_ps(box.min.z)));
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(_mm_and_ps(inX, inY), inZ)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		AABB other(Vec3(minX[lane], minY[lane], minZ[lane]), Vec3(maxX[lane], maxY[lane], maxZ[lane]));
+		if (aabbIntersectsAABB(other, box)) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// sphereIntersectsAABB between a query sphere and four boxes (finite bounds)
+inline uint32_t BoxesOverlapSphere(const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, const Sphere& sphere) {
+#ifdef VECTORMATHS_SSE2
+	// Closest point on each box to the center; max/min match fmax/fmin for non-NaN bounds
+	__m128 cx = _mm_set1_ps(sphere.center.x);
+	__m128 cy = _mm_set1_ps(sphere.center.y);
+	__m128 cz = _mm_set1_ps(sphere.center.z);
+	__m128 dx = _mm_sub_ps(cx, _mm_max_ps(_mm_loadu_ps(minX), _mm_min_ps(cx, _mm_loadu_ps(maxX))));
+	__m128 dy = _mm_sub_ps(cy, _mm_max_ps(_mm_loadu_ps(minY), _mm_min_ps(cy, _mm_loadu_ps(maxY))));
+	__m128 dz = _mm_sub_ps(cz, _mm_max_ps(_mm_loadu_ps(minZ), _mm_min_ps(cz, _mm_loadu_ps(maxZ))));
+	__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+	__m128 radiusSquared = _mm_set1_ps(sphere.radius * sphere.radius);
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		AABB box(Vec3(minX[lane], minY[lane], minZ[lane]), Vec3(maxX[lane], maxY[lane], maxZ[lane]));
+		if (sphereIntersectsAABB(sphere, box)) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// pointInAABB between a query point and four boxes
+inline uint32_t BoxesContainPoint(const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, const Vec3& point) {
+#ifdef VECTORMATHS_SSE2
+	__m128 px = _mm_set1_ps(point.x);
+	__m128 py = _mm_set1_ps(point.y);
+	__m128 pz = _mm_set1_ps(point.z);
+	__m128 inX = _mm_and_ps(_mm_cmple_ps(px, _mm_loadu_ps(maxX)), _mm_cmpge_ps(px, _mm_loadu_ps(minX)));
+	__m128 inY = _mm_and_ps(_mm_cmple_ps(py, _mm_loadu_ps(maxY)), _mm_cmpge_ps(py, _mm_loadu_ps(minY)));
+	__m128 inZ = _mm_and_ps(_mm_cmple_ps(pz, _mm_loadu_ps(maxZ)), _mm_cmpge_ps(pz, _mm_loadu_ps(minZ)));
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(_mm_and_ps(inX, inY), inZ)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		AABB box(Vec3(minX[lane], minY[lane], minZ[lane]), Vec3(maxX[lane], maxY[lane], maxZ[lane]));
+		if (pointInAABB(point, box)) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+// Frustum kernels: four primitives stored component-wise against every plane of a frustum.
+// Each returns the lanes that are not outside, with the comparisons of Frustum::intersects.
+
+/// Frustum::intersects for four boxes
+inline uint32_t BoxesInFrustum(const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, const Frustum& frustum) {
+#ifdef VECTORMATHS_SSE2
+	__m128 lowX = _mm_loadu_ps(minX);
+	__m128 lowY = _mm_loadu_ps(minY);
+	__m128 lowZ = _mm_loadu_ps(minZ);
+	__m128 highX = _mm_loadu_ps(maxX);
+	__m128 highY = _mm_loadu_ps(maxY);
+	__m128 highZ = _mm_loadu_ps(maxZ);
+	__m128 outside = _mm_setzero_ps();
+	for (uint32_t i = 0; i < Frustum::PlaneCount; i++) {
+		// The plane is the same for every lane, so the furthest corner is picked without blends
+		const Vec4& plane = frustum.planes[i];
+		__m128 x = plane.x >= 0.0f ? highX : lowX;
+		__m128 y = plane.y >= 0.0f ? highY : lowY;
+		__m128 z = plane.z >= 0.0f ? highZ : lowZ;
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(plane.x), x),
+			_mm_mul_ps(_mm_set1_ps(plane.y), y)),
+			_mm_mul_ps(_mm_set1_ps(plane.z), z)),
+			_mm_set1_ps(plane.w));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+	}
+	return static_cast<uint32_t>(_mm_movemask_ps(outside)) ^ 0xFu;
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		AABB box(Vec3(minX[lane], minY[lane], minZ[lane]), Vec3(maxX[lane], maxY[lane], maxZ[lane]));
+		if (frustum.intersects(box)) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+/// Frustum::intersects for four spheres
+inline uint32_t SpheresInFrustum(const float* centerX, const float* centerY, const float* centerZ,
+	const float* radius, const Frustum& frustum) {
+#ifdef VECTORMATHS_SSE2
+	__m128 cx = _mm_loadu_ps(centerX);
+	__m128 cy = _mm_loadu_ps(centerY);
+	__m128 cz = _mm_loadu_ps(centerZ);
+	__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius));
+	__m128 outside = _mm_setzero_ps();
+	for (uint32_t i = 0; i < Frustum::PlaneCount; i++) {
+		const Vec4& plane = frustum.planes[i];
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(plane.x), cx),
+			_mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+			_mm_mul_ps(_mm_set1_ps(plane.z), cz)),
+			_mm_set1_ps(plane.w));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+	}
+	return static_cast<uint32_t>(_mm_movemask_ps(outside)) ^ 0xFu;
+#else
+	uint32_t mask = 0;
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		Sphere sphere(Vec3(centerX[lane], centerY[lane], centerZ[lane]), radius[lane]);
+		if (frustum.intersects(sphere)) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+} // namespace simd
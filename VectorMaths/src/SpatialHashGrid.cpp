@@ -0,0 +1,187 @@
+/**
+ * @file SpatialHashGrid.cpp
+ * @brief Implementation of the hashed uniform grid
+ */
+
+#include "../include/SpatialHashGrid.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+/// Same test as sphereIntersectsSphere, on the copied entries
+template <typename Entry>
+inline bool EntriesIntersect(const Entry& a, const Entry& b) {
+	float dx = a.x - b.x;
+	float dy = a.y - b.y;
+	float dz = a.z - b.z;
+	float radiusSum = a.radius + b.radius;
+	return dx * dx + dy * dy + dz * dz <= radiusSum * radiusSum;
+}
+
+} // namespace
+
+// Constructors
+SpatialHashGrid::SpatialHashGrid(float cellSize)
+	: maxRadius(0.0f),
+	bucketMask(0) {
+	setCellSize(cellSize);
+}
+
+void SpatialHashGrid::setCellSize(float size) {
+	assert(size > 0.0f && "Cell size must be positive");
+	cellSize = size;
+	inverseCellSize = 1.0f / size;
+}
+
+float SpatialHashGrid::getCellSize() const {
+	return cellSize;
+}
+
+void SpatialHashGrid::build(const Sphere* spheres, size_t count) {
+	// Power-of-two bucket count with at most one sphere per two buckets on average
+	uint32_t bucketCount = 16;
+	while (bucketCount < count * 2) {
+		bucketCount <<= 1;
+	}
+	bucketMask = bucketCount - 1;
+
+	// Counting sort, pass 1: count the spheres per bucket
+	bucketStart.assign(bucketCount + 1, 0);
+	entryBucket.resize(count);
+	maxRadius = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		const Vec3& center = spheres[i].center;
+		uint32_t bucket = bucketOf(cellOf(center.x, center.y, center.z));
+		entryBucket[i] = bucket;
+		bucketStart[bucket + 1]++;
+		maxRadius = std::max(maxRadius, spheres[i].radius);
+	}
+	for (uint32_t bucket = 0; bucket < bucketCount; bucket++) {
+		bucketStart[bucket + 1] += bucketStart[bucket];
+	}
+
+	// Pass 2: scatter into contiguous bucket ranges, keeping input order within a bucket
+	entries.resize(count);
+	cells.resize(count);
+	indices.resize(count);
+	std::vector<uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+	for (size_t i = 0; i < count; i++) {
+		const Sphere& sphere = spheres[i];
+		uint32_t slot = next[entryBucket[i]]++;
+		entries[slot] = Entry{ sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius };
+		cells[slot] = cellOf(sphere.center.x, sphere.center.y, sphere.center.z);
+		indices[slot] = static_cast<uint32_t>(i);
+	}
+}
+
+void SpatialHashGrid::clear() {
+	bucketStart.clear();
+	entries.clear();
+	cells.clear();
+	indices.clear();
+	entryBucket.clear();
+	maxRadius = 0.0f;
+	bucketMask = 0;
+}
+
+size_t SpatialHashGrid::size() const {
+	return entries.size();
+}
+
+void SpatialHashGrid::queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const {
+	pairs.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	// Intersecting centers are at most 2 * maxRadius apart, so at most this many cells apart
+	const int32_t reach = static_cast<int32_t>(std::ceil(2.0f * maxRadius * inverseCellSize));
+
+	// Visit each pair of neighbouring cells once by only looking "forward" from each cell
+	std::vector<Cell> forward;
+	for (int32_t dx = 0; dx <= reach; dx++) {
+		for (int32_t dy = (dx == 0 ? 0 : -reach); dy <= reach; dy++) {
+			for (int32_t dz = (dx == 0 && dy == 0 ? 1 : -reach); dz <= reach; dz++) {
+				forward.push_back(Cell{ dx, dy, dz });
+			}
+		}
+	}
+
+	const uint32_t bucketCount = bucketMask + 1;
+	for (uint32_t bucket = 0; bucket < bucketCount; bucket++) {
+		const uint32_t end = bucketStart[bucket + 1];
+		for (uint32_t i = bucketStart[bucket]; i < end; i++) {
+			const Entry& a = entries[i];
+			const Cell& cell = cells[i];
+
+			// Own cell: only later entries, which share the bucket
+			for (uint32_t j = i + 1; j < end; j++) {
+				const Cell& other = cells[j];
+				if (other.x == cell.x && other.y == cell.y && other.z == cell.z && EntriesIntersect(a, entries[j])) {
+					pairs.emplace_back(std::min(indices[i], indices[j]), std::max(indices[i], indices[j]));
+				}
+			}
+
+			// Forward neighbours; other cells hashing to the same bucket are skipped
+			for (const Cell& offset : forward) {
+				Cell neighbour{ cell.x + offset.x, cell.y + offset.y, cell.z + offset.z };
+				uint32_t neighbourBucket = bucketOf(neighbour);
+				const uint32_t neighbourEnd = bucketStart[neighbourBucket + 1];
+				for (uint32_t j = bucketStart[neighbourBucket]; j < neighbourEnd; j++) {
+					const Cell& other = cells[j];
+					if (other.x == neighbour.x && other.y == neighbour.y && other.z == neighbour.z &&
+						EntriesIntersect(a, entries[j])) {
+						pairs.emplace_back(std::min(indices[i], indices[j]), std::max(indices[i], indices[j]));
+					}
+				}
+			}
+		}
+	}
+}
+
+void SpatialHashGrid::queryOverlaps(const Sphere& sphere, std::vector<uint32_t>& results) const {
+	results.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	const Entry query{ sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius };
+	const float range = sphere.radius + maxRadius;
+	Cell lo = cellOf(query.x - range, query.y - range, query.z - range);
+	Cell hi = cellOf(query.x + range, query.y + range, query.z + range);
+
+	for (int32_t x = lo.x; x <= hi.x; x++) {
+		for (int32_t y = lo.y; y <= hi.y; y++) {
+			for (int32_t z = lo.z; z <= hi.z; z++) {
+				Cell cell{ x, y, z };
+				uint32_t bucket = bucketOf(cell);
+				const uint32_t end = bucketStart[bucket + 1];
+				for (uint32_t j = bucketStart[bucket]; j < end; j++) {
+					const Cell& other = cells[j];
+					if (other.x == x && other.y == y && other.z == z && EntriesIntersect(query, entries[j])) {
+						results.push_back(indices[j]);
+					}
+				}
+			}
+		}
+	}
+}
+
+SpatialHashGrid::Cell SpatialHashGrid::cellOf(float x, float y, float z) const {
+	return Cell{
+		static_cast<int32_t>(std::floor(x * inverseCellSize)),
+		static_cast<int32_t>(std::floor(y * inverseCellSize)),
+		static_cast<int32_t>(std::floor(z * inverseCellSize))
+	};
+}
+
+uint32_t SpatialHashGrid::bucketOf(const Cell& cell) const {
+	// Large primes from Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+	uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^
+		(static_cast<uint32_t>(cell.y) * 19349663u) ^
+		(static_cast<uint32_t>(cell.z) * 83492791u);
+	return hash & bucketMask;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file SweepAndPrune.cpp
+ * @brief Implementation of the sweep-and-prune broadphase
+ */
+
+#include "../include/SweepAndPrune.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+// Constructors
+SweepAndPrune::SweepAndPrune(int axis)
+	: proxyCount(0),
+	sortedCount(0),
+	requestedAxis(axis),
+	axis(axis == AutoAxis ? 0 : axis),
+	entriesDirty(false) {
+	assert(axis >= AutoAxis && axis < 3 && "Invalid sweep axis");
+}
+
+uint32_t SweepAndPrune::createProxy(const AABB& box) {
+	uint32_t proxy;
+	if (!freeIds.empty()) {
+		proxy = freeIds.back();
+		freeIds.pop_back();
+		bounds[proxy] = box;
+		alive[proxy] = 1;
+	}
+	else {
+		proxy = static_cast<uint32_t>(bounds.size());
+		bounds.push_back(box);
+		alive.push_back(1);
+	}
+
+	// New entries go on the unsorted tail and are merged in by the next update
+	Entry entry;
+	entry.proxy = proxy;
+	entries.push_back(entry);
+	proxyCount++;
+	return proxy;
+}
+
+void SweepAndPrune::destroyProxy(uint32_t proxy) {
+	assert(proxy < alive.size() && alive[proxy] && "Invalid proxy");
+	alive[proxy] = 0;
+	pendingFree.push_back(proxy);
+	entriesDirty = true;
+	proxyCount--;
+}
+
+void SweepAndPrune::moveProxy(uint32_t proxy, const AABB& box) {
+	assert(proxy < alive.size() && alive[proxy] && "Invalid proxy");
+	bounds[proxy] = box;
+}
+
+const AABB& SweepAndPrune::getBounds(uint32_t proxy) const {
+	assert(proxy < alive.size() && alive[proxy] && "Invalid proxy");
+	return bounds[proxy];
+}
+
+void SweepAndPrune::update() {
+	// Drop destroyed proxies, keeping the survivors in order
+	if (entriesDirty) {
+		size_t kept = 0;
+		size_t keptSorted = 0;
+		for (size_t i = 0; i < entries.size(); i++) {
+			if (alive[entries[i].proxy]) {
+				entries[kept++] = entries[i];
+				if (i < sortedCount) {
+					keptSorted++;
+				}
+			}
+		}
+		entries.resize(kept);
+		sortedCount = keptSorted;
+		entriesDirty = false;
+	}
+
+	// Copy the latest bounds into the sweep entries
+	for (Entry& entry : entries) {
+		const AABB& box = bounds[entry.proxy];
+		entry.min[0] = box.min.x;
+		entry.min[1] = box.min.y;
+		entry.min[2] = box.min.z;
+		entry.max[0] = box.max.x;
+		entry.max[1] = box.max.y;
+		entry.max[2] = box.max.z;
+	}
+
+	int newAxis = requestedAxis == AutoAxis ? chooseAxis() : requestedAxis;
+	const int a = newAxis;
+	auto byMin = [a](const Entry& lhs, const Entry& rhs) {
+		return lhs.min[a] < rhs.min[a];
+	};
+
+	if (newAxis != axis) {
+		// The old order says nothing about the new axis
+		axis = newAxis;
+		std::sort(entries.begin(), entries.end(), byMin);
+	}
+	else {
+		// Insertion sort: objects only move a few places between frames
+		for (size_t i = 1; i < sortedCount; i++) {
+			Entry entry = entries[i];
+			size_t j = i;
+			while (j > 0 && entries[j - 1].min[a] > entry.min[a]) {
+				entries[j] = entries[j - 1];
+				j--;
+			}
+			entries[j] = entry;
+		}
+
+		// New proxies can land anywhere, so sort them on their own and merge
+		if (sortedCount < entries.size()) {
+			std::sort(entries.begin() + sortedCount, entries.end(), byMin);
+			std::inplace_merge(entries.begin(), entries.begin() + sortedCount, entries.end(), byMin);
+		}
+	}
+	sortedCount = entries.size();
+
+	// Sweep: a box can only overlap the boxes that start before it ends
+	const int b = (a + 1) % 3;
+	const int c = (a + 2) % 3;
+	scratch.clear();
+	for (size_t i = 0; i < entries.size(); i++) {
+		const Entry& first = entries[i];
+		const float end = first.max[a];
+		for (size_t j = i + 1; j < entries.size() && entries[j].min[a] <= end; j++) {
+			const Entry& second = entries[j];
+			if (first.min[b] <= second.max[b] && first.max[b] >= second.min[b] &&
+				first.min[c] <= second.max[c] && first.max[c] >= second.min[c]) {
+				scratch.emplace_back(std::min(first.proxy, second.proxy), std::max(first.proxy, second.proxy));
+			}
+		}
+	}
+	std::sort(scratch.begin(), scratch.end());
+
+	// Diff against the previous pairs to report the changes
+	added.clear();
+	removed.clear();
+	std::set_difference(scratch.begin(), scratch.end(), pairs.begin(), pairs.end(), std::back_inserter(added));
+	std::set_difference(pairs.begin(), pairs.end(), scratch.begin(), scratch.end(), std::back_inserter(removed));
+	pairs.swap(scratch);
+
+	// Destroyed ids have now had their pairs reported and can be reused
+	freeIds.insert(freeIds.end(), pendingFree.begin(), pendingFree.end());
+	pendingFree.clear();
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::getPairs() const {
+	return pairs;
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::getAddedPairs() const {
+	return added;
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::getRemovedPairs() const {
+	return removed;
+}
+
+void SweepAndPrune::setAxis(int newAxis) {
+	assert(newAxis >= AutoAxis && newAxis < 3 && "Invalid sweep axis");
+	requestedAxis = newAxis;
+}
+
+int SweepAndPrune::getAxis() const {
+	return axis;
+}
+
+void SweepAndPrune::clear() {
+	bounds.clear();
+	alive.clear();
+	freeIds.clear();
+	pendingFree.clear();
+	entries.clear();
+	pairs.clear();
+	added.clear();
+	removed.clear();
+	scratch.clear();
+	proxyCount = 0;
+	sortedCount = 0;
+	entriesDirty = false;
+}
+
+size_t SweepAndPrune::size() const {
+	return proxyCount;
+}
+
+int SweepAndPrune::chooseAxis() const {
+	if (entries.size() < 2) {
+		return axis;
+	}
+
+	// Variance of the box centers along each axis (centers are doubled, which doesn't change the ordering)
+	double sum[3] = { 0.0, 0.0, 0.0 };
+	double sumSquares[3] = { 0.0, 0.0, 0.0 };
+	for (const Entry& entry : entries) {
+		for (int i = 0; i < 3; i++) {
+			double center = static_cast<double>(entry.min[i]) + entry.max[i];
+			sum[i] += center;
+			sumSquares[i] += center * center;
+		}
+	}
+
+	const double count = static_cast<double>(entries.size());
+	int best = axis;
+	double bestVariance = sumSquares[axis] - sum[axis] * sum[axis] / count;
+
+	// Near-equal spreads would otherwise flip the axis, and re-sort, every update
+	double threshold = sortedCount > 0 ? bestVariance * AxisSwitchRatio : bestVariance;
+	for (int i = 0; i < 3; i++) {
+		double variance = sumSquares[i] - sum[i] * sum[i] / count;
+		if (variance > threshold && variance > bestVariance) {
+			best = i;
+			bestVariance = variance;
+		}
+	}
+	return best;
+}
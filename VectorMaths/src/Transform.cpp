@@ -16,7 +16,12 @@ Transform::Transform()
 		rotation(Quaternion()),
 		scale(Vec3(1.0f, 1.0f, 1.0f)),
 		parent(nullptr),
-		dirty(true)
+		localDirty(true),
+		worldDirty(true),
+		worldVersion(0),
+		parentWorldVersion(0),
+		validatedGeneration(0),
+		inverseWorldVersion(0)
 	{}
 
 Transform::Transform(const Vec3& position, const Quaternion& rotation, const Vec3& scale)
@@ -24,38 +29,52 @@ Transform::Transform(const Vec3& position, const Quaternion& rotation, const Vec
 		rotation(rotation),
 		scale(scale),
 		parent(nullptr),
-		dirty(true)
+		localDirty(true),
+		worldDirty(true),
+		worldVersion(0),
+		parentWorldVersion(0),
+		validatedGeneration(0),
+		inverseWorldVersion(0)
 {}
 
-// Accessors
-Mat4 Transform::GetLocalMatrix() const {
-	if (dirty) {
-		// Scale - Rotate - Translate
+Mat4 Transform::ComposeMatrix(const Vec3& position, const Quaternion& rotation, const Vec3& scale) {
+	// Scale - Rotate - Translate
 
-		Mat4 scaleMat;  // Identitiy Matrix
-		scaleMat = scaleMat.scale(scale);
+	Mat4 scaleMat;  // Identitiy Matrix
+	scaleMat = scaleMat.scale(scale);
 
-		Mat4 rotateMat = rotation.toRotationMatrix();
+	Mat4 rotateMat = rotation.toRotationMatrix();
 
-		localMatrix = rotateMat * scaleMat;
-		localMatrix = localMatrix.translation(position);
+	Mat4 result = rotateMat * scaleMat;
+	return result.translation(position);
+}
 
-		dirty = false;
+// Accessors
+Mat4 Transform::GetLocalMatrix() const {
+	if (localDirty) {
+		localMatrix = ComposeMatrix(position, rotation, scale);
+		localDirty = false;
 	}
 	return localMatrix;
 }
 
 Mat4 Transform::GetWorldMatrix() const
 {
-	if (parent) {
-		worldMatrix = parent->GetWorldMatrix() * GetLocalMatrix();
-	}
-	else {
-		worldMatrix = GetLocalMatrix();
-	}
+	UpdateWorldMatrix();
 	return worldMatrix;
 }
 
+Mat4 Transform::GetInverseWorldMatrix() const {
+	UpdateWorldMatrix();
+
+	// The default matrices are both identity, so version 0 is already consistent
+	if (inverseWorldVersion != worldVersion) {
+		inverseWorldMatrix = worldMatrix.affineInverse();
+		inverseWorldVersion = worldVersion;
+	}
+	return inverseWorldMatrix;
+}
+
 Vec3 Transform::GetPosition() const {
 	return position;
 }
@@ -92,34 +111,135 @@ void Transform::SetScale(const Vec3& newScale) {
 	MarkDirty();
 }
 
+void Transform::SetWorldPosition(const Vec3& worldPosition) {
+	position = parent ? parent->InverseTransformPoint(worldPosition) : worldPosition;
+	MarkDirty();
+}
+
+void Transform::SetWorldRotation(const Quaternion& worldRotation) {
+	if (!parent) {
+		rotation = worldRotation;
+		MarkDirty();
+		return;
+	}
+
+	// Parent's world rotation: its world matrix columns with scale divided out
+	Mat4 parentWorld = parent->GetWorldMatrix();
+	Vec3 axisX = Vec3(parentWorld.m[0], parentWorld.m[1], parentWorld.m[2]).normalised();
+	Vec3 axisY = Vec3(parentWorld.m[4], parentWorld.m[5], parentWorld.m[6]).normalised();
+	Vec3 axisZ = Vec3(parentWorld.m[8], parentWorld.m[9], parentWorld.m[10]).normalised();
+
+	float rotMatVals[9] = {
+		axisX.x, axisX.y, axisX.z,
+		axisY.x, axisY.y, axisY.z,
+		axisZ.x, axisZ.y, axisZ.z
+	};
+	Quaternion parentRotation = Quaternion::fromRotationMatrix(Mat3(rotMatVals));
+
+	// world = parent then local; with the reversed multiplication convention
+	// local = worldRotation * parentRotation^-1
+	rotation = (worldRotation * parentRotation.conjugate()).normalised();
+	MarkDirty();
+}
+
 void Transform::SetParent(Transform* newParent) {
+	if (parent == newParent) {
+		return;
+	}
+
+	if (parent) {
+		std::vector<Transform*>& siblings = parent->children;
+		siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+	}
+
 	parent = newParent;
-	MarkDirty();
+
+	if (parent) {
+		parent->children.emplace_back(this);
+	}
+
+	// The subtree now counts changes with its new root; a detached subtree starts
+	// a counter of its own, so stale validations must not match it by chance
+	std::shared_ptr<uint64_t> generation = parent ? parent->HierarchyGeneration() : std::make_shared<uint64_t>(1);
+	hierarchyGeneration = generation;
+	validatedGeneration = 0;
+	for (Transform* child : children) {
+		child->VisitSubtree([&](Transform& node) {
+			node.hierarchyGeneration = generation;
+			node.validatedGeneration = 0;
+		});
+	}
+
+	MarkWorldDirty();
 }
 
 void Transform::AddChild(Transform* child) {
-	children.emplace_back(child);
 	child->SetParent(this);
 }
 
 void Transform::RemoveChild(Transform* child) {
-	auto it = std::remove(children.begin(), children.end(), child);
-
-	if (it != children.end()) {
-		children.erase(it, children.end());
-
-		if (child && child->GetParent() == this) {
-			child->SetParent(nullptr);
-		}
+	if (child && child->GetParent() == this) {
+		child->SetParent(nullptr);
 	}
 }
 
 // Utililty Methods
 void Transform::MarkDirty() {
-	dirty = true;
+	localDirty = true;
+	MarkWorldDirty();
+}
 
-	for (Transform* child : children) {
-		child->MarkDirty();
+void Transform::MarkWorldDirty() {
+	worldDirty = true;
+
+	// Only descendants depend on this world matrix; a leaf's own flag is enough
+	if (!children.empty()) {
+		++*HierarchyGeneration();
+	}
+}
+
+const std::shared_ptr<uint64_t>& Transform::HierarchyGeneration() const {
+	if (!hierarchyGeneration) {
+		hierarchyGeneration = std::make_shared<uint64_t>(1);
+	}
+	return hierarchyGeneration;
+}
+
+void Transform::UpdateWorldMatrix() const {
+	// Nothing in this hierarchy changed since this transform was last validated
+	uint64_t generation = *HierarchyGeneration();
+	if (validatedGeneration == generation && !worldDirty) {
+		return;
+	}
+
+	// Collect the unvalidated part of the ancestor chain with an explicit
+	// stack, so very deep hierarchies cannot overflow the call stack
+	thread_local std::vector<const Transform*> chain;
+	chain.clear();
+	for (const Transform* node = this; node && (node->validatedGeneration != generation || node->worldDirty); node = node->parent) {
+		chain.push_back(node);
+	}
+
+	// Update from the topmost ancestor down, so each parent is final first
+	for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+		const Transform* node = *it;
+		const Transform* nodeParent = node->parent;
+
+		// Rebuilt only if this transform changed or its parent was rebuilt since
+		bool parentChanged = nodeParent && node->parentWorldVersion != nodeParent->worldVersion;
+		if (node->worldDirty || parentChanged) {
+			if (nodeParent) {
+				node->worldMatrix = nodeParent->worldMatrix * node->GetLocalMatrix();
+				node->parentWorldVersion = nodeParent->worldVersion;
+			}
+			else {
+				node->worldMatrix = node->GetLocalMatrix();
+			}
+			node->worldVersion++;
+			node->worldDirty = false;
+		}
+
+		node->validatedGeneration = generation;
 	}
 }
 
@@ -151,18 +271,37 @@ void Transform::LookAt(const Vec3& target, const Vec3& up) {
 	MarkDirty();
 }
 
+// Space conversions
+Vec3 Transform::InverseTransformPoint(const Vec3& worldPoint) const {
+	Vec4 local = GetInverseWorldMatrix() * Vec4(worldPoint.x, worldPoint.y, worldPoint.z, 1.0f);
+	return Vec3(local.x, local.y, local.z);
+}
+
+Vec3 Transform::InverseTransformDirection(const Vec3& worldDirection) const {
+	Vec4 local = GetInverseWorldMatrix() * Vec4(worldDirection.x, worldDirection.y, worldDirection.z, 0.0f);
+	return Vec3(local.x, local.y, local.z);
+}
+
 // Transform directions
 Vec3 Transform::Forward() const {
-	Vec3 forward(0, 0, -1);  // OpenGL convention
-	return rotation.rotateVector(forward);
+	UpdateWorldMatrix();
+	return Vec3(-worldMatrix.m[8], -worldMatrix.m[9], -worldMatrix.m[10]).normalised();  // OpenGL convention
 }
 
 Vec3 Transform::Right() const {
-	Vec3 right(1, 0, 0);
-	return rotation.rotateVector(right);
+	UpdateWorldMatrix();
+	return Vec3(worldMatrix.m[0], worldMatrix.m[1], worldMatrix.m[2]).normalised();
 }
 
 Vec3 Transform::Up() const {
-	Vec3 up(0, 1, 0);
-	return rotation.rotateVector(up);
-}
\ No newline at end of file
+	UpdateWorldMatrix();
+	return Vec3(worldMatrix.m[4], worldMatrix.m[5], worldMatrix.m[6]).normalised();
+}
+
+void Transform::GetWorldBasis(Vec3& right, Vec3& up, Vec3& forward) const {
+	UpdateWorldMatrix();
+	const float* m = worldMatrix.m;
+	right = Vec3(m[0], m[1], m[2]).normalised();
+	up = Vec3(m[4], m[5], m[6]).normalised();
+	forward = Vec3(-m[8], -m[9], -m[10]).normalised();  // OpenGL convention
+}
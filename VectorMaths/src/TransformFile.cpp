@@ -0,0 +1,266 @@
+/**
+ * @file TransformFile.cpp
+ * @brief Implementation of memory-mapped transform hierarchy files
+ */
+
+#include "../include/TransformFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be tightly packed for TransformFile");
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be tightly packed for TransformFile");
+static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 must be tightly packed for TransformFile");
+
+namespace {
+
+const uint64_t SectionAlignment = 16;
+const uint64_t HeaderSize = 64;
+
+uint64_t AlignUp(uint64_t offset) {
+	return (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+}
+
+/// Writes a section and pads the file to the next section boundary
+void WriteSection(std::ofstream& out, const void* values, uint64_t bytes) {
+	static const char padding[SectionAlignment] = {};
+	if (bytes > 0) {
+		out.write(static_cast<const char*>(values), static_cast<std::streamsize>(bytes));
+	}
+	out.write(padding, static_cast<std::streamsize>(AlignUp(bytes) - bytes));
+}
+
+} // namespace
+
+void TransformFile::Save(const std::string& path, TransformSystem& system, bool includeWorldMatrices) {
+	static_assert(sizeof(Header) == HeaderSize, "TransformFile header layout changed");
+
+	// Sorts into parent-before-child order and bakes the world matrices
+	system.UpdateWorldMatrices();
+
+	uint64_t count = system.Size();
+	uint64_t vec3Bytes = count * sizeof(Vec3);
+	uint64_t quaternionBytes = count * sizeof(Quaternion);
+	uint64_t parentBytes = count * sizeof(uint32_t);
+	uint64_t matrixBytes = count * sizeof(Mat4);
+
+	Header header = {};
+	header.magic = Magic;
+	header.version = Version;
+	header.count = static_cast<uint32_t>(count);
+	header.flags = includeWorldMatrices ? static_cast<uint32_t>(HasWorldMatrices) : 0u;
+	header.positionsOffset = HeaderSize;
+	header.rotationsOffset = header.positionsOffset + AlignUp(vec3Bytes);
+	header.scalesOffset = header.rotationsOffset + AlignUp(quaternionBytes);
+	header.parentsOffset = header.scalesOffset + AlignUp(vec3Bytes);
+	header.worldMatricesOffset = includeWorldMatrices ? header.parentsOffset + AlignUp(parentBytes) : 0;
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		throw std::runtime_error("TransformFile: cannot create " + path);
+	}
+
+	WriteSection(out, &header, sizeof(Header));
+	WriteSection(out, system.GetPositions(), vec3Bytes);
+	WriteSection(out, system.GetRotations(), quaternionBytes);
+	WriteSection(out, system.GetScales(), vec3Bytes);
+	WriteSection(out, system.GetParentIndices(), parentBytes);
+	if (includeWorldMatrices) {
+		WriteSection(out, system.GetWorldMatrices(), matrixBytes);
+	}
+
+	if (!out) {
+		throw std::runtime_error("TransformFile: failed writing " + path);
+	}
+}
+
+// Constructors
+TransformFile::TransformFile()
+	: data(nullptr),
+	size(0),
+	header(nullptr),
+	fileHandle(nullptr),
+	mappingHandle(nullptr) {
+}
+
+TransformFile::TransformFile(const std::string& path) : TransformFile() {
+	Open(path);
+}
+
+TransformFile::~TransformFile() {
+	Close();
+}
+
+void TransformFile::Open(const std::string& path) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("TransformFile: cannot open " + path);
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(HeaderSize)) {
+		CloseHandle(file);
+		throw std::runtime_error("TransformFile: " + path + " is too small");
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		if (mapping) {
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		throw std::runtime_error("TransformFile: cannot map " + path);
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		throw std::runtime_error("TransformFile: cannot open " + path);
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(HeaderSize)) {
+		close(file);
+		throw std::runtime_error("TransformFile: " + path + " is too small");
+	}
+
+	size_t fileSize = static_cast<size_t>(fileStat.st_size);
+	void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);  // The mapping keeps the file alive
+	if (view == MAP_FAILED) {
+		throw std::runtime_error("TransformFile: cannot map " + path);
+	}
+
+	size = fileSize;
+#endif
+
+	data = static_cast<const unsigned char*>(view);
+	header = reinterpret_cast<const Header*>(data);
+	Validate();
+}
+
+void TransformFile::Close() {
+	if (!data) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(static_cast<HANDLE>(mappingHandle));
+	CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+#endif
+
+	data = nullptr;
+	size = 0;
+	header = nullptr;
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+}
+
+void TransformFile::Validate() {
+	const char* problem = nullptr;
+	uint64_t count = header->count;
+
+	// Each section must lie inside the file and be suitably aligned
+	auto sectionFits = [&](uint64_t offset, uint64_t bytes) {
+		return offset >= HeaderSize && offset % sizeof(float) == 0 &&
+			offset <= size && bytes <= size - offset;
+	};
+
+	if (header->magic != Magic) {
+		problem = "bad magic number (not a transform file, or wrong byte order)";
+	}
+	else if (header->version != Version) {
+		problem = "unsupported version";
+	}
+	else if (!sectionFits(header->positionsOffset, count * sizeof(Vec3)) ||
+		!sectionFits(header->rotationsOffset, count * sizeof(Quaternion)) ||
+		!sectionFits(header->scalesOffset, count * sizeof(Vec3)) ||
+		!sectionFits(header->parentsOffset, count * sizeof(uint32_t))) {
+		problem = "truncated";
+	}
+	else if ((header->flags & HasWorldMatrices) && !sectionFits(header->worldMatricesOffset, count * sizeof(Mat4))) {
+		problem = "truncated world matrices";
+	}
+	else {
+		// Parents before children also rules out cycles
+		const uint32_t* parents = GetParentIndices();
+		for (uint32_t i = 0; i < count; i++) {
+			if (parents[i] != TransformSystem::NoParent && parents[i] >= i) {
+				problem = "parent stored after its child";
+				break;
+			}
+		}
+	}
+
+	if (problem) {
+		Close();
+		throw std::runtime_error(std::string("TransformFile: ") + problem);
+	}
+}
+
+// Accessors
+bool TransformFile::IsOpen() const {
+	return data != nullptr;
+}
+
+uint32_t TransformFile::Size() const {
+	return header ? header->count : 0;
+}
+
+const Vec3* TransformFile::GetPositions() const {
+	return reinterpret_cast<const Vec3*>(data + header->positionsOffset);
+}
+
+const Quaternion* TransformFile::GetRotations() const {
+	return reinterpret_cast<const Quaternion*>(data + header->rotationsOffset);
+}
+
+const Vec3* TransformFile::GetScales() const {
+	return reinterpret_cast<const Vec3*>(data + header->scalesOffset);
+}
+
+const uint32_t* TransformFile::GetParentIndices() const {
+	return reinterpret_cast<const uint32_t*>(data + header->parentsOffset);
+}
+
+const Mat4* TransformFile::GetWorldMatrices() const {
+	if (!(header->flags & HasWorldMatrices)) {
+		return nullptr;
+	}
+	return reinterpret_cast<const Mat4*>(data + header->worldMatricesOffset);
+}
+
+void TransformFile::LoadInto(TransformSystem& system, TransformHandle* outHandles) const {
+	if (!data) {
+		throw std::runtime_error("TransformFile: no file open");
+	}
+
+	system.LoadHierarchy(Size(), GetParentIndices(), GetPositions(), GetRotations(), GetScales(),
+		GetWorldMatrices(), outHandles);
+}
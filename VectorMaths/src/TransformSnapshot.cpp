@@ -0,0 +1,143 @@
+/**
+ * @file TransformSnapshot.cpp
+ * @brief Implementation of triple-buffered world matrix snapshots
+ */
+
+#include "../include/TransformSnapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+// TransformSnapshot
+TransformSnapshot::TransformSnapshot() : frame(0) {}
+
+uint64_t TransformSnapshot::GetFrame() const {
+	return frame;
+}
+
+size_t TransformSnapshot::Size() const {
+	return worldMatrices.size();
+}
+
+const Mat4* TransformSnapshot::GetWorldMatrices() const {
+	return worldMatrices.data();
+}
+
+const TransformHandle* TransformSnapshot::GetHandles() const {
+	return handles.data();
+}
+
+bool TransformSnapshot::TryGetWorldMatrix(TransformHandle handle, Mat4& worldMatrix) const {
+	if (handle.id >= idToIndex.size()) {
+		return false;
+	}
+
+	uint32_t index = idToIndex[handle.id];
+	if (index == TransformSystem::NoParent || handles[index] != handle) {
+		return false;
+	}
+
+	worldMatrix = worldMatrices[index];
+	return true;
+}
+
+// TransformSnapshotView
+TransformSnapshotView::TransformSnapshotView() : snapshot(nullptr), readerCount(nullptr) {}
+
+TransformSnapshotView::TransformSnapshotView(const TransformSnapshot* snapshot, std::atomic<uint32_t>* readerCount)
+	: snapshot(snapshot),
+	readerCount(readerCount) {
+}
+
+TransformSnapshotView::TransformSnapshotView(TransformSnapshotView&& other) noexcept
+	: snapshot(other.snapshot),
+	readerCount(other.readerCount) {
+	other.snapshot = nullptr;
+	other.readerCount = nullptr;
+}
+
+TransformSnapshotView& TransformSnapshotView::operator=(TransformSnapshotView&& other) noexcept {
+	if (this != &other) {
+		if (readerCount) {
+			readerCount->fetch_sub(1);
+		}
+		snapshot = other.snapshot;
+		readerCount = other.readerCount;
+		other.snapshot = nullptr;
+		other.readerCount = nullptr;
+	}
+	return *this;
+}
+
+TransformSnapshotView::~TransformSnapshotView() {
+	if (readerCount) {
+		readerCount->fetch_sub(1);
+	}
+}
+
+// TransformSnapshotBuffer
+TransformSnapshotBuffer::TransformSnapshotBuffer() : published(NoSnapshot), frameCounter(0) {
+	for (uint32_t i = 0; i < BufferCount; i++) {
+		readerCounts[i].store(0);
+	}
+}
+
+void TransformSnapshotBuffer::Publish(TransformSystem& system) {
+	system.UpdateWorldMatrices();
+
+	// Pick a buffer that is neither published nor being read
+	uint32_t current = published.load();
+	uint32_t target = NoSnapshot;
+	while (target == NoSnapshot) {
+		for (uint32_t i = 0; i < BufferCount; i++) {
+			if (i != current && readerCounts[i].load() == 0) {
+				target = i;
+				break;
+			}
+		}
+		if (target == NoSnapshot) {
+			std::this_thread::yield();
+		}
+	}
+
+	TransformSnapshot& snapshot = snapshots[target];
+	size_t count = system.Size();
+
+	snapshot.frame = ++frameCounter;
+	snapshot.worldMatrices.resize(count);
+	if (count > 0) {
+		std::memcpy(snapshot.worldMatrices.data(), system.GetWorldMatrices(), count * sizeof(Mat4));
+	}
+
+	snapshot.handles.resize(count);
+	uint32_t maxId = 0;
+	for (size_t i = 0; i < count; i++) {
+		snapshot.handles[i] = system.GetHandle(static_cast<uint32_t>(i));
+		maxId = std::max(maxId, snapshot.handles[i].id + 1);
+	}
+
+	snapshot.idToIndex.assign(maxId, TransformSystem::NoParent);
+	for (size_t i = 0; i < count; i++) {
+		snapshot.idToIndex[snapshot.handles[i].id] = static_cast<uint32_t>(i);
+	}
+
+	published.store(target);
+}
+
+TransformSnapshotView TransformSnapshotBuffer::Acquire() const {
+	for (;;) {
+		uint32_t index = published.load();
+		if (index == NoSnapshot) {
+			return TransformSnapshotView();
+		}
+
+		// Register as a reader, then confirm the buffer was not retired in between.
+		// The writer only reuses buffers that are unpublished with no readers.
+		readerCounts[index].fetch_add(1);
+		if (published.load() == index) {
+			return TransformSnapshotView(&snapshots[index], &readerCounts[index]);
+		}
+		readerCounts[index].fetch_sub(1);
+	}
+}
@@ -0,0 +1,1376 @@
+/**
+ * @file TransformSystem.cpp
+ * @brief Implementation of the flat transform hierarchy store
+ */
+
+#include "../include/TransformSystem.hpp"
+#include "../include/Transform.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/// Reusable barrier for a fixed number of threads (std::barrier is C++20)
+class ThreadBarrier {
+public:
+	explicit ThreadBarrier(unsigned count) : threadCount(count), waiting(0), generation(0) {}
+
+	/// Changes the number of threads; only valid while no thread is waiting
+	void Reset(unsigned count) {
+		threadCount = count;
+		waiting = 0;
+	}
+
+	void Wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		unsigned arrivalGeneration = generation;
+		if (++waiting == threadCount) {
+			waiting = 0;
+			generation++;
+			condition.notify_all();
+		}
+		else {
+			condition.wait(lock, [&]() { return generation != arrivalGeneration; });
+		}
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable condition;
+	unsigned threadCount;
+	unsigned waiting;
+	unsigned generation;
+};
+
+/// Reorders values so that values[i] becomes values[order[i]]
+template<typename T>
+void ApplyOrder(std::vector<T>& values, const std::vector<uint32_t>& order) {
+	std::vector<T> sorted;
+	sorted.reserve(values.size());
+	for (uint32_t oldIndex : order) {
+		sorted.push_back(values[oldIndex]);
+	}
+	values.swap(sorted);
+}
+
+/// Returns the world-space box around a local box (center and absolute-extent transform)
+AABB TransformBounds(const Mat4& m, const AABB& local) {
+	if (local.isEmpty()) {
+		return local;
+	}
+
+	Vec3 c = local.getCenter();
+	Vec3 e = local.getExtents();
+	Vec3 center(
+		m.m[0] * c.x + m.m[4] * c.y + m.m[8] * c.z + m.m[12],
+		m.m[1] * c.x + m.m[5] * c.y + m.m[9] * c.z + m.m[13],
+		m.m[2] * c.x + m.m[6] * c.y + m.m[10] * c.z + m.m[14]);
+	Vec3 extents(
+		std::fabs(m.m[0]) * e.x + std::fabs(m.m[4]) * e.y + std::fabs(m.m[8]) * e.z,
+		std::fabs(m.m[1]) * e.x + std::fabs(m.m[5]) * e.y + std::fabs(m.m[9]) * e.z,
+		std::fabs(m.m[2]) * e.x + std::fabs(m.m[6]) * e.y + std::fabs(m.m[10]) * e.z);
+	return AABB::fromCenterAndExtents(center, extents);
+}
+
+} // namespace
+
+/// Worker threads parked on a condition variable between parallel updates
+class TransformSystem::WorkerPool {
+public:
+	explicit WorkerPool(unsigned workerCount)
+		: barrier(1), cursorCount(0), currentJob(nullptr), activeThreads(0), remaining(0), round(0), stopping(false) {
+		workers.reserve(workerCount);
+		for (unsigned t = 0; t < workerCount; t++) {
+			workers.emplace_back(&WorkerPool::WorkerLoop, this, t + 1);
+		}
+	}
+
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	/// Number of threads a call can use, including the caller
+	unsigned GetThreadCount() const {
+		return static_cast<unsigned>(workers.size()) + 1;
+	}
+
+	/// Prepares the shared state for a call with the given thread and level counts
+	void Prepare(unsigned threadCount, uint32_t levelCount) {
+		barrier.Reset(threadCount);
+		if (levelCount > cursorCount) {
+			cursors.reset(new std::atomic<uint32_t>[levelCount]);
+			cursorCount = levelCount;
+		}
+		if (threadChanges.size() < threadCount) {
+			threadChanges.resize(threadCount);
+		}
+	}
+
+	/// Runs job(thread) on the caller as thread 0 and on threadCount - 1 workers, then waits for all of them
+	void Run(unsigned threadCount, const std::function<void(unsigned)>& job) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			currentJob = &job;
+			activeThreads = threadCount;
+			remaining = threadCount - 1;
+			round++;
+		}
+		wake.notify_all();
+
+		job(0);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&]() { return remaining == 0; });
+		currentJob = nullptr;
+	}
+
+	ThreadBarrier barrier;                                ///< Ends each level of a call
+	std::unique_ptr<std::atomic<uint32_t>[]> cursors;     ///< Next unclaimed dense index of each level
+	uint32_t cursorCount;                                 ///< Number of cursors allocated
+	std::vector<std::vector<uint32_t>> threadChanges;     ///< Dense indices whose world matrix each thread rebuilt
+
+private:
+	void WorkerLoop(unsigned thread) {
+		uint64_t seenRound = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			wake.wait(lock, [&]() { return stopping || round != seenRound; });
+			if (stopping) {
+				return;
+			}
+			seenRound = round;
+
+			// Calls with fewer threads leave the remaining workers parked
+			if (thread >= activeThreads) {
+				continue;
+			}
+
+			const std::function<void(unsigned)>& job = *currentJob;
+			lock.unlock();
+			job(thread);
+			lock.lock();
+
+			if (--remaining == 0) {
+				done.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;        ///< Signals a new call or shutdown to the workers
+	std::condition_variable done;        ///< Signals the caller that the last worker finished
+	const std::function<void(unsigned)>* currentJob;
+	unsigned activeThreads;
+	unsigned remaining;
+	uint64_t round;
+	bool stopping;
+};
+
+// Constructors
+TransformSystem::TransformSystem()
+	: levelOffsets(1, 0),
+	updatePass(0),
+	lastUpdateVisits(0),
+	orderDirty(false),
+	pendingChanges(false)
+{}
+
+TransformSystem::~TransformSystem() = default;
+
+TransformSystem::TransformSystem(TransformSystem&& other) noexcept = default;
+
+TransformSystem& TransformSystem::operator=(TransformSystem&& other) noexcept = default;
+
+void TransformSystem::Reserve(size_t count) {
+	positions.reserve(count);
+	rotations.reserve(count);
+	scales.reserve(count);
+	parents.reserve(count);
+	depths.reserve(count);
+	localMatrices.reserve(count);
+	worldMatrices.reserve(count);
+	flags.reserve(count);
+	worldVersions.reserve(count);
+	parentVersions.reserve(count);
+	denseToId.reserve(count);
+	previousPositions.reserve(count);
+	previousRotations.reserve(count);
+	previousScales.reserve(count);
+	localBounds.reserve(count);
+	worldBounds.reserve(count);
+	subtreeBounds.reserve(count);
+	idToDense.reserve(count);
+	generations.reserve(count);
+	firstChild.reserve(count);
+	lastChild.reserve(count);
+	nextSibling.reserve(count);
+	prevSibling.reserve(count);
+}
+
+size_t TransformSystem::Size() const {
+	return positions.size();
+}
+
+bool TransformSystem::IsAlive(TransformHandle handle) const {
+	return handle.id < generations.size() &&
+		generations[handle.id] == handle.generation &&
+		idToDense[handle.id] != NoParent;
+}
+
+TransformHandle TransformSystem::Create() {
+	return Create(Vec3(), Quaternion(), Vec3(1.0f, 1.0f, 1.0f));
+}
+
+TransformHandle TransformSystem::Create(const Vec3& position, const Quaternion& rotation, const Vec3& scale) {
+	return Allocate(position, rotation, scale);
+}
+
+void TransformSystem::CreateBatch(size_t count, const uint32_t* parentIndices, const Vec3* positions,
+	const Quaternion* rotations, const Vec3* scales, TransformHandle* outHandles) {
+	std::vector<TransformHandle> localHandles;
+	if (!outHandles) {
+		localHandles.resize(count);
+		outHandles = localHandles.data();
+	}
+
+	// Grow geometrically so repeated batches stay amortised O(1) per transform
+	if (Size() + count > this->positions.capacity()) {
+		Reserve(std::max(Size() + count, this->positions.capacity() * 2));
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		outHandles[i] = Allocate(
+			positions ? positions[i] : Vec3(),
+			rotations ? rotations[i] : Quaternion(),
+			scales ? scales[i] : Vec3(1.0f, 1.0f, 1.0f));
+	}
+
+	if (parentIndices) {
+		for (size_t i = 0; i < count; i++) {
+			if (parentIndices[i] != NoParent) {
+				SetParent(outHandles[i], outHandles[parentIndices[i]]);
+			}
+		}
+	}
+}
+
+void TransformSystem::LoadHierarchy(size_t count, const uint32_t* parentIndices, const Vec3* positions,
+	const Quaternion* rotations, const Vec3* scales, const Mat4* worldMatrices, TransformHandle* outHandles) {
+	Clear();
+
+	// Every slot is free after Clear(); transform i takes slot i
+	uint32_t n = static_cast<uint32_t>(count);
+	uint32_t slotCount = static_cast<uint32_t>(idToDense.size());
+	if (n > slotCount) {
+		idToDense.resize(n);
+		generations.resize(n, 0);
+		firstChild.resize(n, TransformHandle::InvalidId);
+		lastChild.resize(n, TransformHandle::InvalidId);
+		nextSibling.resize(n, TransformHandle::InvalidId);
+		prevSibling.resize(n, TransformHandle::InvalidId);
+	}
+	freeIds.clear();
+	for (uint32_t id = std::max(n, slotCount); id > n; id--) {
+		freeIds.push_back(id - 1);
+	}
+
+	this->positions.assign(positions, positions + n);
+	this->rotations.assign(rotations, rotations + n);
+	this->scales.assign(scales, scales + n);
+	parents.assign(parentIndices, parentIndices + n);
+	previousPositions.assign(positions, positions + n);
+	previousRotations.assign(rotations, rotations + n);
+	previousScales.assign(scales, scales + n);
+	localBounds.assign(n, AABB::empty());
+	worldBounds.assign(n, AABB::empty());
+	subtreeBounds.assign(n, AABB::empty());
+	localMatrices.resize(n);
+	if (worldMatrices) {
+		this->worldMatrices.assign(worldMatrices, worldMatrices + n);
+	}
+	else {
+		this->worldMatrices.resize(n);
+	}
+
+	// Supplied world matrices are already final; otherwise every transform is queued
+	uint8_t initialFlags = worldMatrices ? (LocalDirty | Journaled) : (LocalDirty | WorldDirty | Queued | Journaled);
+	flags.assign(n, initialFlags);
+	worldVersions.assign(n, 0);
+	parentVersions.assign(n, 0);
+	denseToId.resize(n);
+	depths.resize(n);
+	changedIds.resize(n);
+	if (!worldMatrices) {
+		dirtyIds.resize(n);
+	}
+
+	// The fast path needs parents before children and depths in ascending order
+	bool sorted = true;
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t parent = parents[i];
+		assert((parent == NoParent || parent < n) && "Parent index out of range");
+
+		denseToId[i] = i;
+		idToDense[i] = i;
+		changedIds[i] = i;
+		if (!worldMatrices) {
+			dirtyIds[i] = i;
+		}
+
+		if (parent == NoParent) {
+			depths[i] = 0;
+		}
+		else {
+			LinkChild(parent, i);
+			if (parent < i) {
+				depths[i] = depths[parent] + 1;
+			}
+			else {
+				depths[i] = 0;
+				sorted = false;
+			}
+		}
+		if (i > 0 && depths[i] < depths[i - 1]) {
+			sorted = false;
+		}
+
+		if (outHandles) {
+			outHandles[i] = GetHandle(i);
+		}
+	}
+
+	if (sorted) {
+		RebuildLevelOffsets();
+	}
+	else {
+		orderDirty = true;
+	}
+	pendingChanges = !worldMatrices;
+}
+
+void TransformSystem::Destroy(TransformHandle handle) {
+	DestroyBatch(&handle, 1);
+}
+
+void TransformSystem::DestroyBatch(const TransformHandle* handles, size_t count) {
+	std::vector<uint32_t> stack;
+	bool removedAny = false;
+
+	for (size_t i = 0; i < count; i++) {
+		// Already gone, e.g. as a descendant of an earlier handle in the batch
+		if (!IsAlive(handles[i])) {
+			continue;
+		}
+
+		uint32_t rootId = handles[i].id;
+		uint32_t parent = parents[idToDense[rootId]];
+		if (parent != NoParent) {
+			UnlinkChild(denseToId[parent], rootId);
+			MarkBoundsDirty(parent);
+		}
+
+		// Release the whole subtree; dense entries are removed by Compact()
+		stack.push_back(rootId);
+		while (!stack.empty()) {
+			uint32_t id = stack.back();
+			stack.pop_back();
+
+			for (uint32_t child = firstChild[id]; child != TransformHandle::InvalidId; child = nextSibling[child]) {
+				stack.push_back(child);
+			}
+
+			denseToId[idToDense[id]] = TransformHandle::InvalidId;
+			idToDense[id] = NoParent;
+			generations[id]++;
+			firstChild[id] = lastChild[id] = TransformHandle::InvalidId;
+			nextSibling[id] = prevSibling[id] = TransformHandle::InvalidId;
+			freeIds.push_back(id);
+		}
+		removedAny = true;
+	}
+
+	if (removedAny) {
+		Compact();
+	}
+}
+
+void TransformSystem::Clear() {
+	for (uint32_t id : denseToId) {
+		idToDense[id] = NoParent;
+		generations[id]++;
+		firstChild[id] = lastChild[id] = TransformHandle::InvalidId;
+		nextSibling[id] = prevSibling[id] = TransformHandle::InvalidId;
+		freeIds.push_back(id);
+	}
+
+	positions.clear();
+	rotations.clear();
+	scales.clear();
+	parents.clear();
+	depths.clear();
+	localMatrices.clear();
+	worldMatrices.clear();
+	flags.clear();
+	worldVersions.clear();
+	parentVersions.clear();
+	denseToId.clear();
+	previousPositions.clear();
+	previousRotations.clear();
+	previousScales.clear();
+	localBounds.clear();
+	worldBounds.clear();
+	subtreeBounds.clear();
+	levelOffsets.assign(1, 0);
+	dirtyIds.clear();
+	changedIds.clear();
+	movingIds.clear();
+	boundsDirtyIds.clear();
+
+	orderDirty = false;
+	pendingChanges = false;
+}
+
+TransformHandle TransformSystem::Allocate(const Vec3& position, const Quaternion& rotation, const Vec3& scale) {
+	uint32_t index = static_cast<uint32_t>(positions.size());
+
+	uint32_t id;
+	if (!freeIds.empty()) {
+		id = freeIds.back();
+		freeIds.pop_back();
+		idToDense[id] = index;
+	}
+	else {
+		id = static_cast<uint32_t>(idToDense.size());
+		idToDense.push_back(index);
+		generations.push_back(0);
+		firstChild.push_back(TransformHandle::InvalidId);
+		lastChild.push_back(TransformHandle::InvalidId);
+		nextSibling.push_back(TransformHandle::InvalidId);
+		prevSibling.push_back(TransformHandle::InvalidId);
+	}
+
+	// A new root only breaks the depth order if deeper transforms precede it
+	if (!depths.empty() && depths.back() > 0) {
+		orderDirty = true;
+	}
+	else if (!orderDirty) {
+		// Every transform is a root, so there is a single level
+		if (levelOffsets.size() == 1) {
+			levelOffsets.push_back(0);
+		}
+		levelOffsets.back()++;
+	}
+
+	positions.push_back(position);
+	rotations.push_back(rotation);
+	scales.push_back(scale);
+	parents.push_back(NoParent);
+	depths.push_back(0);
+	localMatrices.emplace_back();
+	worldMatrices.emplace_back();
+	flags.push_back(LocalDirty | WorldDirty);
+	worldVersions.push_back(0);
+	parentVersions.push_back(0);
+	denseToId.push_back(id);
+	previousPositions.push_back(position);
+	previousRotations.push_back(rotation);
+	previousScales.push_back(scale);
+	localBounds.push_back(AABB::empty());
+	worldBounds.push_back(AABB::empty());
+	subtreeBounds.push_back(AABB::empty());
+
+	// New transforms are always reported once, even if they sit at the origin
+	flags[index] |= Journaled;
+	changedIds.push_back(id);
+
+	QueueDirty(index);
+	pendingChanges = true;
+
+	TransformHandle handle;
+	handle.id = id;
+	handle.generation = generations[id];
+	return handle;
+}
+
+// Accessors
+Mat4 TransformSystem::GetLocalMatrix(TransformHandle handle) const {
+	uint32_t index = GetIndex(handle);
+	UpdateLocalMatrix(index);
+	return localMatrices[index];
+}
+
+Mat4 TransformSystem::GetWorldMatrix(TransformHandle handle) const {
+	uint32_t index = GetIndex(handle);
+	if (pendingChanges) {
+		ResolveWorldMatrix(index);
+	}
+	return worldMatrices[index];
+}
+
+Vec3 TransformSystem::GetPosition(TransformHandle handle) const {
+	return positions[GetIndex(handle)];
+}
+
+Quaternion TransformSystem::GetRotation(TransformHandle handle) const {
+	return rotations[GetIndex(handle)];
+}
+
+Vec3 TransformSystem::GetScale(TransformHandle handle) const {
+	return scales[GetIndex(handle)];
+}
+
+TransformHandle TransformSystem::GetParent(TransformHandle handle) const {
+	uint32_t parent = parents[GetIndex(handle)];
+	if (parent == NoParent) {
+		return TransformHandle();
+	}
+	return GetHandle(parent);
+}
+
+TransformHandle TransformSystem::GetFirstChild(TransformHandle handle) const {
+	assert(IsAlive(handle) && "Invalid TransformHandle");
+	uint32_t child = firstChild[handle.id];
+	if (child == TransformHandle::InvalidId) {
+		return TransformHandle();
+	}
+	return GetHandle(idToDense[child]);
+}
+
+TransformHandle TransformSystem::GetNextSibling(TransformHandle handle) const {
+	assert(IsAlive(handle) && "Invalid TransformHandle");
+	uint32_t sibling = nextSibling[handle.id];
+	if (sibling == TransformHandle::InvalidId) {
+		return TransformHandle();
+	}
+	return GetHandle(idToDense[sibling]);
+}
+
+std::vector<TransformHandle> TransformSystem::GetChildren(TransformHandle handle) const {
+	std::vector<TransformHandle> result;
+	for (TransformHandle child = GetFirstChild(handle); child.IsValid(); child = GetNextSibling(child)) {
+		result.push_back(child);
+	}
+	return result;
+}
+
+// Transform directions
+Vec3 TransformSystem::Forward(TransformHandle handle) const {
+	Vec3 forward;
+	GetWorldBasis(&handle, 1, nullptr, nullptr, &forward);
+	return forward;
+}
+
+Vec3 TransformSystem::Right(TransformHandle handle) const {
+	Vec3 right;
+	GetWorldBasis(&handle, 1, &right, nullptr, nullptr);
+	return right;
+}
+
+Vec3 TransformSystem::Up(TransformHandle handle) const {
+	Vec3 up;
+	GetWorldBasis(&handle, 1, nullptr, &up, nullptr);
+	return up;
+}
+
+void TransformSystem::GetWorldBasis(const TransformHandle* handles, size_t count,
+	Vec3* rights, Vec3* ups, Vec3* forwards) const {
+	for (size_t i = 0; i < count; i++) {
+		uint32_t index = GetIndex(handles[i]);
+		if (pendingChanges) {
+			ResolveWorldMatrix(index);
+		}
+
+		const float* m = worldMatrices[index].m;
+		if (rights) {
+			rights[i] = Vec3(m[0], m[1], m[2]).normalised();
+		}
+		if (ups) {
+			ups[i] = Vec3(m[4], m[5], m[6]).normalised();
+		}
+		if (forwards) {
+			forwards[i] = Vec3(-m[8], -m[9], -m[10]).normalised();  // OpenGL convention
+		}
+	}
+}
+
+// Mutators
+void TransformSystem::SetPosition(TransformHandle handle, const Vec3& newPosition) {
+	uint32_t index = GetIndex(handle);
+	positions[index] = newPosition;
+	MarkDirty(index);
+}
+
+void TransformSystem::SetRotation(TransformHandle handle, const Quaternion& newRotation) {
+	uint32_t index = GetIndex(handle);
+	rotations[index] = newRotation;
+	MarkDirty(index);
+}
+
+void TransformSystem::SetScale(TransformHandle handle, const Vec3& newScale) {
+	uint32_t index = GetIndex(handle);
+	scales[index] = newScale;
+	MarkDirty(index);
+}
+
+void TransformSystem::SetParent(TransformHandle handle, TransformHandle newParent) {
+	uint32_t index = GetIndex(handle);
+	uint32_t parentIndex = newParent.IsValid() ? GetIndex(newParent) : NoParent;
+
+	if (parents[index] == parentIndex) {
+		return;
+	}
+
+#ifndef NDEBUG
+	for (uint32_t ancestor = parentIndex; ancestor != NoParent; ancestor = parents[ancestor]) {
+		assert(ancestor != index && "TransformSystem::SetParent would create a cycle");
+	}
+#endif
+
+	// Both parents' subtree bounds change even if the world matrix does not
+	if (parents[index] != NoParent) {
+		UnlinkChild(denseToId[parents[index]], handle.id);
+		MarkBoundsDirty(parents[index]);
+	}
+	if (parentIndex != NoParent) {
+		LinkChild(newParent.id, handle.id);
+		MarkBoundsDirty(parentIndex);
+	}
+
+	parents[index] = parentIndex;
+	flags[index] |= WorldDirty;
+	QueueDirty(index);
+
+	// Depths of the whole subtree change, so they are recomputed by the sort
+	orderDirty = true;
+	pendingChanges = true;
+}
+
+void TransformSystem::AddChild(TransformHandle parent, TransformHandle child) {
+	SetParent(child, parent);
+}
+
+void TransformSystem::RemoveChild(TransformHandle parent, TransformHandle child) {
+	if (GetParent(child) == parent) {
+		SetParent(child, TransformHandle());
+	}
+}
+
+void TransformSystem::Translate(TransformHandle handle, const Vec3& translation) {
+	uint32_t index = GetIndex(handle);
+	positions[index] = positions[index] + translation;
+	MarkDirty(index);
+}
+
+void TransformSystem::Rotate(TransformHandle handle, const Quaternion& extraRotation) {
+	uint32_t index = GetIndex(handle);
+	rotations[index] = rotations[index] * extraRotation;
+	MarkDirty(index);
+}
+
+// Batched mutators
+void TransformSystem::SetLocalTransforms(const TransformHandle* handles, const Vec3* newPositions,
+	const Quaternion* newRotations, const Vec3* newScales, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		uint32_t index = GetIndex(handles[i]);
+		if (newPositions) {
+			positions[index] = newPositions[i];
+		}
+		if (newRotations) {
+			rotations[index] = newRotations[i];
+		}
+		if (newScales) {
+			scales[index] = newScales[i];
+		}
+		MarkDirty(index);
+	}
+}
+
+void TransformSystem::SetPositions(const TransformHandle* handles, const Vec3* newPositions, size_t count) {
+	SetLocalTransforms(handles, newPositions, nullptr, nullptr, count);
+}
+
+void TransformSystem::SetRotations(const TransformHandle* handles, const Quaternion* newRotations, size_t count) {
+	SetLocalTransforms(handles, nullptr, newRotations, nullptr, count);
+}
+
+void TransformSystem::SetScales(const TransformHandle* handles, const Vec3* newScales, size_t count) {
+	SetLocalTransforms(handles, nullptr, nullptr, newScales, count);
+}
+
+// Bulk update
+void TransformSystem::UpdateWorldMatrices() {
+	if (orderDirty) {
+		SortByDepth();
+	}
+
+	if (!pendingChanges) {
+		lastUpdateVisits = 0;
+		return;
+	}
+
+	// A handful of changed subtrees is cheaper to visit than the whole array
+	uint32_t count = static_cast<uint32_t>(positions.size());
+	if (dirtyIds.size() * 16 < count) {
+		UpdateDirtySubtrees();
+	}
+	else {
+		// Parents precede children, so each parent is final before its children read it
+		lastUpdateVisits = count;
+		for (uint32_t i = 0; i < count; i++) {
+			if (UpdateWorldMatrix(i)) {
+				RecordWorldChange(i);
+			}
+		}
+	}
+
+	ClearDirtyList();
+	pendingChanges = false;
+}
+
+void TransformSystem::UpdateWorldMatricesParallel(unsigned threadCount) {
+	if (orderDirty) {
+		SortByDepth();
+	}
+
+	if (!pendingChanges) {
+		lastUpdateVisits = 0;
+		return;
+	}
+
+	// A handful of changed subtrees is not worth a pass over every level
+	uint32_t count = static_cast<uint32_t>(positions.size());
+	if (dirtyIds.size() * 16 < count) {
+		UpdateWorldMatrices();
+		return;
+	}
+
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	uint32_t levelCount = static_cast<uint32_t>(levelOffsets.size() - 1);
+	threadCount = std::min(threadCount, count / ParallelGrain);
+
+	// Each level ends with a barrier, which does not pay off for narrow levels
+	if (threadCount < 2 || count / levelCount < ParallelGrain) {
+		UpdateWorldMatrices();
+		return;
+	}
+
+	// Workers are started once and parked between calls; a bigger request replaces the pool
+	if (!workerPool || workerPool->GetThreadCount() < threadCount) {
+		workerPool.reset();
+		workerPool = std::make_unique<WorkerPool>(threadCount - 1);
+	}
+	WorkerPool& pool = *workerPool;
+	pool.Prepare(threadCount, levelCount);
+	for (uint32_t level = 0; level < levelCount; level++) {
+		pool.cursors[level].store(levelOffsets[level]);
+	}
+
+	lastUpdateVisits = count;
+	pool.Run(threadCount, [&](unsigned thread) {
+		std::vector<uint32_t>& changed = pool.threadChanges[thread];
+		for (uint32_t level = 0; level < levelCount; level++) {
+			uint32_t levelEnd = levelOffsets[level + 1];
+			uint32_t start = pool.cursors[level].fetch_add(ParallelGrain);
+			while (start < levelEnd) {
+				uint32_t end = std::min(start + ParallelGrain, levelEnd);
+				for (uint32_t i = start; i < end; i++) {
+					if (UpdateWorldMatrix(i)) {
+						changed.push_back(i);
+					}
+				}
+				start = pool.cursors[level].fetch_add(ParallelGrain);
+			}
+
+			// Children in the next level read this level's world matrices
+			pool.barrier.Wait();
+		}
+	});
+
+	// Journaling and bounds flags go through shared lists, so they are recorded once the workers finish
+	for (unsigned thread = 0; thread < threadCount; thread++) {
+		for (uint32_t index : pool.threadChanges[thread]) {
+			RecordWorldChange(index);
+		}
+		pool.threadChanges[thread].clear();
+	}
+
+	ClearDirtyList();
+	pendingChanges = false;
+}
+
+uint32_t TransformSystem::GetIndex(TransformHandle handle) const {
+	assert(IsAlive(handle) && "Invalid TransformHandle");
+	return idToDense[handle.id];
+}
+
+uint32_t TransformSystem::GetLastUpdateVisitCount() const {
+	return lastUpdateVisits;
+}
+
+TransformHandle TransformSystem::GetHandle(uint32_t index) const {
+	TransformHandle handle;
+	handle.id = denseToId[index];
+	handle.generation = generations[handle.id];
+	return handle;
+}
+
+void TransformSystem::ConsumeChangedTransforms(std::vector<TransformHandle>& changed) {
+	if (orderDirty) {
+		SortByDepth();
+	}
+
+	// Dense order is hierarchy order; sorting also removes duplicates left by reused slots
+	std::vector<uint32_t> indices;
+	indices.reserve(changedIds.size());
+	for (uint32_t id : changedIds) {
+		uint32_t index = idToDense[id];
+		if (index != NoParent) {
+			indices.push_back(index);
+			flags[index] &= ~Journaled;
+		}
+	}
+	changedIds.clear();
+
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	changed.clear();
+	changed.reserve(indices.size());
+	for (uint32_t index : indices) {
+		changed.push_back(GetHandle(index));
+	}
+}
+
+const Mat4* TransformSystem::GetWorldMatrices() const {
+	return worldMatrices.data();
+}
+
+const uint32_t* TransformSystem::GetParentIndices() const {
+	return parents.data();
+}
+
+const Vec3* TransformSystem::GetPositions() const {
+	return positions.data();
+}
+
+const Quaternion* TransformSystem::GetRotations() const {
+	return rotations.data();
+}
+
+const Vec3* TransformSystem::GetScales() const {
+	return scales.data();
+}
+
+// Fixed-timestep interpolation
+void TransformSystem::SavePreviousState() {
+	for (uint32_t id : movingIds) {
+		uint32_t index = idToDense[id];
+		if (index == NoParent || !(flags[index] & Moving)) {
+			continue;
+		}
+
+		previousPositions[index] = positions[index];
+		previousRotations[index] = rotations[index];
+		previousScales[index] = scales[index];
+		flags[index] &= ~Moving;
+	}
+	movingIds.clear();
+}
+
+void TransformSystem::InterpolateWorldMatrices(float alpha, std::vector<Mat4>& renderMatrices) {
+	UpdateWorldMatrices();
+
+	alpha = std::clamp(alpha, 0.0f, 1.0f);
+	uint32_t count = static_cast<uint32_t>(positions.size());
+	renderMatrices.resize(count);
+	interpolatedScratch.resize(count);
+
+	// Parents precede children, so a parent's render matrix is final before its children read it
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t parent = parents[i];
+		bool moving = (flags[i] & Moving) != 0;
+		bool parentInterpolated = parent != NoParent && interpolatedScratch[parent];
+
+		if (!moving && !parentInterpolated) {
+			renderMatrices[i] = worldMatrices[i];
+			interpolatedScratch[i] = 0;
+			continue;
+		}
+
+		Mat4 local;
+		if (moving) {
+			const Vec3& p0 = previousPositions[i];
+			const Vec3& p1 = positions[i];
+			const Vec3& s0 = previousScales[i];
+			const Vec3& s1 = scales[i];
+			local = Transform::ComposeMatrix(
+				Vec3(p0.x + (p1.x - p0.x) * alpha, p0.y + (p1.y - p0.y) * alpha, p0.z + (p1.z - p0.z) * alpha),
+				simd::Nlerp(previousRotations[i], rotations[i], alpha),
+				Vec3(s0.x + (s1.x - s0.x) * alpha, s0.y + (s1.y - s0.y) * alpha, s0.z + (s1.z - s0.z) * alpha));
+		}
+		else {
+			UpdateLocalMatrix(i);
+			local = localMatrices[i];
+		}
+
+		if (parent == NoParent) {
+			renderMatrices[i] = local;
+		}
+		else if (parentInterpolated) {
+			simd::MultiplyMat4(renderMatrices[parent], local, renderMatrices[i]);
+		}
+		else {
+			simd::MultiplyMat4(worldMatrices[parent], local, renderMatrices[i]);
+		}
+		interpolatedScratch[i] = 1;
+	}
+}
+
+// Hierarchical bounds
+void TransformSystem::SetLocalBounds(TransformHandle handle, const AABB& bounds) {
+	uint32_t index = GetIndex(handle);
+	localBounds[index] = bounds;
+	MarkBoundsDirty(index);
+}
+
+AABB TransformSystem::GetLocalBounds(TransformHandle handle) const {
+	return localBounds[GetIndex(handle)];
+}
+
+AABB TransformSystem::GetWorldBounds(TransformHandle handle) {
+	UpdateBounds();
+	return worldBounds[GetIndex(handle)];
+}
+
+AABB TransformSystem::GetSubtreeBounds(TransformHandle handle) {
+	UpdateBounds();
+	return subtreeBounds[GetIndex(handle)];
+}
+
+void TransformSystem::UpdateBounds() {
+	UpdateWorldMatrices();
+
+	if (boundsDirtyIds.empty()) {
+		return;
+	}
+
+	// Bucket the flagged transforms by depth; slots destroyed since they were flagged are skipped
+	for (uint32_t id : boundsDirtyIds) {
+		uint32_t index = idToDense[id];
+		if (index == NoParent || !(flags[index] & BoundsDirty)) {
+			continue;
+		}
+		if (depths[index] >= boundsLevels.size()) {
+			boundsLevels.resize(depths[index] + 1);
+		}
+		boundsLevels[depths[index]].push_back(index);
+	}
+	boundsDirtyIds.clear();
+
+	// Deepest level first, so every child is refit before its parent
+	for (size_t level = boundsLevels.size(); level-- > 0;) {
+		for (uint32_t i : boundsLevels[level]) {
+			// Listed twice if its slot was reused after being flagged
+			if (!(flags[i] & BoundsDirty)) {
+				continue;
+			}
+			flags[i] &= ~BoundsDirty;
+
+			worldBounds[i] = TransformBounds(worldMatrices[i], localBounds[i]);
+			AABB bounds = worldBounds[i];
+			for (uint32_t child = firstChild[denseToId[i]]; child != TransformHandle::InvalidId; child = nextSibling[child]) {
+				bounds = bounds.merge(subtreeBounds[idToDense[child]]);
+			}
+
+			// Unchanged bounds stop the refit from climbing any further
+			if (std::memcmp(&bounds, &subtreeBounds[i], sizeof(AABB)) == 0) {
+				continue;
+			}
+			subtreeBounds[i] = bounds;
+
+			uint32_t parent = parents[i];
+			if (parent != NoParent && !(flags[parent] & BoundsDirty)) {
+				flags[parent] |= BoundsDirty;
+				boundsLevels[level - 1].push_back(parent);
+			}
+		}
+		boundsLevels[level].clear();
+	}
+}
+
+void TransformSystem::QueryBounds(const AABB& region, std::vector<TransformHandle>& results) {
+	CullSubtrees([&](const AABB& bounds) { return aabbIntersectsAABB(bounds, region); }, results);
+}
+
+void TransformSystem::QueryFrustum(const Frustum& frustum, std::vector<TransformHandle>& results) {
+	CullSubtrees([&](const AABB& bounds) { return frustum.intersects(bounds); }, results);
+}
+
+template<typename BoundsTest>
+void TransformSystem::CullSubtrees(const BoundsTest& overlaps, std::vector<TransformHandle>& results) {
+	UpdateBounds();
+	results.clear();
+
+	// Roots occupy the first depth level
+	uint32_t rootCount = levelOffsets.size() > 1 ? levelOffsets[1] : 0;
+	for (uint32_t root = rootCount; root-- > 0;) {
+		visitStack.push_back(denseToId[root]);
+	}
+
+	while (!visitStack.empty()) {
+		uint32_t id = visitStack.back();
+		visitStack.pop_back();
+
+		uint32_t index = idToDense[id];
+		if (subtreeBounds[index].isEmpty() || !overlaps(subtreeBounds[index])) {
+			continue;
+		}
+		if (!worldBounds[index].isEmpty() && overlaps(worldBounds[index])) {
+			results.push_back(GetHandle(index));
+		}
+
+		for (uint32_t child = lastChild[id]; child != TransformHandle::InvalidId; child = prevSibling[child]) {
+			visitStack.push_back(child);
+		}
+	}
+}
+
+// Internal helpers
+void TransformSystem::LinkChild(uint32_t parentId, uint32_t childId) {
+	uint32_t tail = lastChild[parentId];
+	prevSibling[childId] = tail;
+	nextSibling[childId] = TransformHandle::InvalidId;
+
+	if (tail != TransformHandle::InvalidId) {
+		nextSibling[tail] = childId;
+	}
+	else {
+		firstChild[parentId] = childId;
+	}
+	lastChild[parentId] = childId;
+}
+
+void TransformSystem::UnlinkChild(uint32_t parentId, uint32_t childId) {
+	uint32_t prev = prevSibling[childId];
+	uint32_t next = nextSibling[childId];
+
+	if (prev != TransformHandle::InvalidId) {
+		nextSibling[prev] = next;
+	}
+	else {
+		firstChild[parentId] = next;
+	}
+
+	if (next != TransformHandle::InvalidId) {
+		prevSibling[next] = prev;
+	}
+	else {
+		lastChild[parentId] = prev;
+	}
+
+	prevSibling[childId] = TransformHandle::InvalidId;
+	nextSibling[childId] = TransformHandle::InvalidId;
+}
+
+void TransformSystem::Compact() {
+	uint32_t count = static_cast<uint32_t>(positions.size());
+	std::vector<uint32_t> oldToNew(count, NoParent);
+
+	// Stable removal keeps parents ahead of their children
+	uint32_t kept = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (denseToId[i] == TransformHandle::InvalidId) {
+			continue;
+		}
+
+		oldToNew[i] = kept;
+		if (kept != i) {
+			positions[kept] = positions[i];
+			rotations[kept] = rotations[i];
+			scales[kept] = scales[i];
+			parents[kept] = parents[i];
+			depths[kept] = depths[i];
+			localMatrices[kept] = localMatrices[i];
+			worldMatrices[kept] = worldMatrices[i];
+			flags[kept] = flags[i];
+			worldVersions[kept] = worldVersions[i];
+			parentVersions[kept] = parentVersions[i];
+			denseToId[kept] = denseToId[i];
+			previousPositions[kept] = previousPositions[i];
+			previousRotations[kept] = previousRotations[i];
+			previousScales[kept] = previousScales[i];
+			localBounds[kept] = localBounds[i];
+			worldBounds[kept] = worldBounds[i];
+			subtreeBounds[kept] = subtreeBounds[i];
+		}
+		kept++;
+	}
+
+	positions.resize(kept);
+	rotations.resize(kept);
+	scales.resize(kept);
+	parents.resize(kept);
+	depths.resize(kept);
+	localMatrices.resize(kept);
+	worldMatrices.resize(kept);
+	flags.resize(kept);
+	worldVersions.resize(kept);
+	parentVersions.resize(kept);
+	denseToId.resize(kept);
+	previousPositions.resize(kept);
+	previousRotations.resize(kept);
+	previousScales.resize(kept);
+	localBounds.resize(kept);
+	worldBounds.resize(kept);
+	subtreeBounds.resize(kept);
+
+	for (uint32_t i = 0; i < kept; i++) {
+		if (parents[i] != NoParent) {
+			parents[i] = oldToNew[parents[i]];
+		}
+		idToDense[denseToId[i]] = i;
+	}
+
+	if (!orderDirty) {
+		RebuildLevelOffsets();
+	}
+}
+
+void TransformSystem::RebuildLevelOffsets() {
+	levelOffsets.assign(1, 0);
+	for (uint32_t i = 0; i < depths.size(); i++) {
+		if (depths[i] + 1 >= levelOffsets.size()) {
+			levelOffsets.resize(depths[i] + 2, i);
+		}
+		levelOffsets[depths[i] + 1] = i + 1;
+	}
+}
+
+void TransformSystem::MarkDirty(uint32_t index) {
+	if (!(flags[index] & Moving)) {
+		movingIds.push_back(denseToId[index]);
+	}
+	flags[index] |= LocalDirty | WorldDirty | Moving;
+	QueueDirty(index);
+	pendingChanges = true;
+}
+
+void TransformSystem::QueueDirty(uint32_t index) {
+	if (!(flags[index] & Queued)) {
+		flags[index] |= Queued;
+		dirtyIds.push_back(denseToId[index]);
+	}
+}
+
+void TransformSystem::MarkBoundsDirty(uint32_t index) const {
+	if (!(flags[index] & BoundsDirty)) {
+		flags[index] |= BoundsDirty;
+		boundsDirtyIds.push_back(denseToId[index]);
+	}
+}
+
+void TransformSystem::RecordWorldChange(uint32_t index) const {
+	MarkBoundsDirty(index);
+	if (!(flags[index] & Journaled)) {
+		flags[index] |= Journaled;
+		changedIds.push_back(denseToId[index]);
+	}
+}
+
+void TransformSystem::ClearDirtyList() {
+	for (uint32_t id : dirtyIds) {
+		uint32_t index = idToDense[id];
+		if (index != NoParent) {
+			flags[index] &= ~Queued;
+		}
+	}
+	dirtyIds.clear();
+}
+
+void TransformSystem::UpdateDirtySubtrees() {
+	// Sorted by dense index, ancestors are visited before their descendants
+	std::vector<uint32_t> roots;
+	roots.reserve(dirtyIds.size());
+	for (uint32_t id : dirtyIds) {
+		uint32_t index = idToDense[id];
+		if (index != NoParent) {
+			roots.push_back(index);
+		}
+	}
+	std::sort(roots.begin(), roots.end());
+
+	visitPasses.resize(positions.size(), 0);
+	updatePass++;
+	lastUpdateVisits = 0;
+
+	// Every stale transform has a queued ancestor (or is queued itself), so
+	// the ancestors of an unvisited root are already up to date
+	for (uint32_t root : roots) {
+		// Already covered by the subtree of an earlier dirty ancestor
+		if (visitPasses[root] == updatePass) {
+			continue;
+		}
+
+		visitStack.push_back(denseToId[root]);
+		while (!visitStack.empty()) {
+			uint32_t id = visitStack.back();
+			visitStack.pop_back();
+
+			uint32_t index = idToDense[id];
+			if (UpdateWorldMatrix(index)) {
+				RecordWorldChange(index);
+			}
+			visitPasses[index] = updatePass;
+			lastUpdateVisits++;
+
+			for (uint32_t child = firstChild[id]; child != TransformHandle::InvalidId; child = nextSibling[child]) {
+				visitStack.push_back(child);
+			}
+		}
+	}
+}
+
+void TransformSystem::UpdateLocalMatrix(uint32_t index) const {
+	if (flags[index] & LocalDirty) {
+		localMatrices[index] = Transform::ComposeMatrix(positions[index], rotations[index], scales[index]);
+		flags[index] &= ~LocalDirty;
+	}
+}
+
+bool TransformSystem::UpdateWorldMatrix(uint32_t index) const {
+	uint32_t parent = parents[index];
+	bool parentChanged = parent != NoParent && parentVersions[index] != worldVersions[parent];
+
+	if (!(flags[index] & WorldDirty) && !parentChanged) {
+		return false;
+	}
+
+	UpdateLocalMatrix(index);
+
+	Mat4 world;
+	if (parent != NoParent) {
+		world = worldMatrices[parent] * localMatrices[index];
+		parentVersions[index] = worldVersions[parent];
+	}
+	else {
+		world = localMatrices[index];
+	}
+	flags[index] &= ~WorldDirty;
+
+	// An identical result leaves the descendants' cached matrices valid
+	if (std::memcmp(world.m, worldMatrices[index].m, sizeof(world.m)) == 0) {
+		return false;
+	}
+
+	worldMatrices[index] = world;
+	worldVersions[index]++;
+	return true;
+}
+
+void TransformSystem::ResolveWorldMatrix(uint32_t index) const {
+	// Walk up to the root, then update back down so each parent is final first
+	chainScratch.clear();
+	for (uint32_t node = index; node != NoParent; node = parents[node]) {
+		chainScratch.push_back(node);
+	}
+
+	for (auto it = chainScratch.rbegin(); it != chainScratch.rend(); ++it) {
+		if (UpdateWorldMatrix(*it)) {
+			RecordWorldChange(*it);
+		}
+	}
+}
+
+void TransformSystem::SortByDepth() {
+	uint32_t count = static_cast<uint32_t>(positions.size());
+	const uint32_t unknown = 0xFFFFFFFFu;
+
+	// Compute depths; parents may currently follow their children
+	std::vector<uint32_t> newDepths(count, unknown);
+	std::vector<uint32_t> pending;
+	uint32_t maxDepth = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t node = i;
+		while (node != NoParent && newDepths[node] == unknown) {
+			pending.push_back(node);
+			node = parents[node];
+		}
+
+		uint32_t depth = (node == NoParent) ? 0 : newDepths[node] + 1;
+		while (!pending.empty()) {
+			newDepths[pending.back()] = depth++;
+			pending.pop_back();
+		}
+		maxDepth = std::max(maxDepth, newDepths[i]);
+	}
+
+	// Stable counting sort by depth
+	std::vector<uint32_t> levelStart(maxDepth + 2, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		levelStart[newDepths[i] + 1]++;
+	}
+	for (uint32_t d = 1; d < levelStart.size(); d++) {
+		levelStart[d] += levelStart[d - 1];
+	}
+
+	std::vector<uint32_t> order(count);
+	std::vector<uint32_t> oldToNew(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t newIndex = levelStart[newDepths[i]]++;
+		order[newIndex] = i;
+		oldToNew[i] = newIndex;
+	}
+
+	ApplyOrder(positions, order);
+	ApplyOrder(rotations, order);
+	ApplyOrder(scales, order);
+	ApplyOrder(parents, order);
+	ApplyOrder(localMatrices, order);
+	ApplyOrder(worldMatrices, order);
+	ApplyOrder(flags, order);
+	ApplyOrder(worldVersions, order);
+	ApplyOrder(parentVersions, order);
+	ApplyOrder(denseToId, order);
+	ApplyOrder(previousPositions, order);
+	ApplyOrder(previousRotations, order);
+	ApplyOrder(previousScales, order);
+	ApplyOrder(localBounds, order);
+	ApplyOrder(worldBounds, order);
+	ApplyOrder(subtreeBounds, order);
+	ApplyOrder(newDepths, order);
+	depths.swap(newDepths);
+
+	// levelStart[d] now holds the end of level d
+	levelOffsets.assign(1, 0);
+	levelOffsets.insert(levelOffsets.end(), levelStart.begin(), levelStart.begin() + maxDepth + 1);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (parents[i] != NoParent) {
+			parents[i] = oldToNew[parents[i]];
+		}
+		idToDense[denseToId[i]] = i;
+	}
+
+	orderDirty = false;
+}
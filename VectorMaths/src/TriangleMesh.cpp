@@ -0,0 +1,254 @@
+/**
+ * @file TriangleMesh.cpp
+ * @brief Implementation of the triangle mesh collider
+ */
+
+#include "../include/TriangleMesh.hpp"
+#include "BVHBuilder.hpp"
+#include "RayTraversal.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// Constructors
+TriangleMesh::TriangleMesh() {}
+
+void TriangleMesh::build(const Vec3* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+	assert(indexCount % 3 == 0 && "Index count must be a multiple of 3");
+	(void)vertexCount;
+	clear();
+
+	uint32_t count = static_cast<uint32_t>(indexCount / 3);
+	if (count == 0) {
+		return;
+	}
+
+	std::vector<bvhbuild::BuildPrimitive> primitives(count);
+	for (uint32_t i = 0; i < count; i++) {
+		assert(indices[3 * i] < vertexCount && indices[3 * i + 1] < vertexCount && indices[3 * i + 2] < vertexCount);
+		AABB bounds = AABB::empty();
+		bounds.expand(vertices[indices[3 * i]]);
+		bounds.expand(vertices[indices[3 * i + 1]]);
+		bounds.expand(vertices[indices[3 * i + 2]]);
+		bvhbuild::InitPrimitive(primitives[i], bounds, i);
+	}
+	bvhbuild::Build(nodes, primitives);
+
+	// Copy the vertices out in leaf order so leaves never go through the index buffer
+	triangles.resize(count);
+	triangleIndices.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t triangle = primitives[i].index;
+		triangles[i].a = vertices[indices[3 * triangle]];
+		triangles[i].b = vertices[indices[3 * triangle + 1]];
+		triangles[i].c = vertices[indices[3 * triangle + 2]];
+		triangleIndices[i] = triangle;
+	}
+}
+
+void TriangleMesh::clear() {
+	nodes.clear();
+	triangles.clear();
+	triangleIndices.clear();
+}
+
+size_t TriangleMesh::getTriangleCount() const {
+	return triangles.size();
+}
+
+size_t TriangleMesh::getNodeCount() const {
+	return nodes.size();
+}
+
+AABB TriangleMesh::getBounds() const {
+	return nodes.empty() ? AABB::empty() : nodes[0].bounds;
+}
+
+// Ray queries
+bool TriangleMesh::raycast(const Ray& ray, TriangleHit& hit, float maxDistance) const {
+	return traverse(ray, hit, maxDistance, false);
+}
+
+bool TriangleMesh::raycastAny(const Ray& ray, float maxDistance) const {
+	TriangleHit hit;
+	return traverse(ray, hit, maxDistance, true);
+}
+
+uint32_t TriangleMesh::raycast(const RayPacket& packet, TriangleHit hits[RayPacket::Width], float maxDistance) const {
+	return traversePacket(packet, hits, maxDistance, false);
+}
+
+uint32_t TriangleMesh::raycastAny(const RayPacket& packet, float maxDistance) const {
+	TriangleHit hits[RayPacket::Width];
+	return traversePacket(packet, hits, maxDistance, true);
+}
+
+// Internal helpers
+bool TriangleMesh::traverse(const Ray& ray, TriangleHit& hit, float maxDistance, bool anyHit) const {
+	if (nodes.empty()) {
+		return false;
+	}
+
+	const traversal::ShearedRay sheared = traversal::ShearRay(ray);
+	float closest = maxDistance;
+	bool found = false;
+
+	traversal::StackEntry stack[BVH::MaxDepth];
+	uint32_t stackSize = 0;
+	float entry;
+	if (traversal::RayHitsBoxConservative(ray, nodes[0].bounds, closest, entry)) {
+		stack[stackSize++] = { 0, entry };
+	}
+
+	while (stackSize > 0) {
+		traversal::StackEntry current = stack[--stackSize];
+
+		// A closer hit was found after this node was pushed
+		if (current.entry > closest * traversal::ConservativeScale) {
+			continue;
+		}
+
+		const Node& node = nodes[current.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+				const Triangle& triangle = triangles[i];
+				float distance;
+				float u;
+				float v;
+				if (traversal::IntersectTriangle(sheared, triangle.a, triangle.b, triangle.c, distance, u, v) &&
+					traversal::IsCloserHit(distance, triangleIndices[i], closest, found, hit.index)) {
+					closest = distance;
+					hit.index = triangleIndices[i];
+					hit.distance = distance;
+					hit.u = u;
+					hit.v = v;
+					found = true;
+					if (anyHit) {
+						return true;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so later boxes can be pruned
+		uint32_t left = current.node + 1;
+		uint32_t right = node.offset;
+		float leftEntry;
+		float rightEntry;
+		bool hitLeft = traversal::RayHitsBoxConservative(ray, nodes[left].bounds, closest, leftEntry);
+		bool hitRight = traversal::RayHitsBoxConservative(ray, nodes[right].bounds, closest, rightEntry);
+
+		if (hitLeft && hitRight) {
+			if (leftEntry <= rightEntry) {
+				stack[stackSize++] = { right, rightEntry };
+				stack[stackSize++] = { left, leftEntry };
+			}
+			else {
+				stack[stackSize++] = { left, leftEntry };
+				stack[stackSize++] = { right, rightEntry };
+			}
+		}
+		else if (hitLeft) {
+			stack[stackSize++] = { left, leftEntry };
+		}
+		else if (hitRight) {
+			stack[stackSize++] = { right, rightEntry };
+		}
+	}
+
+	return found;
+}
+
+uint32_t TriangleMesh::traversePacket(const RayPacket& packet, TriangleHit hits[RayPacket::Width], float maxDistance, bool anyHit) const {
+	uint32_t active = packet.activeMask;
+	if (nodes.empty() || active == 0) {
+		return 0;
+	}
+
+	// Node tests run on all lanes at once; triangle tests run per lane on the sheared rays
+	traversal::ShearedRay sheared[RayPacket::Width];
+	for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+		if ((active >> lane) & 1u) {
+			sheared[lane] = traversal::ShearRay(packet.getRay(lane));
+		}
+	}
+
+	float closest[RayPacket::Width];
+	std::fill(closest, closest + RayPacket::Width, maxDistance);
+	uint32_t found = 0;
+
+	uint32_t stack[BVH::MaxDepth];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		uint32_t current = stack[--stackSize];
+		const Node& node = nodes[current];
+
+		// Lanes that still reach this node, given their closest hits so far
+		float entry[RayPacket::Width];
+		uint32_t mask = simd::PacketHitsBoxConservative(packet, node.bounds, closest, entry) & active;
+		if (mask == 0) {
+			continue;
+		}
+
+		if (node.count > 0) {
+			for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+				const Triangle& triangle = triangles[i];
+				for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+					float distance;
+					float u;
+					float v;
+					if (((mask >> lane) & 1u) &&
+						traversal::IntersectTriangle(sheared[lane], triangle.a, triangle.b, triangle.c, distance, u, v) &&
+						traversal::IsCloserHit(distance, triangleIndices[i], closest[lane], (found >> lane) & 1u, hits[lane].index)) {
+						closest[lane] = distance;
+						hits[lane].index = triangleIndices[i];
+						hits[lane].distance = distance;
+						hits[lane].u = u;
+						hits[lane].v = v;
+						found |= 1u << lane;
+					}
+				}
+
+				if (anyHit) {
+					active &= ~found;
+					mask &= ~found;
+					if (active == 0) {
+						return found;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Visit the child whose center is further along the first lane's ray last, so it's popped first
+		uint32_t lane = 0;
+		while (!((mask >> lane) & 1u)) {
+			lane++;
+		}
+		uint32_t left = current + 1;
+		uint32_t right = node.offset;
+		const AABB& leftBounds = nodes[left].bounds;
+		const AABB& rightBounds = nodes[right].bounds;
+		float leftAlong = (leftBounds.min.x + leftBounds.max.x) * packet.directionX[lane] +
+			(leftBounds.min.y + leftBounds.max.y) * packet.directionY[lane] +
+			(leftBounds.min.z + leftBounds.max.z) * packet.directionZ[lane];
+		float rightAlong = (rightBounds.min.x + rightBounds.max.x) * packet.directionX[lane] +
+			(rightBounds.min.y + rightBounds.max.y) * packet.directionY[lane] +
+			(rightBounds.min.z + rightBounds.max.z) * packet.directionZ[lane];
+
+		if (leftAlong <= rightAlong) {
+			stack[stackSize++] = right;
+			stack[stackSize++] = left;
+		}
+		else {
+			stack[stackSize++] = left;
+			stack[stackSize++] = right;
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file BVHTests.cpp
+ * @brief Unit tests for the BVH class, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "BVH.hpp"
+#include "TestScenes.hpp"
+#include <random>
+#include <vector>
+
+TEST(BVHTest, EmptyHierarchy) {
+    BVH bvh;
+    bvh.build(static_cast<const AABB*>(nullptr), 0);
+
+    RayHit hit;
+    std::vector<uint32_t> results = { 7 };
+    EXPECT_EQ(bvh.size(), 0u);
+    EXPECT_TRUE(bvh.getBounds().isEmpty());
+    EXPECT_FALSE(bvh.raycast(Ray(Vec3(), Vec3(0, 0, 1)), hit));
+    EXPECT_FALSE(bvh.raycastAny(Ray(Vec3(), Vec3(0, 0, 1))));
+    bvh.queryOverlaps(AABB(Vec3(-1, -1, -1), Vec3(1, 1, 1)), results);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(BVHTest, RaycastMatchesBruteForceOverBoxes) {
+    std::vector<AABB> boxes = RandomBoxes(2000, 50.0f, 1);
+    BVH bvh;
+    bvh.build(boxes.data(), boxes.size());
+    EXPECT_EQ(bvh.size(), boxes.size());
+    EXPECT_LT(bvh.getNodeCount(), 2 * boxes.size());
+
+    for (const Ray& ray : RandomRays(500, 60.0f, 2)) {
+        RayHit expected;
+        bool expectedFound = ClosestHit(ray, boxes, rayIntersectsAABB, expected);
+
+        RayHit hit;
+        bool found = bvh.raycast(ray, hit);
+        ASSERT_EQ(found, expectedFound);
+        EXPECT_EQ(bvh.raycastAny(ray), found);
+        if (found) {
+            EXPECT_FLOAT_EQ(hit.distance, expected.distance);
+            float own;
+            ASSERT_TRUE(rayIntersectsAABB(ray, boxes[hit.index], own));
+            EXPECT_FLOAT_EQ(own, hit.distance);
+
+            // Limiting the distance to just short of the hit finds nothing closer
+            RayHit limited;
+            if (bvh.raycast(ray, limited, expected.distance * 0.999f)) {
+                EXPECT_LT(limited.distance, expected.distance);
+            }
+        }
+    }
+}
+
+TEST(BVHTest, RaycastMatchesBruteForceOverSpheres) {
+    std::vector<Sphere> spheres = RandomSpheres(1000, 50.0f, 3, 0.2f, 4.0f);
+
+    BVH bvh;
+    bvh.build(spheres.data(), spheres.size());
+
+    for (const Ray& ray : RandomRays(500, 60.0f, 4)) {
+        RayHit expected;
+        bool expectedFound = ClosestHit(ray, spheres, rayIntersectsSphere, expected);
+
+        RayHit hit;
+        bool found = bvh.raycast(ray, hit);
+        ASSERT_EQ(found, expectedFound);
+        if (found) {
+            EXPECT_FLOAT_EQ(hit.distance, expected.distance);
+        }
+    }
+
+    // Sphere primitives are tested exactly, not by their bounding boxes
+    Sphere query(Vec3(0, 0, 0), 10.0f);
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+        if (sphereIntersectsSphere(spheres[i], query)) {
+            expected.push_back(i);
+        }
+    }
+    std::vector<uint32_t> results;
+    bvh.queryOverlaps(query, results);
+    EXPECT_EQ(Sorted(results), expected);
+}
+
+TEST(BVHTest, OverlapQueriesMatchBruteForce) {
+    std::vector<AABB> boxes = RandomBoxes(3000, 50.0f, 5);
+    BVH bvh;
+    bvh.build(boxes.data(), boxes.size());
+
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::vector<uint32_t> results;
+    for (int q = 0; q < 100; q++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        AABB box = AABB::fromCenterAndExtents(center, Vec3(5, 8, 3));
+        Sphere sphere(center, 6.0f);
+
+        std::vector<uint32_t> expectedBox;
+        std::vector<uint32_t> expectedSphere;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            if (aabbIntersectsAABB(boxes[i], box)) {
+                expectedBox.push_back(i);
+            }
+            if (sphereIntersectsAABB(sphere, boxes[i])) {
+                expectedSphere.push_back(i);
+            }
+        }
+
+        bvh.queryOverlaps(box, results);
+        EXPECT_EQ(Sorted(results), expectedBox);
+        bvh.queryOverlaps(sphere, results);
+        EXPECT_EQ(Sorted(results), expectedSphere);
+    }
+}
+
+TEST(BVHTest, HandlesCoincidentPrimitives) {
+    // Identical centroids leave no SAH plane; the build must still terminate and split
+    std::vector<AABB> boxes(100, AABB(Vec3(-1, -1, -1), Vec3(1, 1, 1)));
+    BVH bvh;
+    bvh.build(boxes.data(), boxes.size());
+    EXPECT_GT(bvh.getNodeCount(), 1u);
+
+    std::vector<uint32_t> results;
+    bvh.queryOverlaps(AABB(Vec3(0, 0, 0), Vec3(0.5f, 0.5f, 0.5f)), results);
+    EXPECT_EQ(results.size(), boxes.size());
+
+    RayHit hit;
+    ASSERT_TRUE(bvh.raycast(Ray(Vec3(0, 0, -5), Vec3(0, 0, 1)), hit));
+    EXPECT_FLOAT_EQ(hit.distance, 4.0f);
+}
@@ -18,9 +18,9 @@ TEST(RayTest, DefaultConstructor) {
     EXPECT_FLOAT_EQ(r.origin.x, 0.0f);
     EXPECT_FLOAT_EQ(r.origin.y, 0.0f);
     EXPECT_FLOAT_EQ(r.origin.z, 0.0f);
-    EXPECT_FLOAT_EQ(r.direction.x, 0.0f);
-    EXPECT_FLOAT_EQ(r.direction.y, 0.0f);
-    EXPECT_FLOAT_EQ(r.direction.z, 1.0f);
+    EXPECT_FLOAT_EQ(r.getDirection().x, 0.0f);
+    EXPECT_FLOAT_EQ(r.getDirection().y, 0.0f);
+    EXPECT_FLOAT_EQ(r.getDirection().z, 1.0f);
 }
 
 TEST(RayTest, ParameterizedConstructor) {
@@ -29,16 +29,16 @@ TEST(RayTest, ParameterizedConstructor) {
     EXPECT_FLOAT_EQ(r.origin.y, 2.0f);
     EXPECT_FLOAT_EQ(r.origin.z, 3.0f);
     // Direction should be normalized
-    EXPECT_NEAR(r.direction.length(), 1.0f, 1e-6f);
+    EXPECT_NEAR(r.getDirection().length(), 1.0f, 1e-6f);
 }
 
 TEST(RayTest, DirectionNormalization) {
     Ray r(Vec3(0.0f, 0.0f, 0.0f), Vec3(3.0f, 4.0f, 0.0f));
     // Vec3(3, 4, 0) has length 5, so normalized is (0.6, 0.8, 0)
-    EXPECT_NEAR(r.direction.x, 0.6f, 1e-5f);
-    EXPECT_NEAR(r.direction.y, 0.8f, 1e-5f);
-    EXPECT_FLOAT_EQ(r.direction.z, 0.0f);
-    EXPECT_NEAR(r.direction.length(), 1.0f, 1e-6f);
+    EXPECT_NEAR(r.getDirection().x, 0.6f, 1e-5f);
+    EXPECT_NEAR(r.getDirection().y, 0.8f, 1e-5f);
+    EXPECT_FLOAT_EQ(r.getDirection().z, 0.0f);
+    EXPECT_NEAR(r.getDirection().length(), 1.0f, 1e-6f);
 }
 
 TEST(RayTest, GetPoint) {
@@ -55,6 +55,22 @@ TEST(RayTest, GetPoint) {
     EXPECT_FLOAT_EQ(p5.z, 3.0f);
 }
 
+TEST(RayTest, CachesInverseDirectionAndSigns) {
+    Ray r(Vec3(0.0f, 0.0f, 0.0f), Vec3(-3.0f, 4.0f, 0.0f));
+    EXPECT_FLOAT_EQ(r.getInverseDirection().x, 1.0f / r.getDirection().x);
+    EXPECT_FLOAT_EQ(r.getInverseDirection().y, 1.0f / r.getDirection().y);
+    EXPECT_TRUE(std::isinf(r.getInverseDirection().z));
+    EXPECT_EQ(r.getSign(0), 1);
+    EXPECT_EQ(r.getSign(1), 0);
+    EXPECT_EQ(r.getSign(2), 0);
+
+    r.setDirection(Vec3(0.0f, 0.0f, -2.0f));
+    EXPECT_FLOAT_EQ(r.getDirection().z, -1.0f);
+    EXPECT_FLOAT_EQ(r.getInverseDirection().z, -1.0f);
+    EXPECT_EQ(r.getSign(0), 0);
+    EXPECT_EQ(r.getSign(2), 1);
+}
+
 // ========== AABB Tests ==========
 
 TEST(AABBTest, DefaultConstructor) {
@@ -143,6 +159,26 @@ TEST(AABBTest, Merge) {
     EXPECT_FLOAT_EQ(merged.max.z, 3.0f);
 }
 
+TEST(AABBTest, EmptyMergesAsIdentity) {
+    AABB box(Vec3(1.0f, 2.0f, 3.0f), Vec3(4.0f, 5.0f, 6.0f));
+    AABB empty = AABB::empty();
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_FALSE(box.isEmpty());
+    EXPECT_FLOAT_EQ(empty.getSurfaceArea(), 0.0f);
+
+    AABB merged = empty.merge(box);
+    EXPECT_FLOAT_EQ(merged.min.x, 1.0f);
+    EXPECT_FLOAT_EQ(merged.max.z, 6.0f);
+}
+
+TEST(AABBTest, ContainsBoxAndSurfaceArea) {
+    AABB outer(Vec3(0.0f, 0.0f, 0.0f), Vec3(2.0f, 3.0f, 4.0f));
+    EXPECT_TRUE(outer.contains(AABB(Vec3(0.5f, 0.5f, 0.5f), Vec3(1.0f, 1.0f, 1.0f))));
+    EXPECT_TRUE(outer.contains(outer));
+    EXPECT_FALSE(outer.contains(AABB(Vec3(1.0f, 1.0f, 1.0f), Vec3(2.5f, 1.0f, 1.0f))));
+    EXPECT_FLOAT_EQ(outer.getSurfaceArea(), 2.0f * (6.0f + 12.0f + 8.0f));
+}
+
 // ========== Sphere Tests ==========
 
 TEST(SphereTest, DefaultConstructor) {
@@ -248,6 +284,85 @@ TEST(IntersectionTest, RayIntersectsAABB_Miss) {
     EXPECT_FALSE(rayIntersectsAABB(ray, box, distance));
 }
 
+TEST(IntersectionTest, RayIntersectsAABB_AxisParallel) {
+    AABB box(Vec3(-1.0f, -1.0f, -1.0f), Vec3(1.0f, 1.0f, 1.0f));
+    float distance;
+
+    // Parallel to x, inside the y and z slabs
+    EXPECT_TRUE(rayIntersectsAABB(Ray(Vec3(-5.0f, 0.5f, 0.0f), Vec3(1.0f, 0.0f, 0.0f)), box, distance));
+    EXPECT_FLOAT_EQ(distance, 4.0f);
+
+    // Parallel to x, outside the y slab
+    EXPECT_FALSE(rayIntersectsAABB(Ray(Vec3(-5.0f, 1.5f, 0.0f), Vec3(1.0f, 0.0f, 0.0f)), box, distance));
+
+    // Lying exactly on a face (0 * infinity would be NaN): touching counts as a hit
+    EXPECT_TRUE(rayIntersectsAABB(Ray(Vec3(-5.0f, 1.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f)), box, distance));
+    EXPECT_FLOAT_EQ(distance, 4.0f);
+    EXPECT_TRUE(rayIntersectsAABB(Ray(Vec3(-5.0f, -1.0f, 1.0f), Vec3(1.0f, 0.0f, 0.0f)), box, distance));
+    EXPECT_FALSE(std::isnan(distance));
+
+    // Negative direction along a face, and from inside the box
+    EXPECT_TRUE(rayIntersectsAABB(Ray(Vec3(1.0f, 5.0f, -1.0f), Vec3(0.0f, -1.0f, 0.0f)), box, distance));
+    EXPECT_FLOAT_EQ(distance, 4.0f);
+    EXPECT_TRUE(rayIntersectsAABB(Ray(Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, -1.0f)), box, distance));
+    EXPECT_FLOAT_EQ(distance, 1.0f);
+
+    // Pointing away
+    EXPECT_FALSE(rayIntersectsAABB(Ray(Vec3(0.0f, 0.0f, 5.0f), Vec3(0.0f, 0.0f, 1.0f)), box, distance));
+}
+
+TEST(IntersectionTest, RayIntersectsTriangle_Hit) {
+    Vec3 a(0.0f, 0.0f, 0.0f), b(4.0f, 0.0f, 0.0f), c(0.0f, 4.0f, 0.0f);
+    Ray ray(Vec3(1.0f, 2.0f, 5.0f), Vec3(0.0f, 0.0f, -1.0f));
+    float distance, u, v;
+
+    EXPECT_TRUE(rayIntersectsTriangle(ray, a, b, c, distance, u, v));
+    EXPECT_FLOAT_EQ(distance, 5.0f);
+    EXPECT_FLOAT_EQ(u, 0.25f);
+    EXPECT_FLOAT_EQ(v, 0.5f);
+
+    // Both faces are hit, with the same barycentric coordinates
+    EXPECT_TRUE(rayIntersectsTriangle(Ray(Vec3(1.0f, 2.0f, -5.0f), Vec3(0.0f, 0.0f, 1.0f)), a, b, c, distance, u, v));
+    EXPECT_FLOAT_EQ(distance, 5.0f);
+    EXPECT_FLOAT_EQ(u, 0.25f);
+    EXPECT_FLOAT_EQ(v, 0.5f);
+
+    // Oblique ray: the barycentric point is the ray's point
+    Ray oblique(Vec3(-3.0f, 1.0f, 2.0f), Vec3(1.5f, 0.2f, -0.7f));
+    Vec3 a2(0.0f, -1.0f, -2.0f), b2(1.0f, 3.0f, 1.0f), c2(3.0f, 0.0f, 0.5f);
+    ASSERT_TRUE(rayIntersectsTriangle(oblique, a2, b2, c2, distance, u, v));
+    Vec3 point = a2 * (1.0f - u - v) + b2 * u + c2 * v;
+    Vec3 along = oblique.getPoint(distance);
+    EXPECT_NEAR(point.x, along.x, 1e-5f);
+    EXPECT_NEAR(point.y, along.y, 1e-5f);
+    EXPECT_NEAR(point.z, along.z, 1e-5f);
+}
+
+TEST(IntersectionTest, RayIntersectsTriangle_Miss) {
+    Vec3 a(0.0f, 0.0f, 0.0f), b(4.0f, 0.0f, 0.0f), c(0.0f, 4.0f, 0.0f);
+    float distance, u, v;
+
+    EXPECT_FALSE(rayIntersectsTriangle(Ray(Vec3(3.0f, 3.0f, 5.0f), Vec3(0.0f, 0.0f, -1.0f)), a, b, c, distance, u, v));
+    EXPECT_FALSE(rayIntersectsTriangle(Ray(Vec3(1.0f, 1.0f, 5.0f), Vec3(0.0f, 0.0f, 1.0f)), a, b, c, distance, u, v));
+    EXPECT_FALSE(rayIntersectsTriangle(Ray(Vec3(1.0f, 1.0f, 5.0f), Vec3(1.0f, 0.0f, 0.0f)), a, b, c, distance, u, v));
+
+    // Degenerate triangles are never hit
+    EXPECT_FALSE(rayIntersectsTriangle(Ray(Vec3(1.0f, 0.0f, 5.0f), Vec3(0.0f, 0.0f, -1.0f)), a, b, b * 0.5f, distance, u, v));
+}
+
+TEST(IntersectionTest, RayIntersectsTriangle_SharedEdge) {
+    // A unit quad split along its diagonal; rays down the diagonal hit at least one half
+    Vec3 p0(0.0f, 0.0f, 0.0f), p1(1.0f, 0.0f, 0.0f), p2(1.0f, 1.0f, 0.0f), p3(0.0f, 1.0f, 0.0f);
+    float distance, u, v;
+    for (int i = 0; i <= 10; i++) {
+        float t = i / 10.0f;
+        Ray ray(Vec3(t, t, 3.0f), Vec3(0.0f, 0.0f, -1.0f));
+        bool first = rayIntersectsTriangle(ray, p0, p1, p2, distance, u, v);
+        bool second = rayIntersectsTriangle(ray, p0, p2, p3, distance, u, v);
+        EXPECT_TRUE(first || second) << "diagonal point " << t;
+    }
+}
+
 TEST(IntersectionTest, AABBIntersectsAABB_Overlapping) {
     AABB box1(Vec3(0.0f, 0.0f, 0.0f), Vec3(2.0f, 2.0f, 2.0f));
     AABB box2(Vec3(1.0f, 1.0f, 1.0f), Vec3(3.0f, 3.0f, 3.0f));
@@ -319,3 +434,14 @@ TEST(IntersectionTest, SphereIntersectsSphere_Contained) {
 
     EXPECT_TRUE(sphereIntersectsSphere(s1, s2));
 }
+
+TEST(IntersectionTest, SphereIntersectsAABB) {
+    AABB box(Vec3(0.0f, 0.0f, 0.0f), Vec3(2.0f, 2.0f, 2.0f));
+
+    EXPECT_TRUE(sphereIntersectsAABB(Sphere(Vec3(1.0f, 1.0f, 1.0f), 0.1f), box));   // Inside
+    EXPECT_TRUE(sphereIntersectsAABB(Sphere(Vec3(3.0f, 1.0f, 1.0f), 1.0f), box));   // Touching a face
+    EXPECT_FALSE(sphereIntersectsAABB(Sphere(Vec3(3.0f, 1.0f, 1.0f), 0.9f), box));
+    // Near a corner the face distances overlap but the corner distance does not
+    EXPECT_FALSE(sphereIntersectsAABB(Sphere(Vec3(2.8f, 2.8f, 2.8f), 1.0f), box));
+    EXPECT_TRUE(sphereIntersectsAABB(Sphere(Vec3(2.5f, 2.5f, 2.5f), 1.0f), box));
+}
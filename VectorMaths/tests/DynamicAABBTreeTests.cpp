@@ -0,0 +1,183 @@
+/**
+ * @file DynamicAABBTreeTests.cpp
+ * @brief Unit tests for DynamicAABBTree, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "DynamicAABBTree.hpp"
+#include "TestScenes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Helper: a set of moving boxes mirrored in a tree
+struct MovingScene {
+    DynamicAABBTree tree;
+    std::vector<uint32_t> proxies;
+    std::vector<AABB> boxes;
+    std::mt19937 rng;
+
+    MovingScene(size_t count, unsigned seed) : rng(seed) {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> size(0.2f, 2.0f);
+        for (size_t i = 0; i < count; i++) {
+            Vec3 center(position(rng), position(rng), position(rng));
+            boxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng))));
+            proxies.push_back(tree.createProxy(boxes.back()));
+        }
+    }
+
+    void Step(float speed) {
+        std::uniform_real_distribution<float> velocity(-speed, speed);
+        for (size_t i = 0; i < boxes.size(); i++) {
+            Vec3 displacement(velocity(rng), velocity(rng), velocity(rng));
+            boxes[i] = AABB(boxes[i].min + displacement, boxes[i].max + displacement);
+            tree.moveProxy(proxies[i], boxes[i], displacement);
+        }
+    }
+};
+
+TEST(DynamicAABBTreeTest, FatBoundsContainTightBounds) {
+    DynamicAABBTree tree(0.5f, 2.0f);
+    AABB box(Vec3(0, 0, 0), Vec3(1, 1, 1));
+    uint32_t proxy = tree.createProxy(box);
+    EXPECT_EQ(tree.size(), 1u);
+    EXPECT_TRUE(tree.getFatBounds(proxy).contains(box));
+    EXPECT_FLOAT_EQ(tree.getFatBounds(proxy).min.x, -0.5f);
+
+    // Small moves stay inside the fat box and leave the tree untouched
+    AABB nudged(Vec3(0.2f, 0, 0), Vec3(1.2f, 1, 1));
+    EXPECT_FALSE(tree.moveProxy(proxy, nudged, Vec3(0.2f, 0, 0)));
+    EXPECT_FLOAT_EQ(tree.getBounds(proxy).min.x, 0.2f);
+
+    // Leaving the fat box reinserts, extending the new fat box along the movement
+    AABB moved(Vec3(5, 0, 0), Vec3(6, 1, 1));
+    EXPECT_TRUE(tree.moveProxy(proxy, moved, Vec3(1, 0, 0)));
+    const AABB& fat = tree.getFatBounds(proxy);
+    EXPECT_TRUE(fat.contains(moved));
+    EXPECT_FLOAT_EQ(fat.max.x, 6.0f + 0.5f + 2.0f);
+    EXPECT_FLOAT_EQ(fat.min.x, 5.0f - 0.5f);
+
+    // A fast move leaves a long fat box; coming to rest inside it still leaves the tree untouched
+    AABB flung(Vec3(10, 0, 0), Vec3(11, 1, 1));
+    EXPECT_TRUE(tree.moveProxy(proxy, flung, Vec3(10, 0, 0)));
+    AABB rest(Vec3(10.5f, 0, 0), Vec3(11.5f, 1, 1));
+    EXPECT_FALSE(tree.moveProxy(proxy, rest, Vec3()));
+    EXPECT_FLOAT_EQ(tree.getFatBounds(proxy).max.x, 11.0f + 0.5f + 20.0f);
+
+    tree.destroyProxy(proxy);
+    EXPECT_EQ(tree.size(), 0u);
+    RayHit hit;
+    EXPECT_FALSE(tree.raycast(Ray(Vec3(-10, 0.5f, 0.5f), Vec3(1, 0, 0)), hit));
+}
+
+TEST(DynamicAABBTreeTest, StaysBalancedUnderSortedInsertion) {
+    // Inserting along a line degenerates an unbalanced tree into a list
+    DynamicAABBTree tree;
+    for (int i = 0; i < 4096; i++) {
+        float x = static_cast<float>(i) * 3.0f;
+        tree.createProxy(AABB(Vec3(x, 0, 0), Vec3(x + 1, 1, 1)));
+    }
+    EXPECT_LE(tree.getHeight(), 2u * 12u);
+}
+
+TEST(DynamicAABBTreeTest, QueriesMatchBruteForceWhileMoving) {
+    MovingScene scene(800, 7);
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<uint32_t> results;
+
+    for (int step = 0; step < 10; step++) {
+        scene.Step(step % 3 == 0 ? 3.0f : 0.05f);
+
+        // Remove and re-add a few proxies to exercise node reuse
+        for (int k = 0; k < 20; k++) {
+            size_t i = rng() % scene.boxes.size();
+            scene.tree.destroyProxy(scene.proxies[i]);
+            scene.proxies[i] = scene.tree.createProxy(scene.boxes[i]);
+        }
+        ASSERT_EQ(scene.tree.size(), scene.boxes.size());
+        EXPECT_LE(scene.tree.getHeight(), 2u * 10u);
+
+        // Fat boxes always enclose the tight ones
+        for (size_t i = 0; i < scene.boxes.size(); i++) {
+            ASSERT_TRUE(scene.tree.getFatBounds(scene.proxies[i]).contains(scene.boxes[i]));
+        }
+
+        // Box query over fat boxes
+        AABB query = AABB::fromCenterAndExtents(Vec3(position(rng), position(rng), position(rng)), Vec3(8, 8, 8));
+        std::vector<uint32_t> expected;
+        for (uint32_t proxy : scene.proxies) {
+            if (aabbIntersectsAABB(scene.tree.getFatBounds(proxy), query)) {
+                expected.push_back(proxy);
+            }
+        }
+        scene.tree.queryOverlaps(query, results);
+        EXPECT_EQ(Sorted(results), Sorted(expected));
+
+        // Ray queries over tight boxes
+        for (int r = 0; r < 50; r++) {
+            Ray ray(Vec3(position(rng), position(rng), position(rng)), Vec3(direction(rng), direction(rng), direction(rng)));
+            RayHit expected;
+            bool expectedFound = ClosestHit(ray, scene.boxes, rayIntersectsAABB, expected);
+
+            RayHit hit;
+            bool found = scene.tree.raycast(ray, hit);
+            ASSERT_EQ(found, expectedFound);
+            EXPECT_EQ(scene.tree.raycastAny(ray), found);
+            if (found) {
+                EXPECT_FLOAT_EQ(hit.distance, expected.distance);
+            }
+        }
+    }
+}
+
+TEST(DynamicAABBTreeTest, PairsMatchBruteForce) {
+    MovingScene scene(500, 9);
+    scene.Step(1.0f);
+
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for (size_t i = 0; i < scene.proxies.size(); i++) {
+        for (size_t j = 0; j < scene.proxies.size(); j++) {
+            uint32_t a = scene.proxies[i];
+            uint32_t b = scene.proxies[j];
+            if (a < b && aabbIntersectsAABB(scene.tree.getFatBounds(a), scene.tree.getFatBounds(b))) {
+                expected.emplace_back(a, b);
+            }
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    scene.tree.queryPairs(pairs);
+    std::sort(pairs.begin(), pairs.end());
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST(DynamicAABBTreeTest, RaycastTiesGoToLowerProxy) {
+    // Boxes of random depths and heights sharing the face x = 5, so a ray down +x hits all at once.
+    // Several random scenes give several tree shapes and visiting orders.
+    std::mt19937 rng(14);
+    std::uniform_real_distribution<float> depth(0.5f, 8.0f);
+    std::uniform_real_distribution<float> height(0.1f, 6.0f);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    for (int scene = 0; scene < 20; scene++) {
+        DynamicAABBTree tree;
+        std::vector<uint32_t> tied;
+        for (int i = 0; i < 64; i++) {
+            float h = height(rng);
+            tied.push_back(tree.createProxy(AABB(Vec3(5, -h, -h), Vec3(5 + depth(rng), h, h))));
+            Vec3 center(40.0f + position(rng), position(rng), position(rng));
+            tree.createProxy(AABB::fromCenterAndExtents(center, Vec3(1, 1, 1)));
+        }
+
+        RayHit hit;
+        ASSERT_TRUE(tree.raycast(Ray(Vec3(0, 0, 0), Vec3(1, 0, 0)), hit));
+        EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+        EXPECT_EQ(hit.index, *std::min_element(tied.begin(), tied.end()));
+    }
+}
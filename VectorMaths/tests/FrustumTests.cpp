@@ -0,0 +1,153 @@
+/**
+ * @file FrustumTests.cpp
+ * @brief Unit tests for Frustum plane extraction, classification and batch culling
+ */
+
+#include <gtest/gtest.h>
+#include "Frustum.hpp"
+#include "PrimitiveArrays.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Helper: camera at (0, 5, 20) looking at the origin
+static Frustum CameraFrustum() {
+    Mat4 view = Mat4().lookAt(Vec3(0, 5, 20), Vec3(0, 0, 0), Vec3(0, 1, 0));
+    Mat4 projection = Mat4().perspective(1.2f, 1.6f, 0.5f, 60.0f);
+    return Frustum(projection * view);
+}
+
+static bool MaskBit(const std::vector<uint32_t>& mask, size_t i) {
+    return ((mask[i / 32] >> (i % 32)) & 1u) != 0;
+}
+
+TEST(FrustumTest, ExtractsPlanesFromViewProjection) {
+    // 90 degree field of view looking down -z from the origin
+    Frustum frustum(Mat4().perspective(static_cast<float>(M_PI) / 2.0f, 1.0f, 1.0f, 100.0f));
+    float s = 1.0f / std::sqrt(2.0f);
+    EXPECT_EQ(frustum.planes[Frustum::Left], Vec4(s, 0, -s, 0));
+    EXPECT_EQ(frustum.planes[Frustum::Right], Vec4(-s, 0, -s, 0));
+    EXPECT_EQ(frustum.planes[Frustum::Bottom], Vec4(0, s, -s, 0));
+    EXPECT_EQ(frustum.planes[Frustum::Top], Vec4(0, -s, -s, 0));
+    EXPECT_EQ(frustum.planes[Frustum::Near], Vec4(0, 0, -1, -1));
+    EXPECT_EQ(frustum.planes[Frustum::Far], Vec4(0, 0, 1, frustum.planes[Frustum::Far].w));
+    EXPECT_NEAR(frustum.planes[Frustum::Far].w, 100.0f, 1e-3f);
+
+    EXPECT_TRUE(frustum.contains(Vec3(0, 0, -50)));
+    EXPECT_TRUE(frustum.contains(Vec3(40, -40, -50)));
+    EXPECT_FALSE(frustum.contains(Vec3(60, 0, -50)));
+    EXPECT_FALSE(frustum.contains(Vec3(0, 0, -0.5f)));
+    EXPECT_FALSE(frustum.contains(Vec3(0, 0, -150)));
+
+    // Orthographic frustums are boxes, and a view matrix moves them
+    Mat4 view = Mat4().lookAt(Vec3(10, 0, 0), Vec3(10, 0, -1), Vec3(0, 1, 0));
+    Frustum box(Mat4().ortho(-2, 2, -1, 1, 0, 10) * view);
+    EXPECT_TRUE(box.contains(Vec3(11.5f, 0.5f, -5)));
+    EXPECT_FALSE(box.contains(Vec3(12.5f, 0, -5)));
+    EXPECT_FALSE(box.contains(Vec3(11, 0, -11)));
+
+    // The default frustum contains everything
+    EXPECT_EQ(Frustum().classify(AABB(Vec3(-1e6f, -1e6f, -1e6f), Vec3(1e6f, 1e6f, 1e6f))), Frustum::Inside);
+}
+
+TEST(FrustumTest, ClassifyAgreesWithIntersects) {
+    Frustum frustum = CameraFrustum();
+    std::mt19937 rng(61);
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> size(0.1f, 6.0f);
+    int counts[3] = { 0, 0, 0 };
+
+    for (int i = 0; i < 2000; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        AABB box = AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng)));
+        Frustum::Classification result = frustum.classify(box);
+        counts[result]++;
+        EXPECT_EQ(result != Frustum::Outside, frustum.intersects(box));
+        if (result == Frustum::Inside) {
+            for (int corner = 0; corner < 8; corner++) {
+                EXPECT_TRUE(frustum.contains(Vec3(corner & 1 ? box.max.x : box.min.x,
+                    corner & 2 ? box.max.y : box.min.y, corner & 4 ? box.max.z : box.min.z)));
+            }
+        }
+
+        Sphere sphere(center, size(rng));
+        result = frustum.classify(sphere);
+        EXPECT_EQ(result != Frustum::Outside, frustum.intersects(sphere));
+        if (result == Frustum::Inside) {
+            EXPECT_TRUE(frustum.contains(center + Vec3(sphere.radius, 0, 0)));
+            EXPECT_TRUE(frustum.contains(center - Vec3(0, 0, sphere.radius)));
+        }
+    }
+
+    // The random scene covers all three outcomes
+    EXPECT_GT(counts[Frustum::Outside], 0);
+    EXPECT_GT(counts[Frustum::Intersecting], 0);
+    EXPECT_GT(counts[Frustum::Inside], 0);
+}
+
+TEST(FrustumTest, PlaneMasksSkipPlanesParentsAreInside) {
+    Frustum frustum = CameraFrustum();
+    std::mt19937 rng(62);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int i = 0; i < 500; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        AABB parent = AABB::fromCenterAndExtents(center, Vec3(8, 8, 8));
+        uint32_t planeMask = Frustum::AllPlanes;
+        Frustum::Classification parentResult = frustum.classify(parent, planeMask);
+        if (parentResult == Frustum::Outside) {
+            continue;
+        }
+        EXPECT_EQ(parentResult == Frustum::Inside, planeMask == 0u);
+
+        // A box inside the parent gets the same answer from the reduced mask as from every plane
+        Vec3 low(parent.min.x + 12 * unit(rng), parent.min.y + 12 * unit(rng), parent.min.z + 12 * unit(rng));
+        AABB child(low, low + Vec3(4, 4, 4));
+        uint32_t childMask = planeMask;
+        Frustum::Classification childResult = frustum.classify(child, childMask);
+        EXPECT_EQ(childResult != Frustum::Outside, frustum.intersects(child));
+        if (childResult != Frustum::Outside) {
+            EXPECT_EQ(childMask & ~planeMask, 0u);
+        }
+    }
+}
+
+TEST(FrustumTest, BatchMasksMatchScalarTests) {
+    Frustum frustum = CameraFrustum();
+    std::mt19937 rng(63);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+    std::vector<AABB> boxes;
+    std::vector<Sphere> spheres;
+    for (int i = 0; i < 1001; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        boxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng))));
+        spheres.emplace_back(center, size(rng));
+    }
+    AABBArray boxArray(boxes.data(), boxes.size());
+    SphereArray sphereArray(spheres.data(), spheres.size());
+
+    std::vector<uint32_t> boxMask;
+    std::vector<uint32_t> sphereMask;
+    size_t visibleBoxes = boxArray.frustumMask(frustum, boxMask);
+    size_t visibleSpheres = sphereArray.frustumMask(frustum, sphereMask);
+    ASSERT_EQ(boxMask.size(), (boxes.size() + 31) / 32);
+
+    size_t expectedBoxes = 0;
+    size_t expectedSpheres = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        EXPECT_EQ(MaskBit(boxMask, i), frustum.intersects(boxes[i]));
+        EXPECT_EQ(MaskBit(sphereMask, i), frustum.intersects(spheres[i]));
+        expectedBoxes += frustum.intersects(boxes[i]) ? 1 : 0;
+        expectedSpheres += frustum.intersects(spheres[i]) ? 1 : 0;
+    }
+    EXPECT_EQ(visibleBoxes, expectedBoxes);
+    EXPECT_EQ(visibleSpheres, expectedSpheres);
+    EXPECT_GT(visibleBoxes, 0u);
+    EXPECT_LT(visibleBoxes, boxes.size());
+}
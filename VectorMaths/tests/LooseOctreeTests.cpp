@@ -0,0 +1,255 @@
+/**
+ * @file LooseOctreeTests.cpp
+ * @brief Unit tests for LooseOctree, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "LooseOctree.hpp"
+#include "TestScenes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Helper: reference shapes mirrored in an octree
+struct OctreeScene {
+    LooseOctree octree;
+    std::vector<uint32_t> ids;
+    std::vector<AABB> boxes;
+    std::vector<Sphere> spheres;
+    std::vector<bool> isSphere;
+
+    OctreeScene() : octree(AABB(Vec3(-100, -100, -100), Vec3(100, 100, 100)), 8) {}
+
+    void Add(const AABB& box) {
+        ids.push_back(octree.insert(box));
+        boxes.push_back(box);
+        spheres.push_back(Sphere());
+        isSphere.push_back(false);
+    }
+
+    void Add(const Sphere& sphere) {
+        ids.push_back(octree.insert(sphere));
+        boxes.push_back(AABB());
+        spheres.push_back(sphere);
+        isSphere.push_back(true);
+    }
+};
+
+// Plane-side tests matching the octree's conservative frustum test
+static bool BoxInside(const AABB& box, const Vec4 planes[6]) {
+    for (int i = 0; i < 6; i++) {
+        const Vec4& p = planes[i];
+        float x = p.x >= 0.0f ? box.max.x : box.min.x;
+        float y = p.y >= 0.0f ? box.max.y : box.min.y;
+        float z = p.z >= 0.0f ? box.max.z : box.min.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SphereInside(const Sphere& sphere, const Vec4 planes[6]) {
+    for (int i = 0; i < 6; i++) {
+        const Vec4& p = planes[i];
+        if (p.x * sphere.center.x + p.y * sphere.center.y + p.z * sphere.center.z + p.w < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static OctreeScene RandomScene(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> cluster(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> wide(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> size(0.05f, 2.0f);
+    std::uniform_real_distribution<float> large(20.0f, 150.0f);
+
+    OctreeScene scene;
+    for (int i = 0; i < 1500; i++) {
+        // A dense cluster, a sparse spread (partly outside the world) and a few huge objects
+        Vec3 center = i % 3 == 0
+            ? Vec3(wide(rng), wide(rng), wide(rng))
+            : Vec3(60.0f + cluster(rng), cluster(rng), -40.0f + cluster(rng));
+        float extent = i % 100 == 0 ? large(rng) : size(rng);
+        if (i % 2 == 0) {
+            scene.Add(Sphere(center, extent));
+        }
+        else {
+            scene.Add(AABB::fromCenterAndExtents(center, Vec3(extent, size(rng), extent)));
+        }
+    }
+    return scene;
+}
+
+TEST(LooseOctreeTest, DepthFollowsObjectSize) {
+    LooseOctree octree(AABB(Vec3(0, 0, 0), Vec3(64, 64, 64)), 6);
+    EXPECT_EQ(octree.getObjectDepth(octree.insert(Sphere(Vec3(10, 10, 10), 0.1f))), 6u);
+    EXPECT_EQ(octree.getObjectDepth(octree.insert(AABB(Vec3(1, 1, 1), Vec3(5, 2, 2)))), 4u);
+    EXPECT_EQ(octree.getObjectDepth(octree.insert(AABB(Vec3(0, 0, 0), Vec3(40, 1, 1)))), 0u);
+
+    // Objects outside the world stay at the root
+    uint32_t outside = octree.insert(Sphere(Vec3(500, 0, 0), 0.1f));
+    EXPECT_EQ(octree.getObjectDepth(outside), 0u);
+    EXPECT_EQ(octree.size(), 4u);
+
+    // Nodes are only created along occupied paths, and freed again
+    EXPECT_LE(octree.getNodeCount(), 1u + 6u + 4u);
+    octree.update(outside, Sphere(Vec3(30, 30, 30), 0.2f));
+    EXPECT_EQ(octree.getObjectDepth(outside), 6u);
+    octree.clear();
+    EXPECT_EQ(octree.size(), 0u);
+    EXPECT_EQ(octree.getNodeCount(), 1u);
+}
+
+TEST(LooseOctreeTest, QueriesMatchBruteForce) {
+    OctreeScene scene = RandomScene(31);
+    std::mt19937 rng(32);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<uint32_t> results;
+
+    for (int q = 0; q < 30; q++) {
+        AABB box = AABB::fromCenterAndExtents(Vec3(position(rng), position(rng), position(rng)), Vec3(15, 10, 20));
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < scene.ids.size(); i++) {
+            bool overlaps = scene.isSphere[i]
+                ? sphereIntersectsAABB(scene.spheres[i], box)
+                : aabbIntersectsAABB(scene.boxes[i], box);
+            if (overlaps) {
+                expected.push_back(scene.ids[i]);
+            }
+        }
+        scene.octree.queryOverlaps(box, results);
+        EXPECT_EQ(Sorted(results), Sorted(expected));
+    }
+
+    for (int q = 0; q < 100; q++) {
+        Ray ray(Vec3(position(rng), position(rng), position(rng)), Vec3(direction(rng), direction(rng), direction(rng)));
+        RayHit expected;
+        bool expectedFound = ClosestHit(scene.ids.size(), std::numeric_limits<float>::infinity(),
+            [&](uint32_t i, float& distance) {
+                return scene.isSphere[i]
+                    ? rayIntersectsSphere(ray, scene.spheres[i], distance)
+                    : rayIntersectsAABB(ray, scene.boxes[i], distance);
+            }, expected);
+
+        RayHit hit;
+        bool found = scene.octree.raycast(ray, hit);
+        ASSERT_EQ(found, expectedFound);
+        if (found) {
+            EXPECT_FLOAT_EQ(hit.distance, expected.distance);
+        }
+    }
+}
+
+TEST(LooseOctreeTest, FrustumQueryMatchesBruteForce) {
+    OctreeScene scene = RandomScene(33);
+
+    // A wedge looking down +x: tilted side planes, near and far planes
+    float s = 1.0f / std::sqrt(2.0f);
+    Vec4 planes[6] = {
+        Vec4(s, s, 0, 0),      // y >= -x
+        Vec4(s, -s, 0, 0),     // y <= x
+        Vec4(s, 0, s, 0),      // z >= -x
+        Vec4(s, 0, -s, 0),     // z <= x
+        Vec4(1, 0, 0, -1),     // x >= 1
+        Vec4(-1, 0, 0, 90),    // x <= 90
+    };
+
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < scene.ids.size(); i++) {
+        bool inside = scene.isSphere[i] ? SphereInside(scene.spheres[i], planes) : BoxInside(scene.boxes[i], planes);
+        if (inside) {
+            expected.push_back(scene.ids[i]);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    std::vector<uint32_t> results;
+    scene.octree.queryFrustum(planes, results);
+    EXPECT_EQ(Sorted(results), Sorted(expected));
+
+    // A camera frustum: plane masks passed down the tree must not change the result
+    Mat4 view = Mat4().lookAt(Vec3(-20, 10, 30), Vec3(60, 0, -40), Vec3(0, 1, 0));
+    Frustum frustum(Mat4().perspective(0.8f, 1.5f, 1.0f, 150.0f) * view);
+    expected.clear();
+    for (size_t i = 0; i < scene.ids.size(); i++) {
+        bool visible = scene.isSphere[i] ? frustum.intersects(scene.spheres[i]) : frustum.intersects(scene.boxes[i]);
+        if (visible) {
+            expected.push_back(scene.ids[i]);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    scene.octree.queryFrustum(frustum, results);
+    EXPECT_EQ(Sorted(results), Sorted(expected));
+}
+
+TEST(LooseOctreeTest, RemoveAndUpdateKeepQueriesConsistent) {
+    OctreeScene scene = RandomScene(34);
+    std::mt19937 rng(35);
+    std::uniform_real_distribution<float> position(-90.0f, 90.0f);
+
+    // Move some objects, remove others
+    std::vector<uint32_t> live;
+    for (size_t i = 0; i < scene.ids.size(); i++) {
+        if (i % 4 == 0) {
+            scene.octree.remove(scene.ids[i]);
+            continue;
+        }
+        if (i % 4 == 1) {
+            AABB box = AABB::fromCenterAndExtents(Vec3(position(rng), position(rng), position(rng)), Vec3(0.5f, 0.5f, 0.5f));
+            scene.octree.update(scene.ids[i], box);
+            scene.boxes[i] = box;
+            scene.isSphere[i] = false;
+        }
+        live.push_back(static_cast<uint32_t>(i));
+    }
+    EXPECT_EQ(scene.octree.size(), live.size());
+
+    AABB everything(Vec3(-1000, -1000, -1000), Vec3(1000, 1000, 1000));
+    std::vector<uint32_t> expected;
+    for (uint32_t i : live) {
+        expected.push_back(scene.ids[i]);
+        EXPECT_TRUE(scene.octree.getBounds(scene.ids[i]).contains(scene.isSphere[i]
+            ? AABB::fromCenterAndExtents(scene.spheres[i].center, Vec3(1, 1, 1) * scene.spheres[i].radius)
+            : scene.boxes[i]));
+    }
+    std::vector<uint32_t> results;
+    scene.octree.queryOverlaps(everything, results);
+    EXPECT_EQ(Sorted(results), Sorted(expected));
+
+    // Removing everything returns every node but the root to the pool
+    for (uint32_t i : live) {
+        scene.octree.remove(scene.ids[i]);
+    }
+    EXPECT_EQ(scene.octree.size(), 0u);
+    EXPECT_EQ(scene.octree.getNodeCount(), 1u);
+}
+
+TEST(LooseOctreeTest, RaycastTiesGoToLowerObject) {
+    // Boxes of very different sizes (so different depths) sharing the face x = 5
+    OctreeScene scene;
+    for (int i = 0; i < 64; i++) {
+        float depth = 0.05f + static_cast<float>(i % 9) * 3.0f;
+        float height = 0.05f + 0.5f * static_cast<float>(i % 13);
+        scene.Add(AABB(Vec3(5, -height, -height), Vec3(5 + depth, height, height)));
+    }
+
+    // Reused ids no longer follow insertion order
+    for (int i = 0; i < 8; i++) {
+        scene.octree.remove(scene.ids[i]);
+    }
+    std::vector<uint32_t> tied(scene.ids.begin() + 8, scene.ids.end());
+    for (int i = 0; i < 8; i++) {
+        tied.push_back(scene.octree.insert(AABB(Vec3(5, -40, -40), Vec3(90, 40, 40))));
+    }
+
+    RayHit hit;
+    ASSERT_TRUE(scene.octree.raycast(Ray(Vec3(0, 0, 0), Vec3(1, 0, 0)), hit));
+    EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+    EXPECT_EQ(hit.index, *std::min_element(tied.begin(), tied.end()));
+}
@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include "Matrix.hpp"
+#include "Quaternion.hpp"
 #include <cmath>
 
 
@@ -310,6 +311,21 @@ TEST(Mat4Test, DeterminantAndInverse) {
     }
 }
 
+TEST(Mat4Test, AffineInverse) {
+    Mat4 scale;
+    scale = scale.scale(Vec3(2, 3, 0.5f));
+    Mat4 affine = Quaternion::fromAxisAngle(Vec3(1, 2, 3), 0.8f).toRotationMatrix() * scale;
+    affine = affine.translation(Vec3(4, -5, 6));
+
+    EXPECT_EQ(affine.affineInverse() * affine, Mat4());
+    EXPECT_EQ(affine * affine.affineInverse(), Mat4());
+
+    // Singular input falls back to identity, like inverse()
+    Mat4 flat;
+    flat = flat.scale(Vec3(1, 0, 1));
+    EXPECT_EQ(flat.affineInverse(), Mat4());
+}
+
 TEST(Mat4Test, VectorMultiplication) {
     Mat4 m; // Identity
     Vec4 v(1, 2, 3, 4);
@@ -0,0 +1,222 @@
+/**
+ * @file PrimitiveArraysTests.cpp
+ * @brief Unit tests for the structure-of-arrays primitive sets, checked against the scalar functions
+ */
+
+#include <gtest/gtest.h>
+#include "PrimitiveArrays.hpp"
+#include "TestScenes.hpp"
+#include <limits>
+#include <random>
+#include <vector>
+
+// Helper: the hit bits the arrays' mask queries should report
+template<typename Test>
+static std::vector<uint32_t> HitBits(size_t count, float maxDistance, const Test& test) {
+    std::vector<uint32_t> bits((count + 31) / 32, 0u);
+    for (uint32_t i = 0; i < count; i++) {
+        float distance;
+        if (test(i, distance) && distance <= maxDistance) {
+            bits[i / 32] |= 1u << (i % 32);
+        }
+    }
+    return bits;
+}
+
+static size_t CountBits(const std::vector<uint32_t>& bits) {
+    size_t total = 0;
+    for (uint32_t word : bits) {
+        for (; word != 0; word &= word - 1) {
+            total++;
+        }
+    }
+    return total;
+}
+
+TEST(PrimitiveArraysTest, StorageRoundTrips) {
+    SphereArray spheres;
+    for (int i = 0; i < 7; i++) {
+        spheres.add(Sphere(Vec3(static_cast<float>(i), 1, 2), 0.5f + i));
+    }
+    EXPECT_EQ(spheres.size(), 7u);
+    spheres.set(3, Sphere(Vec3(-1, -2, -3), 9.0f));
+    EXPECT_EQ(spheres.get(3).center, Vec3(-1, -2, -3));
+    EXPECT_EQ(spheres.get(3).radius, 9.0f);
+    EXPECT_EQ(spheres.get(6).center, Vec3(6, 1, 2));
+
+    AABB boxes[2] = { AABB(Vec3(0, 0, 0), Vec3(1, 1, 1)), AABB(Vec3(-3, -2, -1), Vec3(4, 5, 6)) };
+    AABBArray boxArray(boxes, 2);
+    EXPECT_EQ(boxArray.get(1).min, boxes[1].min);
+    EXPECT_EQ(boxArray.get(1).max, boxes[1].max);
+
+    PlaneArray planes;
+    planes.add(Vec3(0, 1, 0), Vec3(2, 3, 4));
+    EXPECT_EQ(planes.getNormal(0), Vec3(0, 1, 0));
+    EXPECT_EQ(planes.getPoint(0), Vec3(2, 3, 4));
+
+    // Empty arrays never hit
+    RayHit hit;
+    std::vector<uint32_t> mask;
+    spheres.clear();
+    EXPECT_EQ(spheres.size(), 0u);
+    EXPECT_FALSE(spheres.raycast(Ray(), hit));
+    EXPECT_EQ(spheres.raycastMask(Ray(), mask), 0u);
+    EXPECT_TRUE(mask.empty());
+}
+
+TEST(PrimitiveArraysTest, SpheresMatchScalarTest) {
+    std::vector<Sphere> spheres = RandomSpheres(301, 20.0f, 51, 0.2f, 4.0f);
+    spheres.push_back(spheres[10]);  // Duplicate: the tie goes to index 10
+    SphereArray array(spheres.data(), spheres.size());
+
+    for (float maxDistance : { std::numeric_limits<float>::infinity(), 12.0f }) {
+        for (const Ray& ray : RandomRays(300, 20.0f, 52)) {
+            auto test = [&](uint32_t i, float& distance) {
+                return rayIntersectsSphere(ray, spheres[i], distance);
+            };
+            RayHit expected;
+            bool found = ClosestHit(spheres.size(), maxDistance, test, expected);
+            std::vector<uint32_t> expectedBits = HitBits(spheres.size(), maxDistance, test);
+
+            RayHit hit;
+            ASSERT_EQ(array.raycast(ray, hit, maxDistance), found);
+            if (found) {
+                EXPECT_EQ(hit.index, expected.index);
+                EXPECT_EQ(hit.distance, expected.distance);
+            }
+            std::vector<uint32_t> bits;
+            EXPECT_EQ(array.raycastMask(ray, bits, maxDistance), CountBits(expectedBits));
+            EXPECT_EQ(bits, expectedBits);
+        }
+    }
+}
+
+TEST(PrimitiveArraysTest, BoxesMatchScalarTest) {
+    std::vector<AABB> boxes = RandomBoxes(298, 20.0f, 53);
+    std::vector<Ray> rays = RandomRays(300, 20.0f, 54);
+
+    // A box whose face contains an axis-aligned ray's origin
+    boxes.push_back(AABB(rays[3].origin, rays[3].origin + Vec3(1, 1, 1)));
+    AABBArray array(boxes.data(), boxes.size());
+
+    for (float maxDistance : { std::numeric_limits<float>::infinity(), 12.0f }) {
+        for (const Ray& ray : rays) {
+            auto test = [&](uint32_t i, float& distance) {
+                return rayIntersectsAABB(ray, boxes[i], distance);
+            };
+            RayHit expected;
+            bool found = ClosestHit(boxes.size(), maxDistance, test, expected);
+            std::vector<uint32_t> expectedBits = HitBits(boxes.size(), maxDistance, test);
+
+            RayHit hit;
+            ASSERT_EQ(array.raycast(ray, hit, maxDistance), found);
+            if (found) {
+                EXPECT_EQ(hit.index, expected.index);
+                EXPECT_EQ(hit.distance, expected.distance);
+            }
+            std::vector<uint32_t> bits;
+            EXPECT_EQ(array.raycastMask(ray, bits, maxDistance), CountBits(expectedBits));
+            EXPECT_EQ(bits, expectedBits);
+        }
+    }
+}
+
+TEST(PrimitiveArraysTest, PlanesMatchScalarTest) {
+    std::mt19937 rng(55);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<Vec3> normals;
+    std::vector<Vec3> points;
+    PlaneArray array;
+    for (int i = 0; i < 61; i++) {
+        // Every tenth plane is axis-aligned, so axis-aligned rays run parallel to some
+        Vec3 normal = i % 10 == 0 ? Vec3(0, 1, 0) : Vec3(direction(rng), direction(rng), direction(rng)).normalised();
+        Vec3 point(position(rng), position(rng), position(rng));
+        normals.push_back(normal);
+        points.push_back(point);
+        array.add(normal, point);
+    }
+
+    for (const Ray& ray : RandomRays(300, 20.0f, 56)) {
+        auto test = [&](uint32_t i, float& distance) {
+            return rayIntersectsPlane(ray, normals[i], points[i], distance);
+        };
+        RayHit expected;
+        bool found = ClosestHit(normals.size(), 30.0f, test, expected);
+        std::vector<uint32_t> expectedBits = HitBits(normals.size(), 30.0f, test);
+
+        RayHit hit;
+        ASSERT_EQ(array.raycast(ray, hit, 30.0f), found);
+        if (found) {
+            EXPECT_EQ(hit.index, expected.index);
+            EXPECT_EQ(hit.distance, expected.distance);
+        }
+        std::vector<uint32_t> bits;
+        EXPECT_EQ(array.raycastMask(ray, bits, 30.0f), CountBits(expectedBits));
+        EXPECT_EQ(bits, expectedBits);
+    }
+}
+
+TEST(PrimitiveArraysTest, OverlapQueriesMatchScalarTests) {
+    std::mt19937 rng(57);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.2f, 3.0f);
+    std::vector<AABB> boxes;
+    for (int i = 0; i < 1003; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        boxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng))));
+    }
+    AABBArray array(boxes.data(), boxes.size());
+
+    // Queries touching a box exactly still count as overlapping
+    std::vector<AABB> queryBoxes = { AABB(boxes[5].max, boxes[5].max + Vec3(1, 1, 1)) };
+    std::vector<Sphere> querySpheres = { Sphere(boxes[6].max + Vec3(0, 0, 2), 2.0f) };
+    std::vector<Vec3> queryPoints = { boxes[7].min };
+    for (int q = 0; q < 50; q++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        queryBoxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), 4.0f, size(rng))));
+        querySpheres.emplace_back(center, size(rng) * 2.0f);
+        queryPoints.push_back(center);
+    }
+
+    std::vector<uint32_t> mask;
+    std::vector<uint32_t> results;
+    auto check = [&](size_t count, const std::vector<uint32_t>& expected) {
+        std::vector<uint32_t> expectedMask((boxes.size() + 31) / 32, 0u);
+        for (uint32_t i : expected) {
+            expectedMask[i / 32] |= 1u << (i % 32);
+        }
+        EXPECT_EQ(count, expected.size());
+        EXPECT_EQ(mask, expectedMask);
+        EXPECT_EQ(results, expected);
+    };
+
+    for (size_t q = 0; q < queryBoxes.size(); q++) {
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            if (aabbIntersectsAABB(boxes[i], queryBoxes[q])) {
+                expected.push_back(i);
+            }
+        }
+        array.queryOverlaps(queryBoxes[q], results);
+        check(array.overlapMask(queryBoxes[q], mask), expected);
+
+        expected.clear();
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            if (sphereIntersectsAABB(querySpheres[q], boxes[i])) {
+                expected.push_back(i);
+            }
+        }
+        array.queryOverlaps(querySpheres[q], results);
+        check(array.overlapMask(querySpheres[q], mask), expected);
+
+        expected.clear();
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            if (pointInAABB(queryPoints[q], boxes[i])) {
+                expected.push_back(i);
+            }
+        }
+        array.queryContaining(queryPoints[q], results);
+        check(array.containingMask(queryPoints[q], mask), expected);
+    }
+}
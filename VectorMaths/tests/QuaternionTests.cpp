@@ -122,3 +122,47 @@ TEST(QuaternionTest, Slerp) {
     AxisAngle aa = mid.toAxisAngle();
     EXPECT_NEAR(aa.angle, M_PI / 2, 1e-5f);
 }
+
+TEST(QuaternionTest, Nlerp) {
+    Quaternion q1 = Quaternion::fromAxisAngle(Vec3(0, 1, 0), 0.0f);
+    Quaternion q2 = Quaternion::fromAxisAngle(Vec3(0, 1, 0), M_PI / 2);
+
+    // Symmetric midpoint matches slerp
+    Quaternion mid = Quaternion::nlerp(q1, q2, 0.5f);
+    EXPECT_NEAR(mid.length(), 1.0f, 1e-6f);
+    EXPECT_NEAR(mid.toAxisAngle().angle, M_PI / 4, 1e-5f);
+
+    // Takes the shortest path when the inputs are in opposite hemispheres
+    Quaternion flipped = Quaternion::nlerp(q1, -q2, 0.5f);
+    EXPECT_NEAR(std::abs(flipped.w), std::abs(mid.w), 1e-6f);
+    EXPECT_NEAR(std::abs(flipped.y), std::abs(mid.y), 1e-6f);
+    EXPECT_GT(flipped.w * q1.w, 0.0f);
+}
+
+TEST(QuaternionTest, RotationMatrixRoundTrip) {
+    // One rotation per branch of fromRotationMatrix (positive trace, then x, y, z dominant)
+    Quaternion rotations[] = {
+        Quaternion::fromAxisAngle(Vec3(1, 1, 0), 0.7f),
+        Quaternion::fromAxisAngle(Vec3(1, 0.1f, 0.2f), 3.0f),
+        Quaternion::fromAxisAngle(Vec3(0.1f, 1, 0.2f), 3.0f),
+        Quaternion::fromAxisAngle(Vec3(0.2f, 0.1f, 1), 3.0f),
+    };
+
+    for (const Quaternion& q : rotations) {
+        Mat4 m = q.toRotationMatrix();
+        float values[9] = { m.m[0], m.m[1], m.m[2], m.m[4], m.m[5], m.m[6], m.m[8], m.m[9], m.m[10] };
+        Quaternion back = Quaternion::fromRotationMatrix(Mat3(values));
+
+        // q and -q are the same rotation
+        float sign = (back.w * q.w + back.x * q.x + back.y * q.y + back.z * q.z) < 0 ? -1.0f : 1.0f;
+        EXPECT_NEAR(back.w * sign, q.w, 1e-5f);
+        EXPECT_NEAR(back.x * sign, q.x, 1e-5f);
+        EXPECT_NEAR(back.y * sign, q.y, 1e-5f);
+        EXPECT_NEAR(back.z * sign, q.z, 1e-5f);
+
+        // The matrix agrees with rotateVector
+        Vec3 v(0.3f, -0.5f, 0.8f);
+        Vec4 rotated = m * Vec4(v.x, v.y, v.z, 0.0f);
+        EXPECT_EQ(Vec3(rotated.x, rotated.y, rotated.z), q.rotateVector(v));
+    }
+}
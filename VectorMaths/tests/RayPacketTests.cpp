@@ -0,0 +1,128 @@
+/**
+ * @file RayPacketTests.cpp
+ * @brief Unit tests for ray packets, checked lane by lane against the single-ray functions
+ */
+
+#include <gtest/gtest.h>
+#include "RayPacket.hpp"
+#include "BVH.hpp"
+#include "TestScenes.hpp"
+#include <limits>
+#include <vector>
+
+TEST(RayPacketTest, LanesStoreRaysExactly) {
+    Ray rays[3] = {
+        Ray(Vec3(1, 2, 3), Vec3(1, 1, 0)),
+        Ray(Vec3(-1, 0, 0), Vec3(0, 0, -1)),
+        Ray(Vec3(0, 5, 0), Vec3(0.3f, -0.2f, 0.9f)),
+    };
+    RayPacket packet(rays, 3);
+    EXPECT_EQ(packet.activeMask, 0x7u);
+    for (uint32_t lane = 0; lane < 3; lane++) {
+        Ray stored = packet.getRay(lane);
+        EXPECT_EQ(stored.origin, rays[lane].origin);
+        EXPECT_EQ(stored.getDirection(), rays[lane].getDirection());
+    }
+
+    // Inactive lanes never hit, even a box around everything
+    float distances[RayPacket::Width];
+    AABB everything(Vec3(-100, -100, -100), Vec3(100, 100, 100));
+    EXPECT_EQ(rayPacketIntersectsAABB(packet, everything, distances), 0x7u);
+    EXPECT_EQ(rayPacketIntersectsAABB(RayPacket(), everything, distances), 0u);
+}
+
+TEST(RayPacketTest, SlabTestMatchesSingleRay) {
+    std::vector<Ray> rays = RandomRays(400, 10.0f, 41);
+    std::vector<AABB> boxes = RandomBoxes(200, 10.0f, 42);
+
+    // Boxes whose faces pass through ray origins exercise the 0 / 0 lanes
+    boxes.push_back(AABB(rays[3].origin, rays[3].origin + Vec3(1, 1, 1)));
+    boxes.push_back(AABB(rays[7].origin - Vec3(1, 1, 1), rays[7].origin));
+
+    for (size_t r = 0; r < rays.size(); r += RayPacket::Width) {
+        RayPacket packet(&rays[r], RayPacket::Width);
+        for (const AABB& box : boxes) {
+            float distances[RayPacket::Width];
+            uint32_t mask = rayPacketIntersectsAABB(packet, box, distances);
+            for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+                float distance;
+                bool hit = rayIntersectsAABB(rays[r + lane], box, distance);
+                ASSERT_EQ(((mask >> lane) & 1u) != 0, hit);
+                if (hit) {
+                    EXPECT_EQ(distances[lane], distance);
+                }
+            }
+        }
+    }
+}
+
+TEST(RayPacketTest, ArrayQueriesMatchBruteForce) {
+    std::vector<Ray> rays = RandomRays(200, 20.0f, 43);
+    std::vector<AABB> boxes = RandomBoxes(300, 20.0f, 44);
+    std::vector<Sphere> spheres = RandomSpheres(300, 20.0f, 45);
+    const float maxDistance = 15.0f;
+
+    for (size_t r = 0; r < rays.size(); r += RayPacket::Width) {
+        RayPacket packet(&rays[r], RayPacket::Width);
+        RayHit boxHits[RayPacket::Width];
+        RayHit sphereHits[RayPacket::Width];
+        uint32_t boxMask = raycastPacket(packet, boxes.data(), boxes.size(), boxHits, maxDistance);
+        uint32_t sphereMask = raycastPacket(packet, spheres.data(), spheres.size(), sphereHits, maxDistance);
+
+        for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+            RayHit expected;
+            bool hit = ClosestHit(rays[r + lane], boxes, rayIntersectsAABB, expected, maxDistance);
+            ASSERT_EQ(((boxMask >> lane) & 1u) != 0, hit);
+            if (hit) {
+                EXPECT_EQ(boxHits[lane].index, expected.index);
+                EXPECT_EQ(boxHits[lane].distance, expected.distance);
+            }
+
+            hit = ClosestHit(rays[r + lane], spheres, rayIntersectsSphere, expected, maxDistance);
+            ASSERT_EQ(((sphereMask >> lane) & 1u) != 0, hit);
+            if (hit) {
+                EXPECT_EQ(sphereHits[lane].index, expected.index);
+                EXPECT_EQ(sphereHits[lane].distance, expected.distance);
+            }
+        }
+    }
+}
+
+TEST(RayPacketTest, BVHPacketsMatchSingleRays) {
+    std::vector<Ray> rays = RandomRays(400, 30.0f, 46);
+    std::vector<AABB> boxes = RandomBoxes(2000, 30.0f, 47);
+    std::vector<Sphere> spheres = RandomSpheres(2000, 30.0f, 48);
+
+    BVH boxTree;
+    boxTree.build(boxes.data(), boxes.size());
+    BVH sphereTree;
+    sphereTree.build(spheres.data(), spheres.size());
+
+    for (const BVH* bvh : { &boxTree, &sphereTree }) {
+        for (float maxDistance : { std::numeric_limits<float>::infinity(), 8.0f }) {
+            for (size_t r = 0; r < rays.size(); r += RayPacket::Width) {
+                // Coherent packets: four rays from neighbouring slots of the list
+                RayPacket packet(&rays[r], RayPacket::Width);
+                RayHit hits[RayPacket::Width];
+                uint32_t mask = bvh->raycast(packet, hits, maxDistance);
+                uint32_t anyMask = bvh->raycastAny(packet, maxDistance);
+
+                for (uint32_t lane = 0; lane < RayPacket::Width; lane++) {
+                    RayHit expected;
+                    bool hit = bvh->raycast(rays[r + lane], expected, maxDistance);
+                    ASSERT_EQ(((mask >> lane) & 1u) != 0, hit);
+                    EXPECT_EQ(((anyMask >> lane) & 1u) != 0, bvh->raycastAny(rays[r + lane], maxDistance));
+                    if (hit) {
+                        EXPECT_EQ(hits[lane].index, expected.index);
+                        EXPECT_EQ(hits[lane].distance, expected.distance);
+                    }
+                }
+            }
+        }
+    }
+
+    // A partial packet only reports its active lanes
+    RayPacket partial(rays.data(), 2);
+    RayHit hits[RayPacket::Width];
+    EXPECT_EQ(boxTree.raycast(partial, hits) & ~0x3u, 0u);
+}
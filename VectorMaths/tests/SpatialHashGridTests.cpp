@@ -0,0 +1,101 @@
+/**
+ * @file SpatialHashGridTests.cpp
+ * @brief Unit tests for SpatialHashGrid, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "SpatialHashGrid.hpp"
+#include "TestScenes.hpp"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+typedef std::pair<uint32_t, uint32_t> IndexPair;
+
+static std::vector<IndexPair> BruteForcePairs(const std::vector<Sphere>& spheres) {
+    std::vector<IndexPair> expected;
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+        for (uint32_t j = i + 1; j < spheres.size(); j++) {
+            if (sphereIntersectsSphere(spheres[i], spheres[j])) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    return expected;
+}
+
+TEST(SpatialHashGridTest, EmptyAndSmallGrids) {
+    SpatialHashGrid grid(2.0f);
+    std::vector<IndexPair> pairs;
+    grid.queryPairs(pairs);
+    EXPECT_TRUE(pairs.empty());
+
+    // Touching spheres across a cell boundary, including negative cells
+    std::vector<Sphere> spheres = {
+        Sphere(Vec3(-0.5f, 0, 0), 0.5f),
+        Sphere(Vec3(0.5f, 0, 0), 0.5f),
+        Sphere(Vec3(5, 5, 5), 0.5f),
+    };
+    grid.build(spheres.data(), spheres.size());
+    EXPECT_EQ(grid.size(), 3u);
+    grid.queryPairs(pairs);
+    EXPECT_EQ(pairs, std::vector<IndexPair>{ IndexPair(0, 1) });
+
+    std::vector<uint32_t> results;
+    grid.queryOverlaps(Sphere(Vec3(5, 4, 5), 0.6f), results);
+    EXPECT_EQ(results, std::vector<uint32_t>{ 2 });
+
+    grid.clear();
+    EXPECT_EQ(grid.size(), 0u);
+    grid.queryOverlaps(Sphere(Vec3(5, 4, 5), 0.6f), results);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(SpatialHashGridTest, PairsMatchBruteForceForAnyCellSize) {
+    std::vector<Sphere> spheres = RandomSpheres(1500, 20.0f, 21, 0.2f, 0.6f);
+    std::vector<IndexPair> expected = BruteForcePairs(spheres);
+    ASSERT_FALSE(expected.empty());
+
+    // Cells smaller than a sphere, about a diameter, and much larger
+    for (float cellSize : { 0.3f, 1.2f, 7.0f }) {
+        SpatialHashGrid grid(cellSize);
+        grid.build(spheres.data(), spheres.size());
+        std::vector<IndexPair> pairs;
+        grid.queryPairs(pairs);
+
+        // No duplicates: the sorted list matches the brute-force list exactly
+        std::sort(pairs.begin(), pairs.end());
+        EXPECT_EQ(pairs, expected) << "cell size " << cellSize;
+    }
+}
+
+TEST(SpatialHashGridTest, RebuildAndSphereQueriesMatchBruteForce) {
+    SpatialHashGrid grid;
+    std::mt19937 rng(22);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+
+    for (unsigned frame = 0; frame < 5; frame++) {
+        std::vector<Sphere> spheres = RandomSpheres(800, 15.0f, 100 + frame, 0.3f, 0.5f);
+        grid.build(spheres.data(), spheres.size());
+
+        std::vector<IndexPair> pairs;
+        grid.queryPairs(pairs);
+        std::sort(pairs.begin(), pairs.end());
+        EXPECT_EQ(pairs, BruteForcePairs(spheres));
+
+        for (int q = 0; q < 20; q++) {
+            Sphere query(Vec3(position(rng), position(rng), position(rng)), 2.5f);
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < spheres.size(); i++) {
+                if (sphereIntersectsSphere(query, spheres[i])) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<uint32_t> results;
+            grid.queryOverlaps(query, results);
+            std::sort(results.begin(), results.end());
+            EXPECT_EQ(results, expected);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/**
+ * @file SweepAndPruneTests.cpp
+ * @brief Unit tests for the SweepAndPrune broadphase, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "SweepAndPrune.hpp"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+typedef SweepAndPrune::Pair Pair;
+
+// Helper: every overlapping pair among the live proxies
+static std::vector<Pair> BruteForcePairs(const SweepAndPrune& sap, const std::vector<uint32_t>& proxies) {
+    std::vector<Pair> expected;
+    for (size_t i = 0; i < proxies.size(); i++) {
+        for (size_t j = i + 1; j < proxies.size(); j++) {
+            if (aabbIntersectsAABB(sap.getBounds(proxies[i]), sap.getBounds(proxies[j]))) {
+                expected.emplace_back(std::min(proxies[i], proxies[j]), std::max(proxies[i], proxies[j]));
+            }
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    return expected;
+}
+
+TEST(SweepAndPruneTest, ReportsAddedAndRemovedPairs) {
+    SweepAndPrune sap;
+    uint32_t a = sap.createProxy(AABB(Vec3(0, 0, 0), Vec3(1, 1, 1)));
+    uint32_t b = sap.createProxy(AABB(Vec3(0.5f, 0.5f, 0.5f), Vec3(2, 2, 2)));
+    uint32_t c = sap.createProxy(AABB(Vec3(5, 0, 0), Vec3(6, 1, 1)));
+    sap.update();
+    ASSERT_EQ(sap.getPairs().size(), 1u);
+    EXPECT_EQ(sap.getPairs()[0], Pair(a, b));
+    EXPECT_EQ(sap.getAddedPairs(), sap.getPairs());
+    EXPECT_TRUE(sap.getRemovedPairs().empty());
+
+    // Nothing moved: no events
+    sap.update();
+    EXPECT_EQ(sap.getPairs().size(), 1u);
+    EXPECT_TRUE(sap.getAddedPairs().empty());
+    EXPECT_TRUE(sap.getRemovedPairs().empty());
+
+    // c moves onto b, a moves away from b
+    sap.moveProxy(c, AABB(Vec3(1.5f, 1.5f, 1.5f), Vec3(3, 3, 3)));
+    sap.moveProxy(a, AABB(Vec3(-5, 0, 0), Vec3(-4, 1, 1)));
+    sap.update();
+    EXPECT_EQ(sap.getAddedPairs(), std::vector<Pair>{ Pair(b, c) });
+    EXPECT_EQ(sap.getRemovedPairs(), std::vector<Pair>{ Pair(a, b) });
+
+    // Destroying a proxy removes its pairs; the id is only reused after the update
+    sap.destroyProxy(b);
+    EXPECT_NE(sap.createProxy(AABB(Vec3(100, 100, 100), Vec3(101, 101, 101))), b);
+    sap.update();
+    EXPECT_EQ(sap.getRemovedPairs(), std::vector<Pair>{ Pair(b, c) });
+    EXPECT_TRUE(sap.getPairs().empty());
+    EXPECT_EQ(sap.size(), 3u);
+    EXPECT_EQ(sap.createProxy(AABB(Vec3(0, 0, 0), Vec3(1, 1, 1))), b);
+
+    sap.clear();
+    sap.update();
+    EXPECT_EQ(sap.size(), 0u);
+    EXPECT_TRUE(sap.getPairs().empty());
+}
+
+TEST(SweepAndPruneTest, ChoosesAxisByVariance) {
+    SweepAndPrune sap;
+    for (int i = 0; i < 100; i++) {
+        float z = static_cast<float>(i) * 4.0f;
+        sap.createProxy(AABB(Vec3(0, 0, z), Vec3(1, 1, z + 1)));
+    }
+    sap.update();
+    EXPECT_EQ(sap.getAxis(), 2);
+    EXPECT_TRUE(sap.getPairs().empty());
+
+    sap.setAxis(1);
+    sap.update();
+    EXPECT_EQ(sap.getAxis(), 1);
+    EXPECT_TRUE(sap.getPairs().empty());
+}
+
+TEST(SweepAndPruneTest, NearEqualSpreadsDoNotFlipTheAxis) {
+    // A flat, square level: x and z spreads take turns being slightly larger
+    SweepAndPrune sap;
+    std::vector<uint32_t> proxies;
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+            proxies.push_back(sap.createProxy(AABB(Vec3(i * 5.0f, 0, j * 5.0f), Vec3(i * 5.0f + 1, 1, j * 5.0f + 1))));
+        }
+    }
+    sap.update();
+    int axis = sap.getAxis();
+    EXPECT_NE(axis, 1);
+
+    for (int step = 0; step < 10; step++) {
+        float stretchX = step % 2 == 0 ? 1.03f : 0.97f;
+        float stretchZ = 2.0f - stretchX;
+        for (size_t k = 0; k < proxies.size(); k++) {
+            float x = (k / 20) * 5.0f * stretchX;
+            float z = (k % 20) * 5.0f * stretchZ;
+            sap.moveProxy(proxies[k], AABB(Vec3(x, 0, z), Vec3(x + 1, 1, z + 1)));
+        }
+        sap.update();
+        EXPECT_EQ(sap.getAxis(), axis) << "step " << step;
+    }
+
+    // A clearly wider spread still takes over
+    for (size_t k = 0; k < proxies.size(); k++) {
+        float x = (k / 20) * 5.0f;
+        float z = (k % 20) * 5.0f;
+        float y = static_cast<float>(k) * 10.0f;
+        sap.moveProxy(proxies[k], AABB(Vec3(x, y, z), Vec3(x + 1, y + 1, z + 1)));
+    }
+    sap.update();
+    EXPECT_EQ(sap.getAxis(), 1);
+    EXPECT_EQ(sap.getPairs(), BruteForcePairs(sap, proxies));
+}
+
+TEST(SweepAndPruneTest, PairsAndEventsMatchBruteForceWhileMoving) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> size(0.5f, 3.0f);
+
+    SweepAndPrune sap;
+    std::vector<uint32_t> proxies;
+    for (int i = 0; i < 600; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        proxies.push_back(sap.createProxy(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng)))));
+    }
+
+    std::vector<Pair> previous;
+    for (int step = 0; step < 12; step++) {
+        // Mostly small moves, with an occasional large jump that reshuffles the order
+        float speed = step % 4 == 3 ? 20.0f : 0.3f;
+        std::uniform_real_distribution<float> velocity(-speed, speed);
+        for (uint32_t proxy : proxies) {
+            const AABB& box = sap.getBounds(proxy);
+            Vec3 displacement(velocity(rng), velocity(rng), velocity(rng));
+            sap.moveProxy(proxy, AABB(box.min + displacement, box.max + displacement));
+        }
+
+        // Churn a few proxies
+        for (int k = 0; k < 10; k++) {
+            size_t i = rng() % proxies.size();
+            sap.destroyProxy(proxies[i]);
+            Vec3 center(position(rng), position(rng), position(rng));
+            proxies[i] = sap.createProxy(AABB::fromCenterAndExtents(center, Vec3(2, 2, 2)));
+        }
+
+        // Stretch the scene along a different axis now and then
+        if (step == 6) {
+            for (uint32_t proxy : proxies) {
+                const AABB& box = sap.getBounds(proxy);
+                sap.moveProxy(proxy, AABB(Vec3(box.min.x * 0.1f, box.min.y * 4.0f, box.min.z),
+                    Vec3(box.max.x * 0.1f, box.max.y * 4.0f, box.max.z)));
+            }
+        }
+
+        sap.update();
+        EXPECT_EQ(sap.getPairs(), BruteForcePairs(sap, proxies));
+
+        // previous + added - removed == current
+        std::vector<Pair> rebuilt;
+        std::set_difference(previous.begin(), previous.end(),
+            sap.getRemovedPairs().begin(), sap.getRemovedPairs().end(), std::back_inserter(rebuilt));
+        rebuilt.insert(rebuilt.end(), sap.getAddedPairs().begin(), sap.getAddedPairs().end());
+        std::sort(rebuilt.begin(), rebuilt.end());
+        EXPECT_EQ(rebuilt, sap.getPairs());
+        previous = sap.getPairs();
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file TestScenes.hpp
+ * @brief Random scenes and brute-force references shared by the spatial structure tests
+ */
+
+#pragma once
+
+#include "Collision.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Helper: random rays, a quarter of them axis-aligned (both signs, every axis) so zero direction
+// components are covered
+inline std::vector<Ray> RandomRays(size_t count, float halfSize, unsigned seed) {
+    static const Vec3 axes[6] = { Vec3(1, 0, 0), Vec3(0, -1, 0), Vec3(0, 0, 1),
+                                  Vec3(-1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, -1) };
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-halfSize, halfSize);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<Ray> rays;
+    for (size_t i = 0; i < count; i++) {
+        Vec3 origin(position(rng), position(rng), position(rng));
+        if (i % 4 == 3) {
+            rays.emplace_back(origin, axes[(i / 4) % 6]);
+        }
+        else {
+            rays.emplace_back(origin, Vec3(direction(rng), direction(rng), direction(rng)));
+        }
+    }
+    return rays;
+}
+
+// Helper: random boxes centred in a cube of the given half size, with extents in [minExtent, maxExtent]
+inline std::vector<AABB> RandomBoxes(size_t count, float halfSize, unsigned seed,
+                                     float minExtent = 0.2f, float maxExtent = 3.0f) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-halfSize, halfSize);
+    std::uniform_real_distribution<float> size(minExtent, maxExtent);
+    std::vector<AABB> boxes;
+    for (size_t i = 0; i < count; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        boxes.push_back(AABB::fromCenterAndExtents(center, Vec3(size(rng), size(rng), size(rng))));
+    }
+    return boxes;
+}
+
+// Helper: random spheres centred in a cube of the given half size, with radii in [minRadius, maxRadius]
+inline std::vector<Sphere> RandomSpheres(size_t count, float halfSize, unsigned seed,
+                                         float minRadius = 0.2f, float maxRadius = 2.0f) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-halfSize, halfSize);
+    std::uniform_real_distribution<float> radius(minRadius, maxRadius);
+    std::vector<Sphere> spheres;
+    for (size_t i = 0; i < count; i++) {
+        spheres.emplace_back(Vec3(position(rng), position(rng), position(rng)), radius(rng));
+    }
+    return spheres;
+}
+
+inline std::vector<uint32_t> Sorted(std::vector<uint32_t> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+/**
+ * Brute-force closest hit over primitives 0..count-1, where test(i, distance) is the single-primitive
+ * test. Hits beyond maxDistance are ignored, and of equally near hits the lower index wins: the rule
+ * every structure's raycast follows.
+ */
+template<typename Test>
+inline bool ClosestHit(size_t count, float maxDistance, const Test& test, RayHit& hit) {
+    bool found = false;
+    for (uint32_t i = 0; i < count; i++) {
+        float distance;
+        if (test(i, distance) && distance <= maxDistance && (!found || distance < hit.distance)) {
+            hit.index = i;
+            hit.distance = distance;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Helper: the same over a primitive list, where test(ray, primitive, distance) is e.g. rayIntersectsAABB
+template<typename Primitive, typename Test>
+inline bool ClosestHit(const Ray& ray, const std::vector<Primitive>& primitives, const Test& test, RayHit& hit,
+                       float maxDistance = std::numeric_limits<float>::infinity()) {
+    return ClosestHit(primitives.size(), maxDistance, [&](uint32_t i, float& distance) {
+        return test(ray, primitives[i], distance);
+    }, hit);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file TransformFileTests.cpp
+ * @brief Unit tests for TransformFile and TransformSystem::LoadHierarchy
+ */
+
+#include <gtest/gtest.h>
+#include "TransformFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Helper: a small rotated, scaled hierarchy (two roots)
+static TransformSystem BuildScene(std::vector<TransformHandle>& handles) {
+    TransformSystem system;
+    std::vector<uint32_t> parents = { TransformSystem::NoParent, 0, 0, 1, TransformSystem::NoParent, 4 };
+    std::vector<Vec3> positions;
+    std::vector<Quaternion> rotations;
+    std::vector<Vec3> scales;
+    for (size_t i = 0; i < parents.size(); i++) {
+        float f = static_cast<float>(i);
+        positions.emplace_back(f, 1.0f, -f);
+        rotations.push_back(Quaternion::fromAxisAngle(Vec3(0, 1, 1), 0.3f * f));
+        scales.emplace_back(1.0f + 0.1f * f, 1.0f, 1.0f);
+    }
+
+    handles.resize(parents.size());
+    system.CreateBatch(parents.size(), parents.data(), positions.data(), rotations.data(), scales.data(), handles.data());
+    return system;
+}
+
+static std::string TempPath(const char* name) {
+    return ::testing::TempDir() + name;
+}
+
+TEST(TransformFileTest, RoundTripWithWorldMatrices) {
+    std::vector<TransformHandle> handles;
+    TransformSystem original = BuildScene(handles);
+    std::string path = TempPath("roundtrip_world.vmtf");
+    TransformFile::Save(path, original, true);
+
+    TransformFile file(path);
+    ASSERT_TRUE(file.IsOpen());
+    ASSERT_EQ(file.Size(), original.Size());
+    ASSERT_NE(file.GetWorldMatrices(), nullptr);
+
+    TransformSystem loaded;
+    std::vector<TransformHandle> loadedHandles(file.Size());
+    file.LoadInto(loaded, loadedHandles.data());
+
+    // File order is the original dense order
+    for (uint32_t i = 0; i < file.Size(); i++) {
+        TransformHandle source = original.GetHandle(i);
+        EXPECT_EQ(loaded.GetWorldMatrix(loadedHandles[i]), original.GetWorldMatrix(source)) << "index " << i;
+        EXPECT_EQ(loaded.GetPosition(loadedHandles[i]), original.GetPosition(source));
+        EXPECT_EQ(loaded.GetChildren(loadedHandles[i]).size(), original.GetChildren(source).size());
+    }
+
+    // The loaded system is fully functional
+    loaded.SetPosition(loadedHandles[0], Vec3(100, 0, 0));
+    original.SetPosition(original.GetHandle(0), Vec3(100, 0, 0));
+    loaded.UpdateWorldMatrices();
+    original.UpdateWorldMatrices();
+    for (uint32_t i = 0; i < file.Size(); i++) {
+        EXPECT_EQ(loaded.GetWorldMatrices()[i], original.GetWorldMatrices()[i]) << "index " << i;
+    }
+
+    file.Close();
+    std::remove(path.c_str());
+}
+
+TEST(TransformFileTest, RoundTripWithoutWorldMatrices) {
+    std::vector<TransformHandle> handles;
+    TransformSystem original = BuildScene(handles);
+    std::string path = TempPath("roundtrip_local.vmtf");
+    TransformFile::Save(path, original, false);
+
+    TransformFile file(path);
+    EXPECT_EQ(file.GetWorldMatrices(), nullptr);
+
+    TransformSystem loaded;
+    loaded.Create();  // Replaced by the load
+    file.LoadInto(loaded);
+    ASSERT_EQ(loaded.Size(), original.Size());
+
+    loaded.UpdateWorldMatrices();
+    for (uint32_t i = 0; i < loaded.Size(); i++) {
+        EXPECT_EQ(loaded.GetWorldMatrices()[i], original.GetWorldMatrices()[i]) << "index " << i;
+    }
+
+    file.Close();
+    std::remove(path.c_str());
+}
+
+TEST(TransformFileTest, RejectsInvalidFiles) {
+    EXPECT_THROW(TransformFile(TempPath("does_not_exist.vmtf")), std::runtime_error);
+
+    std::string path = TempPath("garbage.vmtf");
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::vector<char> garbage(128, 'x');
+        out.write(garbage.data(), garbage.size());
+    }
+    TransformFile file;
+    EXPECT_THROW(file.Open(path), std::runtime_error);
+    EXPECT_FALSE(file.IsOpen());
+
+    // A valid header whose arrays were cut off
+    std::vector<TransformHandle> handles;
+    TransformSystem system = BuildScene(handles);
+    TransformFile::Save(path, system, true);
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 32);
+    }
+    EXPECT_THROW(file.Open(path), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST(TransformSystemTest, LoadHierarchyAcceptsChildrenBeforeParents) {
+    // Node 0 is a child of node 2, node 1 a child of node 0
+    std::vector<uint32_t> parents = { 2, 0, TransformSystem::NoParent };
+    std::vector<Vec3> positions = { Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1) };
+    std::vector<Quaternion> rotations(3);
+    std::vector<Vec3> scales(3, Vec3(1, 1, 1));
+
+    TransformSystem system;
+    TransformHandle stale = system.Create();
+    std::vector<TransformHandle> handles(3);
+    system.LoadHierarchy(3, parents.data(), positions.data(), rotations.data(), scales.data(), nullptr, handles.data());
+
+    EXPECT_FALSE(system.IsAlive(stale));
+    EXPECT_EQ(system.GetParent(handles[1]), handles[0]);
+    Mat4 world = system.GetWorldMatrix(handles[1]);
+    EXPECT_EQ(Vec3(world.m[12], world.m[13], world.m[14]), Vec3(1, 1, 1));
+
+    system.UpdateWorldMatrices();
+    EXPECT_EQ(system.GetIndex(handles[2]), 0u);
+    EXPECT_EQ(system.GetWorldMatrix(handles[1]), world);
+
+    // New transforms reuse the free slots normally
+    TransformHandle extra = system.Create();
+    EXPECT_TRUE(system.IsAlive(extra));
+    EXPECT_EQ(system.Size(), 4u);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file TransformSnapshotTests.cpp
+ * @brief Unit tests for TransformSnapshotBuffer
+ */
+
+#include <gtest/gtest.h>
+#include "TransformSnapshot.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TransformSnapshotTest, EmptyBeforeFirstPublish) {
+    TransformSnapshotBuffer buffer;
+    TransformSnapshotView view = buffer.Acquire();
+    EXPECT_FALSE(view.IsValid());
+}
+
+TEST(TransformSnapshotTest, PublishCopiesWorldMatrices) {
+    TransformSystem system;
+    TransformHandle root = system.Create(Vec3(1, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    TransformHandle child = system.Create(Vec3(0, 2, 0), Quaternion(), Vec3(1, 1, 1));
+    system.SetParent(child, root);
+
+    TransformSnapshotBuffer buffer;
+    buffer.Publish(system);
+
+    TransformSnapshotView view = buffer.Acquire();
+    ASSERT_TRUE(view.IsValid());
+    EXPECT_EQ(view->GetFrame(), 1u);
+    ASSERT_EQ(view->Size(), 2u);
+
+    Mat4 world;
+    ASSERT_TRUE(view->TryGetWorldMatrix(child, world));
+    EXPECT_EQ(world, system.GetWorldMatrix(child));
+    EXPECT_EQ(world.m[12], 1.0f);
+    EXPECT_EQ(world.m[13], 2.0f);
+
+    // Later mutations do not affect the published snapshot
+    system.SetPosition(root, Vec3(5, 0, 0));
+    system.UpdateWorldMatrices();
+    ASSERT_TRUE(view->TryGetWorldMatrix(child, world));
+    EXPECT_EQ(world.m[12], 1.0f);
+
+    // Destroyed transforms are not found in newer snapshots
+    system.Destroy(child);
+    buffer.Publish(system);
+    TransformSnapshotView next = buffer.Acquire();
+    EXPECT_EQ(next->GetFrame(), 2u);
+    EXPECT_FALSE(next->TryGetWorldMatrix(child, world));
+    ASSERT_TRUE(next->TryGetWorldMatrix(root, world));
+    EXPECT_EQ(world.m[12], 5.0f);
+}
+
+TEST(TransformSnapshotTest, HeldSnapshotIsNeverOverwritten) {
+    TransformSystem system;
+    TransformHandle node = system.Create();
+
+    TransformSnapshotBuffer buffer;
+    system.SetPosition(node, Vec3(1, 0, 0));
+    buffer.Publish(system);
+    TransformSnapshotView held = buffer.Acquire();
+
+    for (int i = 2; i <= 10; i++) {
+        system.SetPosition(node, Vec3(static_cast<float>(i), 0, 0));
+        buffer.Publish(system);
+    }
+
+    EXPECT_EQ(held->GetFrame(), 1u);
+    EXPECT_EQ(held->GetWorldMatrices()[0].m[12], 1.0f);
+    EXPECT_EQ(buffer.Acquire()->GetWorldMatrices()[0].m[12], 10.0f);
+}
+
+TEST(TransformSnapshotTest, ConcurrentReadersSeeConsistentFrames) {
+    const int nodeCount = 64;
+    const int frameCount = 500;
+
+    TransformSystem system;
+    std::vector<TransformHandle> handles;
+    for (int i = 0; i < nodeCount; i++) {
+        handles.push_back(system.Create());
+    }
+
+    TransformSnapshotBuffer buffer;
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+
+    auto reader = [&]() {
+        uint64_t lastFrame = 0;
+        while (!done.load()) {
+            TransformSnapshotView view = buffer.Acquire();
+            if (!view.IsValid()) {
+                continue;
+            }
+            // Every node in a frame carries that frame's number
+            float expected = static_cast<float>(view->GetFrame());
+            for (size_t i = 0; i < view->Size(); i++) {
+                if (view->GetWorldMatrices()[i].m[12] != expected) {
+                    failures++;
+                }
+            }
+            if (view->GetFrame() < lastFrame) {
+                failures++;
+            }
+            lastFrame = view->GetFrame();
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; i++) {
+        readers.emplace_back(reader);
+    }
+
+    for (int frame = 1; frame <= frameCount; frame++) {
+        for (TransformHandle handle : handles) {
+            system.SetPosition(handle, Vec3(static_cast<float>(frame), 0, 0));
+        }
+        buffer.Publish(system);
+    }
+
+    done.store(true);
+    for (std::thread& thread : readers) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(buffer.Acquire()->GetFrame(), static_cast<uint64_t>(frameCount));
+}
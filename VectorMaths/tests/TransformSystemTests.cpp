@@ -0,0 +1,647 @@
+/**
+ * @file TransformSystemTests.cpp
+ * @brief Unit tests for TransformSystem class
+ */
+
+#include <gtest/gtest.h>
+#include "TransformSystem.hpp"
+#include "Transform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Helper: builds matching hierarchies in a TransformSystem and as Transform objects.
+// Node i is parented to parentOf[i] (-1 for roots).
+struct MirroredHierarchy {
+    TransformSystem system;
+    std::vector<TransformHandle> handles;
+    std::vector<std::unique_ptr<Transform>> nodes;
+
+    explicit MirroredHierarchy(const std::vector<int>& parentOf) {
+        for (size_t i = 0; i < parentOf.size(); i++) {
+            float f = static_cast<float>(i);
+            Vec3 position(f, 0.5f * f, -f);
+            Quaternion rotation = Quaternion::fromAxisAngle(Vec3(0, 1, 0), 0.1f * f);
+            Vec3 scale(1.0f, 1.0f + 0.01f * f, 1.0f);
+
+            handles.push_back(system.Create(position, rotation, scale));
+            nodes.emplace_back(std::make_unique<Transform>(position, rotation, scale));
+        }
+        for (size_t i = 0; i < parentOf.size(); i++) {
+            if (parentOf[i] >= 0) {
+                system.SetParent(handles[i], handles[parentOf[i]]);
+                nodes[i]->SetParent(nodes[parentOf[i]].get());
+            }
+        }
+    }
+
+    void ExpectMatches() const {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            EXPECT_EQ(system.GetWorldMatrix(handles[i]), nodes[i]->GetWorldMatrix()) << "node " << i;
+        }
+    }
+};
+
+TEST(TransformSystemTest, CreateDefaultsToIdentity) {
+    TransformSystem system;
+    TransformHandle h = system.Create();
+
+    EXPECT_TRUE(h.IsValid());
+    EXPECT_EQ(system.Size(), 1u);
+    EXPECT_EQ(system.GetWorldMatrix(h), Mat4());
+    EXPECT_FALSE(system.GetParent(h).IsValid());
+    EXPECT_EQ(system.GetScale(h), Vec3(1, 1, 1));
+}
+
+TEST(TransformSystemTest, MatchesTransformHierarchy) {
+    // Parents deliberately created after their children
+    MirroredHierarchy h({ 3, 3, 1, -1, 2, -1, 5, 4 });
+    h.ExpectMatches();
+}
+
+TEST(TransformSystemTest, UpdateSortsParentsBeforeChildren) {
+    MirroredHierarchy h({ 3, 3, 1, -1, 2, -1, 5, 4 });
+    h.system.UpdateWorldMatrices();
+
+    const uint32_t* parents = h.system.GetParentIndices();
+    for (uint32_t i = 0; i < h.system.Size(); i++) {
+        if (parents[i] != TransformSystem::NoParent) {
+            EXPECT_LT(parents[i], i);
+        }
+    }
+
+    // Handles survive the reorder and the flat array matches lazy queries
+    const Mat4* world = h.system.GetWorldMatrices();
+    for (size_t i = 0; i < h.handles.size(); i++) {
+        EXPECT_EQ(h.system.GetHandle(h.system.GetIndex(h.handles[i])), h.handles[i]);
+        EXPECT_EQ(world[h.system.GetIndex(h.handles[i])], h.nodes[i]->GetWorldMatrix());
+    }
+    h.ExpectMatches();
+}
+
+TEST(TransformSystemTest, MutationsPropagateToDescendants) {
+    MirroredHierarchy h({ -1, 0, 1, 2, 1 });
+    h.system.UpdateWorldMatrices();
+
+    h.system.Translate(h.handles[0], Vec3(1, 2, 3));
+    h.nodes[0]->Translate(Vec3(1, 2, 3));
+    h.system.Rotate(h.handles[1], Quaternion::fromAxisAngle(Vec3(1, 0, 0), 0.5f));
+    h.nodes[1]->Rotate(Quaternion::fromAxisAngle(Vec3(1, 0, 0), 0.5f));
+
+    // Lazy query before any bulk update
+    EXPECT_EQ(h.system.GetWorldMatrix(h.handles[3]), h.nodes[3]->GetWorldMatrix());
+
+    h.system.UpdateWorldMatrices();
+    h.ExpectMatches();
+}
+
+TEST(TransformSystemTest, ReparentAndRemoveChild) {
+    MirroredHierarchy h({ -1, -1, 0 });
+    h.system.UpdateWorldMatrices();
+
+    h.system.AddChild(h.handles[1], h.handles[2]);
+    h.nodes[1]->AddChild(h.nodes[2].get());
+    EXPECT_EQ(h.system.GetParent(h.handles[2]), h.handles[1]);
+    h.ExpectMatches();
+
+    h.system.RemoveChild(h.handles[0], h.handles[2]);  // Not the parent, ignored
+    EXPECT_EQ(h.system.GetParent(h.handles[2]), h.handles[1]);
+
+    h.system.RemoveChild(h.handles[1], h.handles[2]);
+    h.nodes[1]->RemoveChild(h.nodes[2].get());
+    EXPECT_FALSE(h.system.GetParent(h.handles[2]).IsValid());
+    h.system.UpdateWorldMatrices();
+    h.ExpectMatches();
+}
+
+TEST(TransformSystemTest, ParallelUpdateIsBitIdenticalToSerial) {
+    const int count = 20000;
+    TransformSystem serial;
+    TransformSystem parallel;
+    std::vector<TransformHandle> serialHandles;
+    std::vector<TransformHandle> parallelHandles;
+
+    for (int i = 0; i < count; i++) {
+        float f = static_cast<float>(i);
+        Vec3 position(std::sin(f), 1.0f, std::cos(f));
+        Quaternion rotation = Quaternion::fromAxisAngle(Vec3(1, 1, 0), 0.01f * f);
+        serialHandles.push_back(serial.Create(position, rotation, Vec3(1, 1, 1)));
+        parallelHandles.push_back(parallel.Create(position, rotation, Vec3(1, 1, 1)));
+        if (i > 0) {
+            // Bushy tree, three children per node
+            serial.SetParent(serialHandles[i], serialHandles[(i - 1) / 3]);
+            parallel.SetParent(parallelHandles[i], parallelHandles[(i - 1) / 3]);
+        }
+    }
+
+    // The parked workers are reused across frames, thread counts and moves of the system
+    const unsigned threadCounts[] = { 4, 2, 6, 4 };
+    for (int frame = 0; frame < 4; frame++) {
+        serial.UpdateWorldMatrices();
+        parallel.UpdateWorldMatricesParallel(threadCounts[frame]);
+        EXPECT_EQ(parallel.GetLastUpdateVisitCount(), static_cast<uint32_t>(count));
+
+        for (int i = 0; i < count; i++) {
+            Mat4 a = serial.GetWorldMatrix(serialHandles[i]);
+            Mat4 b = parallel.GetWorldMatrix(parallelHandles[i]);
+            for (int k = 0; k < 16; k++) {
+                ASSERT_EQ(a.m[k], b.m[k]) << "node " << i << " element " << k;
+            }
+        }
+
+        // Enough movers that the level-by-level pass is used rather than the subtree walk
+        for (int i = frame; i < count; i += 8) {
+            serial.Translate(serialHandles[i], Vec3(0.5f, 0, 0));
+            parallel.Translate(parallelHandles[i], Vec3(0.5f, 0, 0));
+        }
+        if (frame == 1) {
+            TransformSystem moved(std::move(parallel));
+            parallel = std::move(moved);
+        }
+    }
+}
+
+TEST(TransformSystemTest, ParallelUpdateVisitsOnlyDirtySubtrees) {
+    // Bushy tree, four children per node
+    const uint32_t count = 20000;
+    std::vector<uint32_t> parents(count);
+    for (uint32_t i = 0; i < count; i++) {
+        parents[i] = i == 0 ? TransformSystem::NoParent : (i - 1) / 4;
+    }
+    TransformSystem system;
+    std::vector<TransformHandle> handles(count);
+    system.CreateBatch(count, parents.data(), nullptr, nullptr, nullptr, handles.data());
+
+    system.UpdateWorldMatricesParallel(4);
+    EXPECT_EQ(system.GetLastUpdateVisitCount(), count);
+    system.UpdateWorldMatricesParallel(4);
+    EXPECT_EQ(system.GetLastUpdateVisitCount(), 0u);
+
+    // One moved leaf visits only itself
+    system.Translate(handles[count - 1], Vec3(1, 0, 0));
+    system.UpdateWorldMatricesParallel(4);
+    EXPECT_EQ(system.GetLastUpdateVisitCount(), 1u);
+    EXPECT_EQ(system.GetWorldMatrix(handles[count - 1]).m[12], 1.0f);
+
+    // Node 1 has children 5..8, grandchildren 21..36, ...; each level below it is four times wider
+    uint32_t subtree = 0;
+    for (uint32_t first = 1, width = 1; first < count; first = first * 4 + 1, width *= 4) {
+        subtree += std::min(width, count - first);
+    }
+    system.Translate(handles[1], Vec3(0, 2, 0));
+    system.UpdateWorldMatricesParallel(4);
+    EXPECT_EQ(system.GetLastUpdateVisitCount(), subtree);
+    EXPECT_EQ(system.GetWorldMatrix(handles[5]).m[13], 2.0f);
+    EXPECT_EQ(system.GetWorldMatrix(handles[2]).m[13], 0.0f);
+}
+
+TEST(TransformSystemTest, DestroyedSlotsAreReusedWithNewGeneration) {
+    TransformSystem system;
+    TransformHandle a = system.Create();
+    TransformHandle b = system.Create();
+
+    system.Destroy(a);
+    EXPECT_FALSE(system.IsAlive(a));
+    EXPECT_TRUE(system.IsAlive(b));
+    EXPECT_EQ(system.Size(), 1u);
+
+    TransformHandle c = system.Create();
+    EXPECT_EQ(c.id, a.id);
+    EXPECT_NE(c, a);
+    EXPECT_TRUE(system.IsAlive(c));
+    EXPECT_FALSE(system.IsAlive(a));
+}
+
+TEST(TransformSystemTest, IntrusiveChildListsKeepInsertionOrder) {
+    TransformSystem system;
+    TransformHandle root = system.Create();
+    TransformHandle a = system.Create();
+    TransformHandle b = system.Create();
+    TransformHandle c = system.Create();
+    system.AddChild(root, a);
+    system.AddChild(root, b);
+    system.AddChild(root, c);
+
+    std::vector<TransformHandle> children = system.GetChildren(root);
+    ASSERT_EQ(children.size(), 3u);
+    EXPECT_EQ(children[0], a);
+    EXPECT_EQ(children[1], b);
+    EXPECT_EQ(children[2], c);
+
+    system.RemoveChild(root, b);
+    children = system.GetChildren(root);
+    ASSERT_EQ(children.size(), 2u);
+    EXPECT_EQ(children[0], a);
+    EXPECT_EQ(children[1], c);
+    EXPECT_FALSE(system.GetFirstChild(b).IsValid());
+}
+
+TEST(TransformSystemTest, DestroyRemovesWholeSubtree) {
+    TransformSystem system;
+    // 0 -> 1 -> 2, 0 -> 3, separate root 4 -> 5
+    const uint32_t none = TransformSystem::NoParent;
+    std::vector<uint32_t> parentOf = { none, 0, 1, 0, none, 4 };
+    std::vector<Vec3> positions;
+    for (size_t i = 0; i < parentOf.size(); i++) {
+        positions.emplace_back(static_cast<float>(i), 0.0f, 0.0f);
+    }
+    std::vector<TransformHandle> handles(parentOf.size());
+    system.CreateBatch(parentOf.size(), parentOf.data(), positions.data(), nullptr, nullptr, handles.data());
+    system.UpdateWorldMatrices();
+
+    system.Destroy(handles[1]);
+    EXPECT_EQ(system.Size(), 4u);
+    EXPECT_FALSE(system.IsAlive(handles[1]));
+    EXPECT_FALSE(system.IsAlive(handles[2]));
+    ASSERT_EQ(system.GetChildren(handles[0]).size(), 1u);
+    EXPECT_EQ(system.GetChildren(handles[0])[0], handles[3]);
+
+    // Survivors keep their world matrices
+    system.Translate(handles[4], Vec3(0, 1, 0));
+    system.UpdateWorldMatrices();
+    EXPECT_EQ(system.GetWorldMatrix(handles[3]).m[12], 3.0f);
+    EXPECT_EQ(system.GetWorldMatrix(handles[5]).m[12], 9.0f);
+    EXPECT_EQ(system.GetWorldMatrix(handles[5]).m[13], 1.0f);
+}
+
+TEST(TransformSystemTest, CreateBatchAcceptsParentsAfterChildren) {
+    TransformSystem system;
+    const uint32_t none = TransformSystem::NoParent;
+    std::vector<uint32_t> parentOf = { 2, 0, none };
+    std::vector<Vec3> positions = { Vec3(0, 1, 0), Vec3(0, 0, 1), Vec3(1, 0, 0) };
+    std::vector<TransformHandle> handles(3);
+    system.CreateBatch(3, parentOf.data(), positions.data(), nullptr, nullptr, handles.data());
+
+    system.UpdateWorldMatrices();
+    EXPECT_EQ(system.GetParent(handles[0]), handles[2]);
+    EXPECT_EQ(system.GetWorldMatrix(handles[1]).m[12], 1.0f);
+    EXPECT_EQ(system.GetWorldMatrix(handles[1]).m[13], 1.0f);
+    EXPECT_EQ(system.GetWorldMatrix(handles[1]).m[14], 1.0f);
+}
+
+TEST(TransformSystemTest, ClearInvalidatesHandles) {
+    TransformSystem system;
+    std::vector<TransformHandle> handles(100);
+    system.CreateBatch(handles.size(), nullptr, nullptr, nullptr, nullptr, handles.data());
+    system.Clear();
+
+    EXPECT_EQ(system.Size(), 0u);
+    for (const TransformHandle& h : handles) {
+        EXPECT_FALSE(system.IsAlive(h));
+    }
+
+    TransformHandle fresh = system.Create();
+    EXPECT_TRUE(system.IsAlive(fresh));
+    EXPECT_EQ(system.GetWorldMatrix(fresh), Mat4());
+}
+
+TEST(TransformSystemTest, BatchedSettersMatchIndividualSetters) {
+    MirroredHierarchy h({ -1, 0, 0, 1, 1, 2, 5, -1, 7 });
+    h.system.UpdateWorldMatrices();
+
+    std::vector<TransformHandle> targets = { h.handles[6], h.handles[1], h.handles[7] };
+    std::vector<Vec3> newPositions = { Vec3(1, 2, 3), Vec3(-1, 0, 0), Vec3(0, 0, 4) };
+    std::vector<Quaternion> newRotations = {
+        Quaternion::fromAxisAngle(Vec3(0, 0, 1), 0.3f),
+        Quaternion::fromAxisAngle(Vec3(1, 0, 0), 1.2f),
+        Quaternion()
+    };
+    std::vector<int> nodeIndices = { 6, 1, 7 };
+
+    h.system.SetLocalTransforms(targets.data(), newPositions.data(), newRotations.data(), nullptr, targets.size());
+    for (size_t i = 0; i < targets.size(); i++) {
+        h.nodes[nodeIndices[i]]->SetPosition(newPositions[i]);
+        h.nodes[nodeIndices[i]]->SetRotation(newRotations[i]);
+    }
+
+    h.system.SetScales(&h.handles[2], &newPositions[2], 1);
+    h.nodes[2]->SetScale(newPositions[2]);
+
+    h.system.UpdateWorldMatrices();
+    h.ExpectMatches();
+}
+
+TEST(TransformSystemTest, SubtreeUpdateAfterLazyQuery) {
+    // Long chain plus many unrelated roots so only dirty subtrees are visited
+    TransformSystem system;
+    std::vector<TransformHandle> chain;
+    for (int i = 0; i < 5; i++) {
+        chain.push_back(system.Create(Vec3(1, 0, 0), Quaternion(), Vec3(1, 1, 1)));
+        if (i > 0) {
+            system.SetParent(chain[i], chain[i - 1]);
+        }
+    }
+    for (int i = 0; i < 200; i++) {
+        system.Create();
+    }
+    system.UpdateWorldMatrices();
+    EXPECT_EQ(system.GetWorldMatrix(chain[4]).m[12], 5.0f);
+
+    // Move the root and a descendant, and resolve a middle node lazily
+    system.Translate(chain[0], Vec3(10, 0, 0));
+    system.Translate(chain[3], Vec3(0, 1, 0));
+    EXPECT_EQ(system.GetWorldMatrix(chain[2]).m[12], 13.0f);
+
+    system.UpdateWorldMatrices();
+    const Mat4* world = system.GetWorldMatrices();
+    EXPECT_EQ(world[system.GetIndex(chain[4])].m[12], 15.0f);
+    EXPECT_EQ(world[system.GetIndex(chain[4])].m[13], 1.0f);
+    EXPECT_EQ(world[system.GetIndex(chain[1])].m[12], 12.0f);
+}
+
+TEST(TransformSystemTest, ChangeJournalListsChangedTransformsInHierarchyOrder) {
+    TransformSystem system;
+    TransformHandle leaf = system.Create();
+    TransformHandle root = system.Create();
+    TransformHandle child = system.Create();
+    TransformHandle other = system.Create();
+    system.AddChild(child, leaf);
+    system.AddChild(root, child);
+
+    // New transforms are reported once
+    std::vector<TransformHandle> changed;
+    system.UpdateWorldMatrices();
+    system.ConsumeChangedTransforms(changed);
+    EXPECT_EQ(changed.size(), 4u);
+
+    system.UpdateWorldMatrices();
+    system.ConsumeChangedTransforms(changed);
+    EXPECT_TRUE(changed.empty());
+
+    // Moving the root twice reports the subtree once, parents first
+    system.Translate(root, Vec3(1, 0, 0));
+    system.UpdateWorldMatrices();
+    system.Translate(root, Vec3(1, 0, 0));
+    system.UpdateWorldMatrices();
+    system.ConsumeChangedTransforms(changed);
+    ASSERT_EQ(changed.size(), 3u);
+    EXPECT_EQ(changed[0], root);
+    EXPECT_EQ(changed[1], child);
+    EXPECT_EQ(changed[2], leaf);
+
+    // Writing identical values does not count as a change
+    system.SetPosition(other, Vec3());
+    system.UpdateWorldMatrices();
+    system.ConsumeChangedTransforms(changed);
+    EXPECT_TRUE(changed.empty());
+}
+
+TEST(TransformSystemTest, ChangeJournalSkipsDestroyedTransforms) {
+    TransformSystem system;
+    TransformHandle a = system.Create();
+    TransformHandle b = system.Create();
+    std::vector<TransformHandle> changed;
+    system.UpdateWorldMatrices();
+    system.ConsumeChangedTransforms(changed);
+
+    system.SetPosition(a, Vec3(1, 0, 0));
+    system.SetPosition(b, Vec3(2, 0, 0));
+    system.UpdateWorldMatricesParallel(2);
+    system.Destroy(a);
+
+    system.ConsumeChangedTransforms(changed);
+    ASSERT_EQ(changed.size(), 1u);
+    EXPECT_EQ(changed[0], b);
+}
+
+TEST(TransformSystemTest, InterpolatesBetweenSimulationSteps) {
+    TransformSystem system;
+    TransformHandle root = system.Create();
+    TransformHandle child = system.Create(Vec3(0, 1, 0), Quaternion(), Vec3(1, 1, 1));
+    TransformHandle still = system.Create(Vec3(5, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    system.SetParent(child, root);
+
+    // Step: root moves and turns, the unrelated transform stays put
+    system.SavePreviousState();
+    system.SetPosition(root, Vec3(2, 0, 0));
+    system.SetRotation(root, Quaternion::fromAxisAngle(Vec3(0, 0, 1), M_PI / 2));
+
+    std::vector<Mat4> render;
+    system.InterpolateWorldMatrices(0.5f, render);
+    ASSERT_EQ(render.size(), 3u);
+
+    Mat4 expectedRoot = Transform::ComposeMatrix(Vec3(1, 0, 0),
+        Quaternion::nlerp(Quaternion(), system.GetRotation(root), 0.5f), Vec3(1, 1, 1));
+    EXPECT_EQ(render[system.GetIndex(root)], expectedRoot);
+    EXPECT_EQ(render[system.GetIndex(child)], expectedRoot * system.GetLocalMatrix(child));
+    EXPECT_EQ(render[system.GetIndex(still)], system.GetWorldMatrix(still));
+
+    // The end points reproduce the previous and current world matrices
+    system.InterpolateWorldMatrices(0.0f, render);
+    EXPECT_EQ(render[system.GetIndex(child)], system.GetLocalMatrix(child));
+    system.InterpolateWorldMatrices(1.0f, render);
+    EXPECT_EQ(render[system.GetIndex(child)], system.GetWorldMatrix(child));
+
+    // Without further movement the next step renders the current state at any alpha
+    system.SavePreviousState();
+    system.InterpolateWorldMatrices(0.25f, render);
+    for (uint32_t i = 0; i < system.Size(); i++) {
+        EXPECT_EQ(std::memcmp(render[i].m, system.GetWorldMatrices()[i].m, sizeof(Mat4)), 0) << "index " << i;
+    }
+}
+
+TEST(TransformSystemTest, InterpolationSurvivesReorderAndDestroy) {
+    TransformSystem system;
+    TransformHandle leaf = system.Create();
+    TransformHandle doomed = system.Create();
+    TransformHandle root = system.Create();
+    system.SetParent(leaf, root);
+    system.SavePreviousState();
+
+    system.Translate(leaf, Vec3(4, 0, 0));
+    system.Destroy(doomed);
+    system.UpdateWorldMatrices();
+
+    std::vector<Mat4> render;
+    system.InterpolateWorldMatrices(0.25f, render);
+    ASSERT_EQ(render.size(), 2u);
+    Mat4 world = render[system.GetIndex(leaf)];
+    EXPECT_NEAR(world.m[12], 1.0f, 1e-6f);
+}
+
+TEST(TransformSystemTest, BatchBasisMatchesTransform) {
+    MirroredHierarchy h({ -1, 0, 1, 1, -1, 4 });
+    h.system.SetRotation(h.handles[0], Quaternion::fromAxisAngle(Vec3(1, 0, 0), 0.4f));
+    h.nodes[0]->SetRotation(Quaternion::fromAxisAngle(Vec3(1, 0, 0), 0.4f));
+
+    size_t count = h.handles.size();
+    std::vector<Vec3> rights(count), ups(count), forwards(count);
+    h.system.GetWorldBasis(h.handles.data(), count, rights.data(), ups.data(), forwards.data());
+
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(rights[i], h.nodes[i]->Right()) << "node " << i;
+        EXPECT_EQ(ups[i], h.nodes[i]->Up()) << "node " << i;
+        EXPECT_EQ(forwards[i], h.nodes[i]->Forward()) << "node " << i;
+        EXPECT_EQ(h.system.Forward(h.handles[i]), forwards[i]) << "node " << i;
+    }
+
+    // Outputs may be skipped
+    std::vector<Vec3> onlyUps(count);
+    h.system.GetWorldBasis(h.handles.data(), count, nullptr, onlyUps.data(), nullptr);
+    EXPECT_EQ(onlyUps[2], ups[2]);
+}
+
+// Helper: recomputes subtree bounds from scratch by transforming the corners of every box
+static AABB BruteForceSubtreeBounds(TransformSystem& system, TransformHandle handle) {
+    AABB bounds = AABB::empty();
+    AABB local = system.GetLocalBounds(handle);
+    if (!local.isEmpty()) {
+        Mat4 world = system.GetWorldMatrix(handle);
+        for (int corner = 0; corner < 8; corner++) {
+            Vec3 p((corner & 1) ? local.max.x : local.min.x,
+                   (corner & 2) ? local.max.y : local.min.y,
+                   (corner & 4) ? local.max.z : local.min.z);
+            Vec4 q = world * Vec4(p.x, p.y, p.z, 1.0f);
+            bounds.expand(Vec3(q.x, q.y, q.z));
+        }
+    }
+    for (TransformHandle child : system.GetChildren(handle)) {
+        bounds = bounds.merge(BruteForceSubtreeBounds(system, child));
+    }
+    return bounds;
+}
+
+static void ExpectBoundsNear(const AABB& actual, const AABB& expected) {
+    if (expected.isEmpty()) {
+        EXPECT_TRUE(actual.isEmpty());
+        return;
+    }
+    const float tolerance = 1e-4f;
+    EXPECT_NEAR(actual.min.x, expected.min.x, tolerance);
+    EXPECT_NEAR(actual.min.y, expected.min.y, tolerance);
+    EXPECT_NEAR(actual.min.z, expected.min.z, tolerance);
+    EXPECT_NEAR(actual.max.x, expected.max.x, tolerance);
+    EXPECT_NEAR(actual.max.y, expected.max.y, tolerance);
+    EXPECT_NEAR(actual.max.z, expected.max.z, tolerance);
+}
+
+TEST(TransformSystemTest, SubtreeBoundsFollowHierarchyChanges) {
+    MirroredHierarchy h({ -1, 0, 0, 1, 3, -1, 5 });
+    for (size_t i = 0; i < h.handles.size(); i++) {
+        if (i != 1) {  // Node 1 has no geometry of its own
+            h.system.SetLocalBounds(h.handles[i], AABB(Vec3(-1, -0.5f, -0.25f), Vec3(1, 0.5f, 0.25f)));
+        }
+    }
+    EXPECT_TRUE(h.system.GetLocalBounds(h.handles[1]).isEmpty());
+    EXPECT_TRUE(h.system.GetWorldBounds(h.handles[1]).isEmpty());
+
+    auto expectAll = [&]() {
+        for (TransformHandle handle : h.handles) {
+            ExpectBoundsNear(h.system.GetSubtreeBounds(handle), BruteForceSubtreeBounds(h.system, handle));
+        }
+    };
+    expectAll();
+
+    // Moving a deep node refits its ancestors, including shrinking back
+    h.system.SetPosition(h.handles[4], Vec3(50, 0, 0));
+    expectAll();
+    EXPECT_GT(h.system.GetSubtreeBounds(h.handles[0]).max.x, 50.0f);
+    h.system.SetPosition(h.handles[4], Vec3(0, 0, 0));
+    expectAll();
+
+    // Rotating an ancestor moves every descendant
+    h.system.SetRotation(h.handles[0], Quaternion::fromAxisAngle(Vec3(1, 1, 0).normalised(), 0.7f));
+    expectAll();
+
+    // Reparenting and destroying update both old and new parents
+    h.system.SetParent(h.handles[3], h.handles[6]);
+    expectAll();
+    h.system.SetLocalBounds(h.handles[2], AABB(Vec3(-3, -3, -3), Vec3(3, 3, 3)));
+    expectAll();
+    h.system.Destroy(h.handles[2]);
+    for (TransformHandle handle : { h.handles[0], h.handles[5], h.handles[6] }) {
+        ExpectBoundsNear(h.system.GetSubtreeBounds(handle), BruteForceSubtreeBounds(h.system, handle));
+    }
+
+    // A transform flagged for refit, then destroyed and its slot reused before the refit runs
+    h.system.SetLocalBounds(h.handles[4], AABB(Vec3(-9, -9, -9), Vec3(9, 9, 9)));
+    h.system.Destroy(h.handles[4]);
+    TransformHandle reused = h.system.Create(Vec3(0, 20, 0), Quaternion(), Vec3(1, 1, 1));
+    EXPECT_EQ(reused.id, h.handles[4].id);
+    h.system.SetParent(reused, h.handles[3]);
+    h.system.SetLocalBounds(reused, AABB(Vec3(-2, -2, -2), Vec3(2, 2, 2)));
+    for (TransformHandle handle : { h.handles[0], h.handles[3], h.handles[5], h.handles[6], reused }) {
+        ExpectBoundsNear(h.system.GetSubtreeBounds(handle), BruteForceSubtreeBounds(h.system, handle));
+    }
+    EXPECT_GT(h.system.GetSubtreeBounds(h.handles[5]).max.y, 20.0f);
+}
+
+TEST(TransformSystemTest, QueryBoundsCullsWholeSubtrees) {
+    TransformSystem system;
+    AABB unitBox(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f));
+
+    // Two groups of three objects, far apart
+    TransformHandle left = system.Create(Vec3(-100, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    TransformHandle right = system.Create(Vec3(100, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    std::vector<TransformHandle> leftItems;
+    std::vector<TransformHandle> rightItems;
+    for (int i = 0; i < 3; i++) {
+        leftItems.push_back(system.Create(Vec3(0, static_cast<float>(i) * 2.0f, 0), Quaternion(), Vec3(1, 1, 1)));
+        rightItems.push_back(system.Create(Vec3(0, static_cast<float>(i) * 2.0f, 0), Quaternion(), Vec3(1, 1, 1)));
+        system.SetParent(leftItems.back(), left);
+        system.SetParent(rightItems.back(), right);
+        system.SetLocalBounds(leftItems.back(), unitBox);
+        system.SetLocalBounds(rightItems.back(), unitBox);
+    }
+
+    std::vector<TransformHandle> results;
+    system.QueryBounds(AABB(Vec3(90, -1, -1), Vec3(110, 10, 1)), results);
+    EXPECT_EQ(results, rightItems);
+
+    system.QueryBounds(AABB(Vec3(-101, 1.8f, -1), Vec3(-99, 2.2f, 1)), results);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0], leftItems[1]);
+
+    // Moving a group parent moves the whole subtree into the region
+    system.SetPosition(left, Vec3(95, 0, 0));
+    system.QueryBounds(AABB(Vec3(90, -1, -1), Vec3(110, 10, 1)), results);
+    EXPECT_EQ(results.size(), 6u);
+
+    system.QueryBounds(AABB(Vec3(0, 50, 0), Vec3(1, 51, 1)), results);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(TransformSystemTest, QueryFrustumCullsWholeSubtrees) {
+    TransformSystem system;
+    AABB unitBox(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f));
+
+    // Two groups of three objects, on either side of the camera
+    TransformHandle left = system.Create(Vec3(-100, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    TransformHandle right = system.Create(Vec3(100, 0, 0), Quaternion(), Vec3(1, 1, 1));
+    std::vector<TransformHandle> leftItems;
+    std::vector<TransformHandle> rightItems;
+    for (int i = 0; i < 3; i++) {
+        leftItems.push_back(system.Create(Vec3(0, static_cast<float>(i) * 2.0f, 0), Quaternion(), Vec3(1, 1, 1)));
+        rightItems.push_back(system.Create(Vec3(0, static_cast<float>(i) * 2.0f, 0), Quaternion(), Vec3(1, 1, 1)));
+        system.SetParent(leftItems.back(), left);
+        system.SetParent(rightItems.back(), right);
+        system.SetLocalBounds(leftItems.back(), unitBox);
+        system.SetLocalBounds(rightItems.back(), unitBox);
+    }
+
+    // A camera at the origin looking down +x only sees the right group
+    Mat4 view = Mat4().lookAt(Vec3(0, 0, 0), Vec3(1, 0, 0), Vec3(0, 1, 0));
+    Mat4 projection = Mat4().perspective(1.0f, 1.0f, 0.1f, 500.0f);
+    Frustum frustum(projection * view);
+    std::vector<TransformHandle> results;
+    system.QueryFrustum(frustum, results);
+    EXPECT_EQ(results, rightItems);
+
+    // Moving a group parent in front of the camera brings its whole subtree into view
+    system.SetPosition(left, Vec3(95, 0, 0));
+    system.QueryFrustum(frustum, results);
+    EXPECT_EQ(results.size(), 6u);
+
+    // Behind the camera nothing is visible
+    system.SetPosition(left, Vec3(-100, 0, 0));
+    system.SetPosition(right, Vec3(-100, 0, 0));
+    system.QueryFrustum(frustum, results);
+    EXPECT_TRUE(results.empty());
+}
@@ -0,0 +1,283 @@
+/**
+ * @file TransformTests.cpp
+ * @brief Unit tests for Transform class
+ */
+
+#include <gtest/gtest.h>
+#include "Transform.hpp"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Helper: world-space origin of a transform
+static Vec3 WorldOrigin(const Transform& t) {
+    Mat4 world = t.GetWorldMatrix();
+    return Vec3(world.m[12], world.m[13], world.m[14]);
+}
+
+TEST(TransformTest, DefaultIsIdentity) {
+    Transform t;
+    EXPECT_EQ(t.GetLocalMatrix(), Mat4());
+    EXPECT_EQ(t.GetWorldMatrix(), Mat4());
+    EXPECT_EQ(t.GetParent(), nullptr);
+}
+
+TEST(TransformTest, WorldMatrixCombinesParent) {
+    Transform root;
+    Transform child;
+    root.AddChild(&child);
+
+    root.SetPosition(Vec3(10, 0, 0));
+    child.SetPosition(Vec3(5, 0, 0));
+
+    EXPECT_EQ(WorldOrigin(child), Vec3(15, 0, 0));
+    EXPECT_EQ(child.GetWorldMatrix(), root.GetWorldMatrix() * child.GetLocalMatrix());
+}
+
+TEST(TransformTest, CachedWorldMatrixUpdatesAfterAncestorChange) {
+    Transform root;
+    Transform middle;
+    Transform leaf;
+    root.AddChild(&middle);
+    middle.AddChild(&leaf);
+
+    leaf.SetPosition(Vec3(0, 1, 0));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(0, 1, 0));
+
+    // Query again without changes, then move the root
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(0, 1, 0));
+    root.SetPosition(Vec3(2, 0, 0));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(2, 1, 0));
+
+    middle.SetScale(Vec3(2, 2, 2));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(2, 2, 0));
+
+    root.Translate(Vec3(0, 0, 3));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(2, 2, 3));
+}
+
+TEST(TransformTest, SetParentRegistersChild) {
+    Transform root;
+    Transform child;
+    child.SetParent(&root);
+
+    ASSERT_EQ(root.GetChildren().size(), 1u);
+    EXPECT_EQ(root.GetChildren()[0], &child);
+
+    EXPECT_EQ(WorldOrigin(child), Vec3(0, 0, 0));
+    root.SetPosition(Vec3(1, 2, 3));
+    EXPECT_EQ(WorldOrigin(child), Vec3(1, 2, 3));
+}
+
+TEST(TransformTest, ReparentingMovesChildBetweenLists) {
+    Transform a;
+    Transform b;
+    Transform child;
+    a.SetPosition(Vec3(1, 0, 0));
+    b.SetPosition(Vec3(0, 1, 0));
+
+    a.AddChild(&child);
+    EXPECT_EQ(WorldOrigin(child), Vec3(1, 0, 0));
+
+    b.AddChild(&child);
+    EXPECT_TRUE(a.GetChildren().empty());
+    ASSERT_EQ(b.GetChildren().size(), 1u);
+    EXPECT_EQ(WorldOrigin(child), Vec3(0, 1, 0));
+
+    b.RemoveChild(&child);
+    EXPECT_TRUE(b.GetChildren().empty());
+    EXPECT_EQ(child.GetParent(), nullptr);
+    EXPECT_EQ(WorldOrigin(child), Vec3(0, 0, 0));
+}
+
+TEST(TransformTest, RotatedParentRotatesChildOffset) {
+    Transform root;
+    Transform child;
+    root.AddChild(&child);
+
+    child.SetPosition(Vec3(1, 0, 0));
+    root.SetRotation(Quaternion::fromAxisAngle(Vec3(0, 1, 0), M_PI / 2));
+
+    Vec3 expected = root.GetRotation().rotateVector(Vec3(1, 0, 0));
+    EXPECT_EQ(WorldOrigin(child), expected);
+}
+
+TEST(TransformTest, RepeatedMutationsBetweenQueries) {
+    Transform root;
+    Transform child;
+    Transform sibling;
+    root.AddChild(&child);
+    root.AddChild(&sibling);
+    sibling.SetPosition(Vec3(0, 0, 1));
+
+    EXPECT_EQ(WorldOrigin(child), Vec3(0, 0, 0));
+    EXPECT_EQ(WorldOrigin(sibling), Vec3(0, 0, 1));
+
+    for (int i = 0; i < 10; i++) {
+        root.Translate(Vec3(1, 0, 0));
+    }
+    child.Translate(Vec3(0, 1, 0));
+
+    EXPECT_EQ(WorldOrigin(child), Vec3(10, 1, 0));
+    EXPECT_EQ(WorldOrigin(sibling), Vec3(10, 0, 1));
+
+    // Unrelated mutation elsewhere does not disturb cached results
+    Transform unrelated;
+    unrelated.SetPosition(Vec3(5, 5, 5));
+    EXPECT_EQ(WorldOrigin(child), Vec3(10, 1, 0));
+    EXPECT_EQ(WorldOrigin(unrelated), Vec3(5, 5, 5));
+}
+
+TEST(TransformTest, MovedSubtreeFollowsItsNewHierarchy) {
+    Transform a;
+    Transform b;
+    Transform middle;
+    Transform leaf;
+    a.SetPosition(Vec3(1, 0, 0));
+    b.SetPosition(Vec3(0, 1, 0));
+    middle.AddChild(&leaf);
+    leaf.SetPosition(Vec3(0, 0, 1));
+
+    a.AddChild(&middle);
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(1, 0, 1));
+    EXPECT_EQ(WorldOrigin(b), Vec3(0, 1, 0));
+
+    // After the move, changes to the new root reach the whole subtree and the old root is unrelated
+    b.AddChild(&middle);
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(0, 1, 1));
+    b.Translate(Vec3(0, 0, 2));
+    a.Translate(Vec3(5, 0, 0));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(0, 1, 3));
+    middle.Translate(Vec3(3, 0, 0));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(3, 1, 3));
+
+    // Detached, the subtree starts over on its own
+    middle.SetParent(nullptr);
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(3, 0, 1));
+    b.Translate(Vec3(0, 0, 2));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(3, 0, 1));
+
+    // A leaf moved before it gains a child still hands its new matrix down
+    leaf.Translate(Vec3(0, 4, 0));
+    Transform attached;
+    leaf.AddChild(&attached);
+    EXPECT_EQ(WorldOrigin(attached), Vec3(3, 4, 1));
+    EXPECT_EQ(WorldOrigin(leaf), Vec3(3, 4, 1));
+}
+
+TEST(TransformTest, VeryDeepChainDoesNotRecurse) {
+    const int depth = 100000;
+    std::vector<Transform> chain(depth);
+    for (int i = 0; i < depth; i++) {
+        chain[i].SetPosition(Vec3(0, 1, 0));
+        if (i > 0) {
+            chain[i - 1].AddChild(&chain[i]);
+        }
+    }
+
+    EXPECT_EQ(WorldOrigin(chain.back()), Vec3(0, static_cast<float>(depth), 0));
+
+    chain.front().Translate(Vec3(2, 0, 0));
+    EXPECT_EQ(WorldOrigin(chain.back()), Vec3(2, static_cast<float>(depth), 0));
+
+    int visited = 0;
+    chain.front().VisitSubtree([&](Transform& node) {
+        EXPECT_EQ(&node, &chain[visited]);
+        visited++;
+    });
+    EXPECT_EQ(visited, depth);
+}
+
+TEST(TransformTest, VisitSubtreeIsPreOrder) {
+    Transform root;
+    Transform a;
+    Transform b;
+    Transform a1;
+    root.AddChild(&a);
+    root.AddChild(&b);
+    a.AddChild(&a1);
+
+    std::vector<Transform*> order;
+    root.VisitSubtree([&](Transform& node) { order.push_back(&node); });
+
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order[0], &root);
+    EXPECT_EQ(order[1], &a);
+    EXPECT_EQ(order[2], &a1);
+    EXPECT_EQ(order[3], &b);
+}
+
+TEST(TransformTest, SetWorldPositionUnderTransformedParent) {
+    Transform root(Vec3(1, 2, 3), Quaternion::fromAxisAngle(Vec3(0, 1, 0), M_PI / 3), Vec3(2, 2, 2));
+    Transform child;
+    root.AddChild(&child);
+
+    child.SetWorldPosition(Vec3(4, -1, 7));
+    EXPECT_EQ(WorldOrigin(child), Vec3(4, -1, 7));
+
+    // The cached inverse follows later changes to the parent
+    root.Translate(Vec3(0, 5, 0));
+    child.SetWorldPosition(Vec3(4, -1, 7));
+    EXPECT_EQ(WorldOrigin(child), Vec3(4, -1, 7));
+    EXPECT_EQ(child.GetInverseWorldMatrix() * child.GetWorldMatrix(), Mat4());
+}
+
+TEST(TransformTest, SetWorldRotationUnderRotatedParent) {
+    Transform root;
+    Transform child;
+    root.AddChild(&child);
+    root.SetRotation(Quaternion::fromAxisAngle(Vec3(1, 1, 0), 0.7f));
+    root.SetScale(Vec3(3, 3, 3));
+
+    Quaternion target = Quaternion::fromAxisAngle(Vec3(0.2f, -1, 0.5f), 1.3f);
+    child.SetWorldRotation(target);
+
+    // World basis matches the target rotation (up to the parent's uniform scale)
+    Mat4 world = child.GetWorldMatrix();
+    Mat4 expected = target.toRotationMatrix();
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            EXPECT_NEAR(world.m[column * 4 + row] / 3.0f, expected.m[column * 4 + row], 1e-5f);
+        }
+    }
+}
+
+TEST(TransformTest, InverseTransformPointAndDirection) {
+    Transform root(Vec3(10, 0, 0), Quaternion::fromAxisAngle(Vec3(0, 0, 1), M_PI / 2), Vec3(1, 1, 1));
+    Transform child(Vec3(0, 2, 0), Quaternion(), Vec3(2, 2, 2));
+    root.AddChild(&child);
+
+    Vec3 localPoint(1, 2, 3);
+    Vec4 worldPoint = child.GetWorldMatrix() * Vec4(localPoint.x, localPoint.y, localPoint.z, 1.0f);
+    EXPECT_EQ(child.InverseTransformPoint(Vec3(worldPoint.x, worldPoint.y, worldPoint.z)), localPoint);
+
+    // Directions ignore translation
+    Vec4 worldDirection = child.GetWorldMatrix() * Vec4(1, 0, 0, 0);
+    EXPECT_EQ(child.InverseTransformDirection(Vec3(worldDirection.x, worldDirection.y, worldDirection.z)), Vec3(1, 0, 0));
+}
+
+TEST(TransformTest, BasisVectorsAreWorldSpace) {
+    Transform root;
+    Transform child;
+    root.AddChild(&child);
+    root.SetRotation(Quaternion::fromAxisAngle(Vec3(0, 1, 0), M_PI / 2));
+    child.SetScale(Vec3(2, 3, 4));
+
+    // The child's own rotation is identity, so its directions come from the parent
+    Quaternion world = root.GetRotation();
+    EXPECT_EQ(child.Forward(), world.rotateVector(Vec3(0, 0, -1)));
+    EXPECT_EQ(child.Right(), world.rotateVector(Vec3(1, 0, 0)));
+    EXPECT_EQ(child.Up(), world.rotateVector(Vec3(0, 1, 0)));
+
+    Vec3 right, up, forward;
+    child.GetWorldBasis(right, up, forward);
+    EXPECT_EQ(right, child.Right());
+    EXPECT_EQ(up, child.Up());
+    EXPECT_EQ(forward, child.Forward());
+
+    // Cached directions follow later changes to the parent
+    root.SetRotation(Quaternion());
+    EXPECT_EQ(child.Forward(), Vec3(0, 0, -1));
+}
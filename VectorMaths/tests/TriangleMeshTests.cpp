@@ -0,0 +1,222 @@
+/**
+ * @file TriangleMeshTests.cpp
+ * @brief Unit tests for the TriangleMesh class, checked against brute-force loops
+ */
+
+#include <gtest/gtest.h>
+#include "TriangleMesh.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Helper: gently bumpy height field of size x size quads, two triangles each, over [0, size]^2
+static void HeightField(int size, unsigned seed, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+    std::uniform_real_distribution<float> height(-0.2f, 0.2f);
+
+    vertices.clear();
+    indices.clear();
+    for (int y = 0; y <= size; y++) {
+        for (int x = 0; x <= size; x++) {
+            bool border = x == 0 || y == 0 || x == size || y == size;
+            float dx = border ? 0.0f : jitter(rng);
+            float dy = border ? 0.0f : jitter(rng);
+            vertices.emplace_back(x + dx, y + dy, height(rng));
+        }
+    }
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            uint32_t corner = static_cast<uint32_t>(y * (size + 1) + x);
+            uint32_t quad[4] = { corner, corner + 1, corner + size + 2, corner + size + 1 };
+            indices.insert(indices.end(), { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] });
+        }
+    }
+}
+
+// Helper: random triangles scattered through a 100-unit cube
+static void TriangleSoup(size_t count, unsigned seed, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+
+    vertices.clear();
+    indices.clear();
+    for (size_t i = 0; i < count; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        for (int corner = 0; corner < 3; corner++) {
+            indices.push_back(static_cast<uint32_t>(vertices.size()));
+            vertices.push_back(center + Vec3(offset(rng), offset(rng), offset(rng)));
+        }
+    }
+}
+
+// Helper: closest hit over every triangle, equal distances going to the lower index
+static bool BruteForce(const Ray& ray, const std::vector<Vec3>& vertices, const std::vector<uint32_t>& indices,
+                       TriangleHit& hit) {
+    bool found = false;
+    for (uint32_t i = 0; i < indices.size() / 3; i++) {
+        float distance, u, v;
+        if (rayIntersectsTriangle(ray, vertices[indices[3 * i]], vertices[indices[3 * i + 1]],
+                                  vertices[indices[3 * i + 2]], distance, u, v) &&
+            (!found || distance < hit.distance)) {
+            hit.index = i;
+            hit.distance = distance;
+            hit.u = u;
+            hit.v = v;
+            found = true;
+        }
+    }
+    return found;
+}
+
+TEST(TriangleMeshTest, EmptyMesh) {
+    TriangleMesh mesh;
+    TriangleHit hit;
+    EXPECT_EQ(mesh.getTriangleCount(), 0u);
+    EXPECT_EQ(mesh.getNodeCount(), 0u);
+    EXPECT_TRUE(mesh.getBounds().isEmpty());
+    EXPECT_FALSE(mesh.raycast(Ray(Vec3(0, 0, 0), Vec3(1, 0, 0)), hit));
+    EXPECT_FALSE(mesh.raycastAny(Ray(Vec3(0, 0, 0), Vec3(1, 0, 0))));
+}
+
+TEST(TriangleMeshTest, RaysThroughSharedEdgesAndVerticesNeverMiss) {
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;
+    HeightField(16, 71, vertices, indices);
+    TriangleMesh mesh;
+    mesh.build(vertices.data(), vertices.size(), indices.data(), indices.size());
+    EXPECT_EQ(mesh.getTriangleCount(), indices.size() / 3);
+
+    // Aim at interior vertices and points on interior edges from above and below. The rays are
+    // steeper than any slope of the field, so each one's line crosses the surface exactly once.
+    std::mt19937 rng(72);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> spread(-3.0f, 3.0f);
+    int rays = 0;
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        for (int edge = 0; edge < 3; edge++) {
+            const Vec3& a = vertices[indices[t + edge]];
+            const Vec3& b = vertices[indices[t + (edge + 1) % 3]];
+            if (a.x <= 0.0f || a.y <= 0.0f || a.x >= 16.0f || a.y >= 16.0f ||
+                b.x <= 0.0f || b.y <= 0.0f || b.x >= 16.0f || b.y >= 16.0f) {
+                continue;
+            }
+
+            Vec3 target = edge == 0 ? a : a + (b - a) * unit(rng);
+            Vec3 origin = target + Vec3(spread(rng), spread(rng), unit(rng) < 0.5f ? 10.0f : -10.0f);
+            Ray ray(origin, target - origin);
+            rays++;
+
+            TriangleHit hit;
+            ASSERT_TRUE(mesh.raycast(ray, hit)) << "ray " << rays << " slipped through the mesh";
+            TriangleHit expected;
+            ASSERT_TRUE(BruteForce(ray, vertices, indices, expected));
+            EXPECT_EQ(hit.index, expected.index);
+            EXPECT_EQ(hit.distance, expected.distance);
+        }
+    }
+    EXPECT_GT(rays, 1000);
+
+    // Straight down through a vertex shared by six triangles and along a shared diagonal
+    std::vector<Vec3> flat;
+    HeightField(2, 73, flat, indices);
+    for (Vec3& vertex : flat) {
+        vertex = Vec3(std::round(vertex.x), std::round(vertex.y), 0.0f);
+    }
+    mesh.build(flat.data(), flat.size(), indices.data(), indices.size());
+    TriangleHit hit;
+    ASSERT_TRUE(mesh.raycast(Ray(Vec3(1, 1, 5), Vec3(0, 0, -1)), hit));
+    EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+    ASSERT_TRUE(mesh.raycast(Ray(Vec3(0.5f, 0.5f, -5), Vec3(0, 0, 1)), hit));
+    EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+}
+
+TEST(TriangleMeshTest, RaycastMatchesBruteForce) {
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;
+    TriangleSoup(2000, 74, vertices, indices);
+    TriangleMesh mesh;
+    mesh.build(vertices.data(), vertices.size(), indices.data(), indices.size());
+    EXPECT_LT(mesh.getNodeCount(), 2 * mesh.getTriangleCount());
+
+    std::mt19937 rng(75);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    int hits = 0;
+    for (int r = 0; r < 500; r++) {
+        Ray ray(Vec3(position(rng), position(rng), position(rng)), Vec3(direction(rng), direction(rng), direction(rng)));
+        TriangleHit expected;
+        bool expectedFound = BruteForce(ray, vertices, indices, expected);
+
+        TriangleHit hit;
+        bool found = mesh.raycast(ray, hit);
+        ASSERT_EQ(found, expectedFound);
+        EXPECT_EQ(mesh.raycastAny(ray), found);
+        if (!found) {
+            continue;
+        }
+        hits++;
+        EXPECT_EQ(hit.index, expected.index);
+        EXPECT_EQ(hit.distance, expected.distance);
+        EXPECT_EQ(hit.u, expected.u);
+        EXPECT_EQ(hit.v, expected.v);
+
+        // The barycentric coordinates reconstruct the hit point
+        const Vec3& a = vertices[indices[3 * hit.index]];
+        const Vec3& b = vertices[indices[3 * hit.index + 1]];
+        const Vec3& c = vertices[indices[3 * hit.index + 2]];
+        Vec3 point = a * (1.0f - hit.u - hit.v) + b * hit.u + c * hit.v;
+        Vec3 along = ray.getPoint(hit.distance);
+        EXPECT_NEAR(point.x, along.x, 1e-3f);
+        EXPECT_NEAR(point.y, along.y, 1e-3f);
+        EXPECT_NEAR(point.z, along.z, 1e-3f);
+
+        // Limiting the distance to just short of the hit finds nothing closer
+        TriangleHit limited;
+        if (mesh.raycast(ray, limited, hit.distance * 0.999f)) {
+            EXPECT_LT(limited.distance, hit.distance);
+        }
+    }
+    EXPECT_GT(hits, 50);
+}
+
+TEST(TriangleMeshTest, PacketsMatchSingleRays) {
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;
+    HeightField(32, 76, vertices, indices);
+    TriangleMesh mesh;
+    mesh.build(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> position(-8.0f, 40.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<Ray> rays;
+    for (int r = 0; r < 401; r++) {
+        rays.emplace_back(Vec3(position(rng), position(rng), 6.0f),
+                          Vec3(direction(rng), direction(rng), -0.5f - std::abs(direction(rng))));
+    }
+
+    for (size_t r = 0; r < rays.size(); r += RayPacket::Width) {
+        size_t count = std::min<size_t>(RayPacket::Width, rays.size() - r);
+        RayPacket packet(&rays[r], count);
+        TriangleHit hits[RayPacket::Width];
+        uint32_t mask = mesh.raycast(packet, hits);
+        uint32_t anyMask = mesh.raycastAny(packet, 8.0f);
+
+        for (uint32_t lane = 0; lane < count; lane++) {
+            TriangleHit expected;
+            bool found = mesh.raycast(rays[r + lane], expected);
+            ASSERT_EQ(((mask >> lane) & 1u) != 0, found);
+            EXPECT_EQ(((anyMask >> lane) & 1u) != 0, mesh.raycastAny(rays[r + lane], 8.0f));
+            if (found) {
+                EXPECT_EQ(hits[lane].index, expected.index);
+                EXPECT_EQ(hits[lane].distance, expected.distance);
+                EXPECT_EQ(hits[lane].u, expected.u);
+                EXPECT_EQ(hits[lane].v, expected.v);
+            }
+        }
+        EXPECT_EQ(mask >> count, 0u);
+    }
+}